@@ -4,7 +4,8 @@
  * This program demonstrates how to move a sprite across the screen using SFML.
  * The sprite starts at the top-left corner and moves left to right across the window,
  * resetting its position when it reaches the right edge of the screen. Movement
- * is smooth and frame-rate independent, achieved using deltaTime.
+ * is smooth and frame-rate independent: the frame time is accumulated and the
+ * sprite moves in fixed 60 Hz steps, drawn between its last two step positions.
  *
  * Resources Used:
  * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
@@ -32,11 +33,18 @@ int main() {
   sf::Sprite sprite(texture);
 
   // Set initial position of the sprite
-  sprite.setPosition(0.0f, 25.0f); // Start near the top left corner
+  sf::Vector2f position(0.0f, 25.0f); // Start near the top left corner
+  sf::Vector2f previousPosition = position; // Position before the last step, for interpolation
+  sprite.setPosition(position);
 
   // Movement speed (pixels per second)
   const float speed = 200.0f;
 
+  // Fixed simulation step and the most catch-up steps a slow frame may run
+  const float step = 1.0f / 60.0f;
+  const int maxSteps = 5;
+  float accumulator = 0.0f; // Frame time not yet simulated
+
   // Clock to track deltaTime
   sf::Clock clock;
 
@@ -48,17 +56,29 @@ int main() {
         window.close();
     }
 
-    // Calculate deltaTime (time elapsed since the last frame)
+    // Calculate deltaTime (time elapsed since the last frame) and add it to the accumulator
     float deltaTime = clock.restart().asSeconds();
+    accumulator += deltaTime;
 
-    // Update the sprite position
-    sprite.move(speed * deltaTime, 0.0f); // Speed is scaled by deltaTime
+    // Run the fixed steps due this frame; time beyond the catch-up limit is dropped
+    int steps = static_cast<int>(accumulator / step);
+    accumulator -= steps * step;
+    if (steps > maxSteps) steps = maxSteps;
+    for (int i = 0; i < steps; i++) {
+      previousPosition = position;
+      position.x += speed * step; // Speed is scaled by the step
 
-    // Reset position if sprite moves out of bounds
-    if (sprite.getPosition().x > 640) {
-      sprite.setPosition(0.f, sprite.getPosition().y);
+      // Reset position if sprite moves out of bounds
+      if (position.x > 640) {
+        position.x = 0.f;
+        previousPosition = position; // Jump back without sliding across the screen
+      }
     }
 
+    // Draw the sprite between its last two step positions
+    float alpha = accumulator / step;
+    sprite.setPosition(previousPosition + (position - previousPosition) * alpha);
+
     // Clear the screen
     window.clear(sf::Color::White);
 
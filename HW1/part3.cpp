@@ -21,6 +21,10 @@ constexpr float SCREEN_WIDTH = 640.0f; // Width of the window
 constexpr float SCREEN_HEIGHT = 480.0f; // Height of the window
 constexpr float OFFSET = 20.0f; // Offset from edges to keep sprites fully visible
 
+// Fixed simulation step and the most catch-up steps a slow frame may run
+constexpr float STEP = 1.0f / 60.0f; // 60 Hz simulation
+constexpr int MAX_STEPS = 5; // Catch-up limit per frame
+
 // Speeds
 constexpr float BASE_SPEED = 200.0f; // Base speed for horizontal movement
 constexpr float VERTICAL_SPEED = BASE_SPEED * (SCREEN_HEIGHT / SCREEN_WIDTH); // Adjusted speed for vertical movement
@@ -36,6 +40,7 @@ struct SpriteInfo {
   sf::Sprite sprite;
   sf::Vector2f direction; // Movement direction (x, y)
   float speed; // Speed in pixels per second
+  sf::Vector2f previousPosition; // Position before the last step, for interpolation
   bool active = true; // Indicates if the sprite is still in motion
 };
 
@@ -44,6 +49,7 @@ void addSprite(std::vector<SpriteInfo>& sprites, const sf::Texture& texture, sf:
   SpriteInfo newSprite;
   newSprite.sprite.setTexture(texture);
   newSprite.sprite.setPosition(OFFSET, OFFSET); // Start near the top-left corner
+  newSprite.previousPosition = newSprite.sprite.getPosition();
   newSprite.direction = startDirection;
   newSprite.speed = speed;
   sprites.push_back(newSprite);
@@ -67,6 +73,7 @@ int main() {
   addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED);
 
   sf::Clock clock;
+  float accumulator = 0.0f; // Frame time not yet simulated
 
   // Game loop
   while (window.isOpen()) {
@@ -77,59 +84,71 @@ int main() {
         window.close();
     }
 
-    // Calculate deltaTime
+    // Calculate deltaTime and add it to the accumulator
     float deltaTime = clock.restart().asSeconds();
-
-    // Update sprites
-    for (size_t i = 0; i < sprites.size(); ++i) {
-      SpriteInfo& info = sprites[i];
-
-      if (!info.active) continue;
-
-      // Move the sprite based on its direction and speed
-      info.sprite.move(info.direction * info.speed * deltaTime);
-
-      // Handle edge logic
-      float rightEdge = SCREEN_WIDTH - texture.getSize().x - OFFSET;
-      float bottomEdge = SCREEN_HEIGHT - texture.getSize().y - OFFSET;
-
-      if (info.direction.x > 0 && info.sprite.getPosition().x > rightEdge) { // Right edge
-        info.direction = sf::Vector2f(0.0f, 1.0f); // Move down
-        info.sprite.setRotation(ROTATE_RIGHT);
-        info.speed = VERTICAL_SPEED; // Adjust speed for vertical movement
-        if (sprites.size() == 1) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add second sprite
-      } else if (info.direction.y > 0 && info.sprite.getPosition().y > bottomEdge) { // Bottom edge
-        info.direction = sf::Vector2f(-1.0f, 0.0f); // Move left
-        info.sprite.setRotation(ROTATE_DOWN);
-        info.speed = BASE_SPEED; // Adjust speed for horizontal movement
-        if (sprites.size() == 2) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add third sprite
-      } else if (info.direction.x < 0 && info.sprite.getPosition().x < OFFSET) { // Left edge
-        info.direction = sf::Vector2f(0.0f, -1.0f); // Move up
-        info.sprite.setRotation(ROTATE_LEFT);
-        info.speed = VERTICAL_SPEED; // Adjust speed for vertical movement
-        if (sprites.size() == 3) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add fourth sprite
-      } else if (info.direction.y < 0 && info.sprite.getPosition().y < OFFSET) { // Top edge
-        info.direction = sf::Vector2f(1.0f, 0.0f); // Move right
-        info.sprite.setRotation(ROTATE_UP);
-        info.speed = BASE_SPEED; // Reset speed for horizontal movement
-
-        // Remove the sprite if it returns to the starting position
-        info.active = false;
+    accumulator += deltaTime;
+
+    // Run the fixed steps due this frame; time beyond the catch-up limit is dropped
+    int steps = static_cast<int>(accumulator / STEP);
+    accumulator -= steps * STEP;
+    if (steps > MAX_STEPS) steps = MAX_STEPS;
+    for (int step = 0; step < steps; step++) {
+      // Update sprites
+      for (size_t i = 0; i < sprites.size(); ++i) {
+        SpriteInfo& info = sprites[i];
+
+        if (!info.active) continue;
+
+        // Move the sprite based on its direction and speed
+        info.previousPosition = info.sprite.getPosition();
+        info.sprite.move(info.direction * info.speed * STEP);
+
+        // Handle edge logic
+        float rightEdge = SCREEN_WIDTH - texture.getSize().x - OFFSET;
+        float bottomEdge = SCREEN_HEIGHT - texture.getSize().y - OFFSET;
+
+        if (info.direction.x > 0 && info.sprite.getPosition().x > rightEdge) { // Right edge
+          info.direction = sf::Vector2f(0.0f, 1.0f); // Move down
+          info.sprite.setRotation(ROTATE_RIGHT);
+          info.speed = VERTICAL_SPEED; // Adjust speed for vertical movement
+          if (sprites.size() == 1) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add second sprite
+        } else if (info.direction.y > 0 && info.sprite.getPosition().y > bottomEdge) { // Bottom edge
+          info.direction = sf::Vector2f(-1.0f, 0.0f); // Move left
+          info.sprite.setRotation(ROTATE_DOWN);
+          info.speed = BASE_SPEED; // Adjust speed for horizontal movement
+          if (sprites.size() == 2) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add third sprite
+        } else if (info.direction.x < 0 && info.sprite.getPosition().x < OFFSET) { // Left edge
+          info.direction = sf::Vector2f(0.0f, -1.0f); // Move up
+          info.sprite.setRotation(ROTATE_LEFT);
+          info.speed = VERTICAL_SPEED; // Adjust speed for vertical movement
+          if (sprites.size() == 3) addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Add fourth sprite
+        } else if (info.direction.y < 0 && info.sprite.getPosition().y < OFFSET) { // Top edge
+          info.direction = sf::Vector2f(1.0f, 0.0f); // Move right
+          info.sprite.setRotation(ROTATE_UP);
+          info.speed = BASE_SPEED; // Reset speed for horizontal movement
+
+          // Remove the sprite if it returns to the starting position
+          info.active = false;
+        }
       }
-    }
 
-    // Remove inactive sprites and reset if all are inactive
-    if (std::all_of(sprites.begin(), sprites.end(), [](const SpriteInfo& info) { return !info.active; })) {
-      sprites.clear();
-      addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Restart with the first sprite
+      // Remove inactive sprites and reset if all are inactive
+      if (std::all_of(sprites.begin(), sprites.end(), [](const SpriteInfo& info) { return !info.active; })) {
+        sprites.clear();
+        addSprite(sprites, texture, sf::Vector2f(1.0f, 0.0f), BASE_SPEED); // Restart with the first sprite
+      }
     }
 
     // Clear the window
     window.clear(sf::Color::White);
 
-    // Draw all active sprites
+    // Draw all active sprites between their last two step positions
+    float alpha = accumulator / STEP;
     for (const auto& info : sprites) {
-      if (info.active) window.draw(info.sprite);
+      if (!info.active) continue;
+      sf::Sprite drawn = info.sprite;
+      drawn.setPosition(info.previousPosition + (info.sprite.getPosition() - info.previousPosition) * alpha);
+      window.draw(drawn);
     }
 
     // Display the updated frame
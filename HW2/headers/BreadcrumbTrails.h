@@ -0,0 +1,93 @@
+/**
+ * @file BreadcrumbTrails.h
+ * @brief Defines the BreadcrumbTrails class, fixed-size breadcrumb trails for one or many agents.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - File: Provided Breadcrumb class from TA Derek Martin
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef BREADCRUMBTRAILS_H
+#define BREADCRUMBTRAILS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "SpriteBatch.h"
+
+/**
+ * @class BreadcrumbTrails
+ * @brief Stores the last few breadcrumb positions of each agent in ring buffers.
+ *
+ * All trails share two flat float arrays (x and y), capacity slots per trail, allocated once
+ * in the constructor. Dropping a crumb writes one slot and, once a trail is full, overwrites
+ * its oldest crumb, so trail upkeep is O(1) and never allocates. Crumbs are only positions;
+ * their look is chosen when the trails are added to a SpriteBatch.
+ */
+class BreadcrumbTrails {
+public:
+    /**
+     * @brief Constructor to allocate empty trails.
+     * @param trailCount Number of trails (usually one per agent).
+     * @param capacity Maximum crumbs kept per trail.
+     */
+    BreadcrumbTrails(size_t trailCount, size_t capacity);
+
+    /**
+     * @brief Drops a crumb on a trail, replacing the oldest one if the trail is full.
+     * @param trail Trail index.
+     * @param position Position of the crumb.
+     */
+    void push(size_t trail, sf::Vector2f position);
+
+    /**
+     * @brief Removes all crumbs of a trail.
+     * @param trail Trail index.
+     */
+    void clear(size_t trail) { count[trail] = 0; }
+
+    /**
+     * @brief Gets the number of crumbs on a trail.
+     * @param trail Trail index.
+     */
+    size_t size(size_t trail) const { return count[trail]; }
+
+    /**
+     * @brief Gets a crumb of a trail.
+     * @param trail Trail index.
+     * @param index Crumb index, 0 being the oldest.
+     */
+    sf::Vector2f get(size_t trail, size_t index) const;
+
+    /**
+     * @brief Adds the crumbs of one trail to a batch as dots.
+     * @param trail Trail index.
+     * @param batch Batch collecting this frame's dots.
+     * @param radius Dot radius.
+     * @param color Dot color.
+     */
+    void draw(size_t trail, SpriteBatch& batch, float radius, sf::Color color) const;
+
+    /**
+     * @brief Adds the crumbs of every trail to a batch as dots.
+     * @param batch Batch collecting this frame's dots.
+     * @param radius Dot radius.
+     * @param color Dot color.
+     */
+    void draw(SpriteBatch& batch, float radius, sf::Color color) const;
+
+    /**
+     * @brief Gets the number of trails.
+     */
+    size_t getTrailCount() const { return count.size(); }
+
+private:
+    size_t capacity; // Slots per trail
+    std::vector<float> positionX, positionY; // Crumb positions, capacity slots per trail
+    std::vector<size_t> oldest; // Slot of each trail's oldest crumb
+    std::vector<size_t> count; // Crumbs on each trail
+};
+
+#endif // BREADCRUMBTRAILS_H
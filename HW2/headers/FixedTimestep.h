@@ -0,0 +1,110 @@
+/**
+ * @file FixedTimestep.h
+ * @brief Defines the FixedTimestep class, which turns variable frame times into fixed simulation steps.
+ *
+ * Resources Used:
+ * - Glenn Fiedler, "Fix Your Timestep!": https://gafferongames.com/post/fix_your_timestep/
+ * - Book: "Game Programming Patterns" by Robert Nystrom, Game Loop chapter
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+#include <SFML/System.hpp>
+
+/**
+ * @class FixedTimestep
+ * @brief Accumulates frame time and hands it out as whole simulation steps of a fixed size.
+ *
+ * Every frame, the main loop passes the measured frame time to advance and runs the returned
+ * number of steps, each with getStep() as the delta time. The time left over (less than one
+ * step) stays in the accumulator, and getAlpha() says how far rendering is between the last two
+ * simulation states. Agents keep their previous state and draw at that blend, so motion stays
+ * smooth when the render rate and the simulation rate differ.
+ *
+ * A slow frame can only trigger a limited number of catch-up steps; any time beyond that is
+ * dropped, so the simulation slows down instead of falling further and further behind.
+ *
+ * In uncapped mode the frame time is ignored and every call runs exactly one step, so a
+ * headless loop runs as many steps per second as the machine allows.
+ */
+class FixedTimestep {
+public:
+    /**
+     * @brief Constructor to set the step size and catch-up limit.
+     * @param step Simulation step in seconds.
+     * @param maxSteps Most steps a single frame can run.
+     */
+    explicit FixedTimestep(float step = DEFAULT_STEP, int maxSteps = DEFAULT_MAX_STEPS);
+
+    /**
+     * @brief Adds a frame's time to the accumulator.
+     * @param frameTime Measured time since the last frame, in seconds.
+     * @return Number of simulation steps to run this frame.
+     */
+    int advance(float frameTime);
+
+    /**
+     * @brief Gets the fixed step in seconds; pass it as the delta time of every step.
+     */
+    float getStep() const { return step; }
+
+    /**
+     * @brief Gets how far rendering is between the previous and current simulation state.
+     * @return Blend factor in [0, 1); always 1 in uncapped mode, where the latest state is drawn.
+     */
+    float getAlpha() const { return uncapped ? 1.0f : accumulator / step; }
+
+    /**
+     * @brief Turns uncapped mode on or off.
+     * @param enabled True to run one step per advance call regardless of the frame time.
+     */
+    void setUncapped(bool enabled);
+
+    /**
+     * @brief Checks whether uncapped mode is on.
+     */
+    bool isUncapped() const { return uncapped; }
+
+    /**
+     * @brief Gets the total number of steps handed out so far.
+     */
+    long long getStepCount() const { return stepCount; }
+
+    /**
+     * @brief Gets the number of steps dropped because a frame hit the catch-up limit.
+     */
+    long long getDroppedStepCount() const { return droppedStepCount; }
+
+    /**
+     * @brief Blends two positions.
+     * @param from Previous position.
+     * @param to Current position.
+     * @param alpha Blend factor from getAlpha().
+     */
+    static sf::Vector2f lerp(sf::Vector2f from, sf::Vector2f to, float alpha);
+
+    /**
+     * @brief Blends two angles in degrees the short way around.
+     * @param from Previous angle.
+     * @param to Current angle.
+     * @param alpha Blend factor from getAlpha().
+     */
+    static float lerpAngle(float from, float to, float alpha);
+
+    static constexpr float DEFAULT_STEP = 1.0f / 60.0f; // 60 Hz simulation
+    static constexpr int DEFAULT_MAX_STEPS = 5; // Catch-up limit per frame
+
+private:
+    float step; // Simulation step in seconds
+    int maxSteps; // Most steps per frame
+    float accumulator; // Frame time not yet simulated
+    bool uncapped; // One step per call, ignoring frame time
+    long long stepCount; // Steps handed out
+    long long droppedStepCount; // Steps dropped by the catch-up limit
+};
+
+#endif // FIXEDTIMESTEP_H
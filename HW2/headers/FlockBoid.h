@@ -17,6 +17,8 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <cmath>
+#include "NeighborGrid.h"
+#include "SpriteBatch.h"
 
 /** OpenAI's ChatGPT was used to suggest a template header file for FlockBoid's
  * implementation. The following prompt was used: "Create a template header file 
@@ -45,11 +47,32 @@ public:
      */
     void update(float deltaTime, const std::vector<FlockBoid>& flock);
 
+    /**
+     * @brief Updates the boid's behavior using a neighbor grid instead of scanning the whole flock.
+     * @param deltaTime Time since the last update.
+     * @param grid Neighbor grid built from the flock at the start of the frame.
+     * @param fused If true, gathers all three rules in one pass over the neighbors (flockingForce);
+     * if false, runs separate, align and cohere one after another for comparison.
+     */
+    void update(float deltaTime, const NeighborGrid& grid, bool fused = true);
+
+    /**
+     * @brief Places the sprite between the state before and after the last update.
+     * @param alpha Blend factor from FixedTimestep::getAlpha(); 1 draws the latest state.
+     */
+    void interpolate(float alpha);
+
     /**
      * @brief Draws the boid on the window.
      * @param window Reference to the SFML window.
      */
     void draw(sf::RenderWindow& window);
+
+    /**
+     * @brief Adds the boid to a sprite batch instead of drawing it directly.
+     * @param batch Batch collecting this frame's sprites.
+     */
+    void draw(SpriteBatch& batch) const;
     
     /**
      * @brief Gets the current position of the boid.
@@ -63,10 +86,16 @@ public:
      */
     sf::Vector2f getVelocity() const { return velocity; }
 
+    static constexpr float WORLD_WIDTH = 800.0f; // Width of the area boids wrap around
+    static constexpr float WORLD_HEIGHT = 600.0f; // Height of the area boids wrap around
+    static constexpr float NEIGHBOR_RADIUS = 50.0f; // Largest rule radius, used as the neighbor grid cell size
+
 private:
     sf::Vector2f position; // Current position of the boid
     sf::Vector2f velocity; // Current velocity of the boid
     sf::Vector2f acceleration; // Current acceleration of the boid
+    sf::Vector2f previousPosition; // Position before the last update, for interpolation
+    float previousRotation; // Sprite rotation before the last update, for interpolation
     sf::Sprite sprite; // Sprite representing the boid
 
     static constexpr float MAX_SPEED = 100.0f; // Maximum speed of the boid
@@ -93,6 +122,53 @@ private:
      */
     sf::Vector2f cohere(const std::vector<FlockBoid>& flock);
 
+    /**
+     * @brief Calculates the separation force from the boids in a neighbor grid.
+     * @param grid Neighbor grid built from the flock.
+     */
+    sf::Vector2f separate(const NeighborGrid& grid);
+
+    /**
+     * @brief Calculates the alignment force from the boids in a neighbor grid.
+     * @param grid Neighbor grid built from the flock.
+     */
+    sf::Vector2f align(const NeighborGrid& grid);
+
+    /**
+     * @brief Calculates the cohesion force from the boids in a neighbor grid.
+     * @param grid Neighbor grid built from the flock.
+     */
+    sf::Vector2f cohere(const NeighborGrid& grid);
+
+    /**
+     * @brief Shared rule implementations, parameterized on how neighbors are found.
+     * @param forEachNeighbor Called as forEachNeighbor(radius, visit); calls visit(position, velocity)
+     * for every candidate neighbor within (at least) the radius.
+     */
+    template <typename ForEachNeighbor>
+    sf::Vector2f separateFrom(ForEachNeighbor forEachNeighbor);
+    template <typename ForEachNeighbor>
+    sf::Vector2f alignFrom(ForEachNeighbor forEachNeighbor);
+    template <typename ForEachNeighbor>
+    sf::Vector2f cohereFrom(ForEachNeighbor forEachNeighbor);
+
+    /**
+     * @brief Fused flocking kernel: separation, alignment and cohesion from a single pass.
+     * @param forEachNeighbor Neighbor source, as for separateFrom.
+     * @return Weighted sum of the three steering forces, matching the per-rule results.
+     *
+     * Neighbors are compared by squared distance against the squared radii; a square root
+     * is only taken for boids inside the separation radius, where the repulsion is normalized.
+     */
+    template <typename ForEachNeighbor>
+    sf::Vector2f flockingForce(ForEachNeighbor forEachNeighbor);
+
+    /**
+     * @brief Applies the accumulated acceleration, moves the boid and wraps it around the screen.
+     * @param deltaTime Time since the last update.
+     */
+    void integrate(float deltaTime);
+
     /**
      * @brief Limits the magnitude of a vector to a maximum value.
      * @param vec The vector to limit.
@@ -0,0 +1,195 @@
+/**
+ * @file FlockSystem.h
+ * @brief Defines the FlockSystem class, a structure-of-arrays flock simulation.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef FLOCKSYSTEM_H
+#define FLOCKSYSTEM_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <memory>
+#include "FlockSimd.h"
+#include "WorkerPool.h"
+
+/**
+ * @class FlockSystem
+ * @brief Simulates a whole flock with the same rules as FlockBoid, stored as separate float arrays.
+ *
+ * Positions, velocities and orientations live in their own arrays, so the neighbor loops only
+ * touch the data they need. Every update runs as batch passes over the arrays:
+ * 1. sort the boids by grid cell (counting sort), so each cell's boids are contiguous
+ * 2. compute the flocking force of every boid from the sorted snapshot
+ * 3. integrate velocities and positions and wrap around the world
+ * 4. compute orientations for rendering
+ * Rendering is a separate stage that writes all boids into one sf::VertexArray, blended between
+ * the state before and after the last update.
+ *
+ * Because of the sort, array slots change every frame. Boids are addressed by the id
+ * returned from addBoid, which stays fixed.
+ *
+ * The force pass is double-buffered: every force is computed from the positions and velocities
+ * of the previous step, and nothing moves until all forces are done. Each pass only writes its
+ * own slots, so passes 2-4 can be split across threads and give the same result for any
+ * thread count.
+ */
+class FlockSystem {
+public:
+    /**
+     * @brief Constructor to initialize an empty FlockSystem.
+     * @param worldWidth Width of the area boids wrap around.
+     * @param worldHeight Height of the area boids wrap around.
+     */
+    FlockSystem(float worldWidth, float worldHeight);
+
+    /**
+     * @brief Adds a boid with a random heading at full speed, like FlockBoid's constructor.
+     * @param x Initial x-coordinate.
+     * @param y Initial y-coordinate.
+     * @return Id of the new boid.
+     */
+    int addBoid(float x, float y);
+
+    /**
+     * @brief Advances the whole flock by one step.
+     * @param deltaTime Time since the last update.
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief Writes one textured quad per boid into a vertex array.
+     * @param vertices Vertex array to fill; resized and set to quads.
+     * @param texture Boid texture, used for texture coordinates and quad size.
+     * @param scale Scale applied to the texture size, as in sf::Sprite::setScale.
+     * @param alpha Blend between the state before and after the last update (FixedTimestep::getAlpha()).
+     */
+    void buildVertices(sf::VertexArray& vertices, const sf::Texture& texture, float scale, float alpha = 1.0f) const;
+
+    /**
+     * @brief Turns the SIMD force kernel on or off (for comparison with the scalar kernel).
+     * @param enabled True to use the SIMD kernel when the CPU supports it.
+     * @return True if the SIMD kernel is now in use.
+     */
+    bool setSimdEnabled(bool enabled) { return simdEnabled = enabled && FlockSimd::avx2Supported(); }
+
+    /**
+     * @brief Checks whether the SIMD force kernel is in use.
+     */
+    bool isSimdEnabled() const { return simdEnabled; }
+
+    /**
+     * @brief Sets how many threads run the per-boid passes.
+     * @param threadCount Number of threads; 1 runs everything on the calling thread, 0 uses the hardware thread count.
+     */
+    void setThreadCount(unsigned threadCount);
+
+    /**
+     * @brief Gets how many threads run the per-boid passes.
+     */
+    unsigned getThreadCount() const { return workers ? workers->getThreadCount() : 1; }
+
+    /**
+     * @brief Gets the number of boids.
+     */
+    size_t size() const { return ids.size(); }
+
+    /**
+     * @brief Gets the current position of a boid.
+     * @param id Boid id returned by addBoid.
+     */
+    sf::Vector2f getPosition(int id) const { return {positionX[slotOf[id]], positionY[slotOf[id]]}; }
+
+    /**
+     * @brief Gets the current velocity of a boid.
+     * @param id Boid id returned by addBoid.
+     */
+    sf::Vector2f getVelocity(int id) const { return {velocityX[slotOf[id]], velocityY[slotOf[id]]}; }
+
+    // Same tuning as FlockBoid
+    static constexpr float MAX_SPEED = 100.0f; // Maximum speed of a boid
+    static constexpr float MAX_FORCE = 5.0f; // Maximum steering force
+    static constexpr float SEPARATION_RADIUS = 25.0f; // Radius for separation
+    static constexpr float ALIGNMENT_RADIUS = 50.0f; // Radius for alignment
+    static constexpr float COHESION_RADIUS = 50.0f; // Radius for cohesion
+    static constexpr float NEIGHBOR_RADIUS = 50.0f; // Largest rule radius, used as the cell size
+
+private:
+    float worldWidth; // Width of the wrap-around area
+    float worldHeight; // Height of the wrap-around area
+    int columns; // Number of grid columns
+    int rows; // Number of grid rows
+    bool simdEnabled; // Use the AVX2 force kernel (chosen at runtime from the CPU features)
+    std::unique_ptr<WorkerPool> workers; // Threads for the per-boid passes (none when single-threaded)
+
+    // Boid state, one entry per slot (sorted by cell at the start of each update)
+    std::vector<float> positionX, positionY;
+    std::vector<float> velocityX, velocityY;
+    std::vector<float> orientation; // Degrees, for rendering
+    std::vector<float> previousX, previousY, previousOrientation; // State before the last update, for interpolation
+    std::vector<int> ids; // Boid id stored in each slot
+    std::vector<int> slotOf; // Slot of each boid id
+
+    // Per-frame working data
+    std::vector<int> cellStart; // First slot of each cell (one extra at the end)
+    std::vector<int> cellOfSlot; // Cell of each slot before sorting
+    std::vector<float> forceX, forceY; // Flocking force of each slot
+    std::vector<float> scratch; // Scratch buffer for reordering float arrays
+    std::vector<int> scratchIds; // Scratch buffer for reordering ids
+
+    /**
+     * @brief Sorts all boid arrays by grid cell and fills cellStart.
+     */
+    void sortByCell();
+
+    /**
+     * @brief Computes the flocking force for a range of slots from the sorted arrays.
+     * @param begin First slot.
+     * @param end One past the last slot.
+     * @note Gathers neighbor sums with the SIMD or scalar kernel, then turns them into a force.
+     */
+    void computeForces(size_t begin, size_t end);
+
+    /**
+     * @brief Turns one boid's neighbor sums into its flocking force.
+     * @param slot Slot of the boid.
+     * @param sums Neighbor sums gathered for the boid.
+     */
+    void applyNeighborSums(size_t slot, const FlockNeighborSums& sums);
+
+    /**
+     * @brief Applies forces, limits speed, moves and wraps a range of slots.
+     * @param begin First slot.
+     * @param end One past the last slot.
+     * @param deltaTime Time since the last update.
+     */
+    void integrate(size_t begin, size_t end, float deltaTime);
+
+    /**
+     * @brief Computes the orientation of a range of slots from their velocity.
+     * @param begin First slot.
+     * @param end One past the last slot.
+     */
+    void computeOrientations(size_t begin, size_t end);
+
+    /**
+     * @brief Runs a per-slot pass over all boids, split across the worker threads if there are any.
+     * @param pass Called as pass(begin, end) for each range of slots.
+     */
+    void forEachRange(const std::function<void(size_t, size_t)>& pass);
+
+    /**
+     * @brief Converts a coordinate to a grid column or row, clamped to the grid.
+     */
+    int columnOf(float x) const { return std::min(std::max(static_cast<int>(std::floor(x / NEIGHBOR_RADIUS)), 0), columns - 1); }
+    int rowOf(float y) const { return std::min(std::max(static_cast<int>(std::floor(y / NEIGHBOR_RADIUS)), 0), rows - 1); }
+};
+
+#endif // FLOCKSYSTEM_H
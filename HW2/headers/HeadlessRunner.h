@@ -0,0 +1,84 @@
+/**
+ * @file HeadlessRunner.h
+ * @brief Defines the HeadlessRunner class, which steps a simulation without a window and times it.
+ *
+ * Resources Used:
+ * - cppreference, std::chrono: https://en.cppreference.com/w/cpp/chrono
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include "FixedTimestep.h"
+
+/**
+ * @struct HeadlessStats
+ * @brief Timing of one headless run.
+ */
+struct HeadlessStats {
+    long long ticks = 0; // Simulation steps run
+    double seconds = 0; // Wall-clock time of the run
+    float step = 0; // Simulated seconds per tick
+
+    /**
+     * @brief Gets the simulation steps run per wall-clock second.
+     */
+    double ticksPerSecond() const { return seconds > 0 ? ticks / seconds : 0; }
+
+    /**
+     * @brief Gets how many times faster than real time the simulation ran.
+     */
+    double realTimeFactor() const { return ticksPerSecond() * step; }
+};
+
+/**
+ * @class HeadlessRunner
+ * @brief Runs a tick function a fixed number of times, back to back, with no window or draw calls.
+ *
+ * The tick function gets the fixed step as its delta time, so a headless run simulates exactly
+ * what the windowed demo would (which also runs in fixed steps), only as fast as the CPU allows.
+ * Agents log to std::cout, so it is muted during the run unless verbose is set.
+ */
+class HeadlessRunner {
+public:
+    /**
+     * @brief Constructor to set the simulation step.
+     * @param step Delta time passed to every tick.
+     */
+    explicit HeadlessRunner(float step = FixedTimestep::DEFAULT_STEP);
+
+    /**
+     * @brief Runs the simulation.
+     * @param ticks Number of steps to run.
+     * @param tick Called once per step with the step as delta time.
+     * @return Ticks run and wall-clock time.
+     */
+    HeadlessStats run(long long ticks, const std::function<void(float)>& tick);
+
+    /**
+     * @brief Keeps or mutes std::cout during runs (muted by default).
+     * @param enabled True to keep agent logging.
+     */
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    /**
+     * @brief Prints one line summarizing a run, e.g. "flock: 1000 agents, 6000 ticks in 1.2 s (5000 ticks/s, 83x real time)".
+     * @param out Stream to print to.
+     * @param name Name of the simulation.
+     * @param agents Number of agents simulated.
+     * @param stats Result of run.
+     */
+    static void report(std::ostream& out, const std::string& name, size_t agents, const HeadlessStats& stats);
+
+private:
+    FixedTimestep timestep; // Uncapped, one step per tick
+    bool verbose; // Keep std::cout during runs
+};
+
+#endif // HEADLESSRUNNER_H
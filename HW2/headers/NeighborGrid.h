@@ -0,0 +1,97 @@
+/**
+ * @file NeighborGrid.h
+ * @brief Defines the NeighborGrid class, a uniform grid (cell list) for fast flock neighbor queries.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef NEIGHBORGRID_H
+#define NEIGHBORGRID_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+class FlockBoid;
+
+/**
+ * @class NeighborGrid
+ * @brief Buckets a snapshot of the flock into square cells so rules only visit nearby boids.
+ *
+ * The grid is rebuilt once per frame with a counting sort, so each cell's boids are stored
+ * contiguously. Queries read the snapshot taken at build time, not the live flock, which
+ * means every boid sees the same neighbor state no matter the update order.
+ */
+class NeighborGrid {
+public:
+    /**
+     * @brief Snapshot of one boid as seen by neighbor queries.
+     */
+    struct Entry {
+        sf::Vector2f position; // Position at build time
+        sf::Vector2f velocity; // Velocity at build time
+        int index;             // Index of the boid in the flock
+    };
+
+    /**
+     * @brief Constructor to initialize a NeighborGrid.
+     * @param width Width of the area covered by the grid.
+     * @param height Height of the area covered by the grid.
+     * @param cellSize Size of each cell; should be at least the largest query radius.
+     */
+    NeighborGrid(float width, float height, float cellSize);
+
+    /**
+     * @brief Rebuilds the grid from the current state of the flock.
+     * @param flock Reference to the vector of all flock members.
+     */
+    void build(const std::vector<FlockBoid>& flock);
+
+    /**
+     * @brief Visits every boid in the cells overlapping a circle.
+     * @param center Center of the query.
+     * @param radius Query radius; candidates outside it may also be visited.
+     * @param visit Function called with each candidate Entry.
+     */
+    template <typename Visitor>
+    void forEachNeighbor(sf::Vector2f center, float radius, Visitor visit) const {
+        int minColumn = columnOf(center.x - radius);
+        int maxColumn = columnOf(center.x + radius);
+        int minRow = rowOf(center.y - radius);
+        int maxRow = rowOf(center.y + radius);
+
+        for (int row = minRow; row <= maxRow; row++) {
+            // Cells in a row are adjacent in memory, so scan the whole span at once
+            int first = cellStart[row * columns + minColumn];
+            int last = cellStart[row * columns + maxColumn + 1];
+            for (int i = first; i < last; i++) {
+                visit(entries[i]);
+            }
+        }
+    }
+
+private:
+    float cellSize; // Size of each cell
+    int columns; // Number of cell columns
+    int rows; // Number of cell rows
+    std::vector<int> cellStart; // Start of each cell's entries (one extra at the end)
+    std::vector<Entry> entries; // Flock snapshot sorted by cell
+
+    /**
+     * @brief Converts an x-coordinate to a column, clamped to the grid.
+     */
+    int columnOf(float x) const { return std::clamp(static_cast<int>(std::floor(x / cellSize)), 0, columns - 1); }
+
+    /**
+     * @brief Converts a y-coordinate to a row, clamped to the grid.
+     */
+    int rowOf(float y) const { return std::clamp(static_cast<int>(std::floor(y / cellSize)), 0, rows - 1); }
+};
+
+#endif // NEIGHBORGRID_H
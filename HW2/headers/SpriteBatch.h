@@ -0,0 +1,96 @@
+/**
+ * @file SpriteBatch.h
+ * @brief Defines the SpriteBatch class, which collects sprites, dots and lines into a few vertex arrays.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - SFML Tutorial, Designing your own entities with vertex arrays: https://www.sfml-dev.org/tutorials/2.6/graphics-vertex-array.php
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <utility>
+
+/**
+ * @class SpriteBatch
+ * @brief Batches a frame's sprites and breadcrumb dots so they take a handful of draw calls.
+ *
+ * Sprites are written as textured quads into one vertex array per texture. Dots (breadcrumbs,
+ * waypoint markers) become small triangle fans in one untextured array, and line segments go
+ * into one line array. draw() then issues one call for the lines, one for the dots and one per
+ * texture, in that order, so sprites stay on top as before.
+ *
+ * Filling the batch does not need a window, so a headless benchmark can call clear() and the
+ * add functions every frame and never call draw().
+ */
+class SpriteBatch {
+public:
+    /**
+     * @brief Removes everything added since the last clear; keeps the allocated memory.
+     */
+    void clear();
+
+    /**
+     * @brief Adds a sprite as one textured quad, using its transform, texture rect and color.
+     * @param sprite Sprite to add; sprites without a texture are skipped.
+     */
+    void addSprite(const sf::Sprite& sprite);
+
+    /**
+     * @brief Adds a filled circle as a dot.
+     * @param shape Circle to add; uses its transform, radius and fill color.
+     */
+    void addCircle(const sf::CircleShape& shape);
+
+    /**
+     * @brief Adds a filled dot.
+     * @param center Center of the dot.
+     * @param radius Radius of the dot.
+     * @param color Fill color.
+     */
+    void addDot(sf::Vector2f center, float radius, sf::Color color);
+
+    /**
+     * @brief Adds a line segment.
+     * @param from Start point.
+     * @param to End point.
+     * @param color Line color.
+     */
+    void addLine(sf::Vector2f from, sf::Vector2f to, sf::Color color);
+
+    /**
+     * @brief Draws the whole batch: lines, then dots, then one call per texture.
+     * @param target Window or texture to draw to.
+     */
+    void draw(sf::RenderTarget& target) const;
+
+    /**
+     * @brief Gets the number of draw calls draw() would make.
+     */
+    size_t getDrawCallCount() const;
+
+    /**
+     * @brief Gets the total number of vertices in the batch.
+     */
+    size_t getVertexCount() const;
+
+    static constexpr int DOT_SEGMENTS = 8; // Triangles per dot; plenty for small markers
+
+private:
+    std::vector<std::pair<const sf::Texture*, sf::VertexArray>> layers; // One quad array per texture, in first-use order
+    sf::VertexArray dots{sf::Triangles}; // All dots
+    sf::VertexArray lines{sf::Lines}; // All line segments
+
+    /**
+     * @brief Gets the quad array for a texture, adding one if this is the first sprite using it.
+     */
+    sf::VertexArray& layerFor(const sf::Texture* texture);
+};
+
+#endif // SPRITEBATCH_H
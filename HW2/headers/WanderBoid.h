@@ -24,6 +24,8 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <random>
+#include "SpriteBatch.h"
+#include "BreadcrumbTrails.h"
 
 // Constants for the boid's wander behavior
 constexpr float MAX_SPEED = 150.0f; // Maximum speed of the boid
@@ -36,27 +38,6 @@ constexpr int BREADCRUMB_INTERVAL = 60; // Interval for dropping breadcrumbs
 constexpr float WINDOW_WIDTH = 640; // Window width
 constexpr float WINDOW_HEIGHT = 480; // Window height
 
-/**
- * @class Crumb
- * @brief Represents a visual breadcrumb marking the WanderBoid's movement path.
- */
-class Crumb {
-public:
-    /**
-     * @brief Constructor to initialize breadcrumb position.
-     * @param pos The position of the breadcrumb.
-     */
-    Crumb(sf::Vector2f pos);
-
-    /**
-     * @brief Draws the breadcrumb on the window.
-     * @param window Reference to the SFML window.
-     */
-    void draw(sf::RenderWindow& window) const;
-private:
-    sf::CircleShape shape; // Shape of the breadcrumb
-};
-
 /**
  * @class WanderBoid
  * @brief Implements a boid that exhibits smooth wandering behavior.
@@ -67,9 +48,10 @@ public:
      * @brief Constructor to initialize a WanderBoid.
      * @param w Pointer to the SFML window.
      * @param tex Reference to the boid texture.
-     * @param crumbs Pointer to a vector of breadcrumbs.
+     * @param crumbs Pointer to the breadcrumb trails.
+     * @param trail Index of this boid's trail.
      */
-    WanderBoid(sf::RenderWindow* w, sf::Texture& tex, std::vector<Crumb>* crumbs);
+    WanderBoid(sf::RenderWindow* w, sf::Texture& tex, BreadcrumbTrails* crumbs, size_t trail = 0);
 
     /**
      * @brief Updates the boid's position, orientation, and breadcrumbs.
@@ -77,11 +59,23 @@ public:
      */
     void update(float deltaTime);
 
+    /**
+     * @brief Places the sprite between the state before and after the last update.
+     * @param alpha Blend factor from FixedTimestep::getAlpha(); 1 draws the latest state.
+     */
+    void interpolate(float alpha);
+
     /**
      * @brief Draws the boid on the window.
      */
     void draw();
 
+    /**
+     * @brief Adds the boid to a sprite batch instead of drawing it to its window.
+     * @param batch Batch collecting this frame's sprites.
+     */
+    void draw(SpriteBatch& batch) const;
+
 private:
     sf::RenderWindow* window; // Pointer to the SFML window
     sf::Sprite sprite; // Sprite representing the boid
@@ -89,7 +83,10 @@ private:
     sf::Vector2f velocity; // Current velocity of the boid
     float wanderAngle; // Current angle for wandering
     float orientation; // Current orientation of the boid
-    std::vector<Crumb>* breadcrumbs; // Pointer to the vector of breadcrumbs
+    sf::Vector2f previousPosition; // Position before the last update, for interpolation
+    float previousOrientation; // Orientation before the last update, for interpolation
+    BreadcrumbTrails* breadcrumbs; // Pointer to the breadcrumb trails
+    size_t trail; // Index of this boid's trail
 
     std::random_device rd; // Random device for seeding
     std::mt19937 rng; // Random number generator
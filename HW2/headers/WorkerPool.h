@@ -0,0 +1,81 @@
+/**
+ * @file WorkerPool.h
+ * @brief Defines the WorkerPool class, a fixed set of threads for splitting per-boid loops.
+ *
+ * Resources Used:
+ * - cppreference, Thread support library: https://en.cppreference.com/w/cpp/thread
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @class WorkerPool
+ * @brief Runs a loop body over index ranges on persistent worker threads.
+ *
+ * parallelFor splits [0, count) into one contiguous range per thread and blocks until all
+ * ranges are done. The split only depends on count and the thread count, and the body must
+ * only write to the indices it was given, so results do not depend on thread timing.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Constructor to start the worker threads.
+     * @param threadCount Total threads including the calling thread; 0 uses the hardware thread count.
+     */
+    explicit WorkerPool(unsigned threadCount = 0);
+
+    /**
+     * @brief Destructor to stop and join the worker threads.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Runs body over [0, count), one contiguous range per thread, and waits for all of them.
+     * @param count Number of indices.
+     * @param body Called as body(begin, end) for each non-empty range.
+     * @note The calling thread runs the first range itself.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief Gets the number of threads, including the calling thread.
+     */
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+private:
+    std::vector<std::thread> workers; // Worker threads (the caller is thread 0)
+    std::mutex mutex; // Guards the job fields below
+    std::condition_variable jobReady; // Signals workers that a new job started
+    std::condition_variable jobDone; // Signals the caller that a worker finished
+    const std::function<void(size_t, size_t)>* body = nullptr; // Current loop body
+    size_t count = 0; // Current index count
+    unsigned generation = 0; // Incremented for every job so workers run each one once
+    unsigned pending = 0; // Workers still running the current job
+    bool stopping = false; // Set by the destructor
+
+    /**
+     * @brief Gets the range of one thread for the current job.
+     */
+    void rangeOf(unsigned thread, size_t& begin, size_t& end) const;
+
+    /**
+     * @brief Worker loop: waits for a job, runs its range, reports back.
+     * @param thread Index of this worker (1 and up).
+     */
+    void run(unsigned thread);
+};
+
+#endif // WORKERPOOL_H
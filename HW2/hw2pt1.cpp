@@ -18,6 +18,7 @@
 // Include necessary headers
 #include "headers/Kinematic.h"
 #include "headers/VelocityMatching.h"
+#include "headers/FixedTimestep.h"
 
 // Constants
 constexpr float WINDOW_WIDTH = 640; // Window width
@@ -60,8 +61,10 @@ int main() {
   // Velocity Matching Behavior
   VelocityMatching velocityMatching;
 
-  // Start the game clock
+  // Start the game clock; the simulation runs in fixed steps
   sf::Clock clock;
+  FixedTimestep timestep;
+  Kinematic previousKinematic = characterKinematic; // State before the last step, for interpolation
 
   while (window.isOpen()) {
     sf::Event event;
@@ -78,15 +81,21 @@ int main() {
     mouseKinematic.velocity = getMouseVelocity(lastMousePos, currentMousePos, deltaTime);
     lastMousePos = currentMousePos; // Update last mouse position
 
-    // Apply velocity matching to calculate acceleration
-    SteeringData velocityAccel = velocityMatching.calculateAcceleration(characterKinematic, mouseKinematic);
+    // Run the simulation steps due this frame
+    int steps = timestep.advance(deltaTime);
+    for (int step = 0; step < steps; step++) {
+      previousKinematic = characterKinematic;
 
-    // Update Character Kinematics
-    characterKinematic.velocity += velocityAccel.linear * deltaTime;
-    characterKinematic.update(deltaTime); // Update position and orientation based on velocity
+      // Apply velocity matching to calculate acceleration
+      SteeringData velocityAccel = velocityMatching.calculateAcceleration(characterKinematic, mouseKinematic);
 
-    // Update SFML Sprite
-    character.setPosition(characterKinematic.position);
+      // Update Character Kinematics
+      characterKinematic.velocity += velocityAccel.linear * timestep.getStep();
+      characterKinematic.update(timestep.getStep()); // Update position and orientation based on velocity
+    }
+
+    // Update SFML Sprite between the last two steps
+    character.setPosition(FixedTimestep::lerp(previousKinematic.position, characterKinematic.position, timestep.getAlpha()));
 
     // Set sprite rotation based on movement direction
     if (characterKinematic.velocity.x != 0 || characterKinematic.velocity.y != 0) {
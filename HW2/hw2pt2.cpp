@@ -22,13 +22,14 @@
 #include "headers/Kinematic.h"
 #include "headers/Arrive.h"
 #include "headers/Align.h"
+#include "headers/FixedTimestep.h"
 
 // Constants
 constexpr float WINDOW_WIDTH = 640; // Window width
 constexpr float WINDOW_HEIGHT = 480; // Window height
 constexpr float SPRITE_SCALE = 0.1f; // Scale adjustment for boid character
 constexpr int BREADCRUMB_LIMIT = 50; // Max breadcrumbs stored
-constexpr int BREADCRUMB_INTERVAL = 60; // Frames between dropping breadcrumbs
+constexpr int BREADCRUMB_INTERVAL = 60; // Simulation steps between dropping breadcrumbs
 
 // Breadcrumb class for visualizing motion history
 class Crumb {
@@ -96,7 +97,10 @@ int main() {
 
     /** End ChatGPT citation */
 
+    // Clock and fixed-step simulation
     sf::Clock clock;
+    FixedTimestep timestep;
+    Kinematic previousKinematic = characterKinematic; // State before the last step, for interpolation
 
     // Breadcrumb storage
     std::deque<Crumb> breadcrumbs;
@@ -113,30 +117,43 @@ int main() {
             }
         }
 
-        // Get delta time
-        float deltaTime = clock.restart().asSeconds();
+        // Run the simulation steps due this frame
+        int steps = timestep.advance(clock.restart().asSeconds());
+        for (int step = 0; step < steps; step++) {
+            previousKinematic = characterKinematic;
 
-        // Apply Arrive behavior
-        SteeringData arriveAcceleration = arriveBehavior.calculateAcceleration(characterKinematic, targetKinematic);
-        characterKinematic.velocity += arriveAcceleration.linear * deltaTime;
+            // Apply Arrive behavior
+            SteeringData arriveAcceleration = arriveBehavior.calculateAcceleration(characterKinematic, targetKinematic);
+            characterKinematic.velocity += arriveAcceleration.linear * timestep.getStep();
 
-        // Make sure character stops near target
-        float speed = std::sqrt(characterKinematic.velocity.x * characterKinematic.velocity.x + 
-                                characterKinematic.velocity.y * characterKinematic.velocity.y);
+            // Make sure character stops near target
+            float speed = std::sqrt(characterKinematic.velocity.x * characterKinematic.velocity.x + 
+                                    characterKinematic.velocity.y * characterKinematic.velocity.y);
 
-        if (speed < 0.5f) {
-            characterKinematic.velocity = {0, 0};  // Stop completely if close enough
-        }
+            if (speed < 0.5f) {
+                characterKinematic.velocity = {0, 0};  // Stop completely if close enough
+            }
+
+            characterKinematic.update(timestep.getStep());
 
-        characterKinematic.update(deltaTime);
+            // Apply Align behavior
+            SteeringData alignAcceleration = alignBehavior.calculateAcceleration(characterKinematic, targetKinematic);
+            characterKinematic.rotation += alignAcceleration.angular * timestep.getStep();
+            characterKinematic.update(timestep.getStep());
 
-        // Apply Align behavior
-        SteeringData alignAcceleration = alignBehavior.calculateAcceleration(characterKinematic, targetKinematic);
-        characterKinematic.rotation += alignAcceleration.angular * deltaTime;
-        characterKinematic.update(deltaTime);
+            // Handle Breadcrumbs
+            if (--breadcrumbCounter <= 0) {
+                breadcrumbs.emplace_back(characterKinematic.position);
+                breadcrumbCounter = BREADCRUMB_INTERVAL;
+
+                if (breadcrumbs.size() > BREADCRUMB_LIMIT) {
+                    breadcrumbs.pop_front(); // Remove oldest breadcrumb
+                }
+            }
+        }
 
-        // Update the sprite position
-        character.setPosition(characterKinematic.position);
+        // Update the sprite position between the last two steps
+        character.setPosition(FixedTimestep::lerp(previousKinematic.position, characterKinematic.position, timestep.getAlpha()));
 
         // Set sprite rotation based on movement direction
         if (characterKinematic.velocity.x != 0 || characterKinematic.velocity.y != 0) {
@@ -144,16 +161,6 @@ int main() {
             character.setRotation(angle);
         }
 
-        // Handle Breadcrumbs
-        if (--breadcrumbCounter <= 0) {
-            breadcrumbs.emplace_back(characterKinematic.position);
-            breadcrumbCounter = BREADCRUMB_INTERVAL;
-
-            if (breadcrumbs.size() > BREADCRUMB_LIMIT) {
-                breadcrumbs.pop_front(); // Remove oldest breadcrumb
-            }
-        }
-
         // Render
         window.clear(sf::Color::White);
         for (const auto& crumb : breadcrumbs) {
@@ -20,6 +20,8 @@
 
 // Include necessary headers
 #include "headers/WanderBoid.h"
+#include "headers/SpriteBatch.h"
+#include "headers/FixedTimestep.h"
 
 // Main Function
 int main() {
@@ -33,14 +35,18 @@ int main() {
         return -1;
     }
 
-    // Setup a vector to store breadcrumbs
-    std::vector<Crumb> breadcrumbs;
+    // Setup a ring buffer to store breadcrumbs
+    BreadcrumbTrails breadcrumbs(1, BREADCRUMB_LIMIT);
 
     // Create a WanderBoid object to exhibit wandering behavior
     WanderBoid boid(&window, texture, &breadcrumbs);
 
-    // Clock to manage delta time
+    // Breadcrumbs and the boid are drawn through one batch
+    SpriteBatch batch;
+
+    // Clock to manage delta time, turned into fixed simulation steps
     sf::Clock clock;
+    FixedTimestep timestep;
 
     while (window.isOpen()) {
         sf::Event event;
@@ -49,16 +55,21 @@ int main() {
                 window.close(); // Close window
         }
 
-        // Get delta time
-        float deltaTime = clock.restart().asSeconds();
+        // Update the wandering boid once per simulation step due this frame
+        int steps = timestep.advance(clock.restart().asSeconds());
+        for (int step = 0; step < steps; step++) {
+            boid.update(timestep.getStep());
+        }
 
         // Render
         window.clear(sf::Color::White);
 
-        // Update and draw wandering boid and breadcrumbs
-        boid.update(deltaTime);
-        for (const auto& crumb : breadcrumbs) crumb.draw(window);
-        boid.draw();
+        // Draw wandering boid (between its last two steps) and breadcrumbs
+        boid.interpolate(timestep.getAlpha());
+        batch.clear();
+        breadcrumbs.draw(batch, 3.0f, sf::Color::Blue);
+        boid.draw(batch);
+        batch.draw(window);
         window.display();
     }
 
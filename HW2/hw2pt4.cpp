@@ -13,83 +13,179 @@
 
 #include <SFML/Graphics.hpp>
 #include "headers/FlockBoid.h"
+#include "headers/NeighborGrid.h"
+#include "headers/FlockSystem.h"
+#include "headers/WorkerPool.h"
+#include "headers/SpriteBatch.h"
+#include "headers/BreadcrumbTrails.h"
+#include "headers/FixedTimestep.h"
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 
 constexpr int MAX_BREADCRUMBS = 15; // Max trail length for each boid
-constexpr int BREADCRUMB_INTERVAL = 45; // Frames between dropping breadcrumbs
+constexpr int BREADCRUMB_INTERVAL = 45; // Simulation steps between dropping breadcrumbs
 constexpr float WINDOW_WIDTH = 640; // Window width
 constexpr float WINDOW_HEIGHT = 480; // Window height
+constexpr int DEFAULT_FLOCK_SIZE = 30; // Number of boids when no count is given on the command line
+constexpr float BOID_SCALE = 0.03f; // Sprite scale, same as FlockBoid
+
+int main(int argc, char* argv[]) {
+    // Command line: [flock size] [--soa] [--threads N] [--headless FRAMES], e.g. ./hw2pt4 20000 --soa --threads 4
+    int flockSize = DEFAULT_FLOCK_SIZE;
+    bool useFlockSystem = false; // Simulate with the structure-of-arrays FlockSystem instead of FlockBoid objects
+    unsigned threadCount = 0; // Threads for the flock update; 0 uses the hardware thread count
+    int headlessFrames = 0; // If set, run this many uncapped steps without a window and print timings
+    for (int arg = 1; arg < argc; arg++) {
+        if (std::string(argv[arg]) == "--soa") useFlockSystem = true;
+        else if (std::string(argv[arg]) == "--threads" && arg + 1 < argc) threadCount = std::max(1, std::atoi(argv[++arg]));
+        else if (std::string(argv[arg]) == "--headless" && arg + 1 < argc) headlessFrames = std::max(1, std::atoi(argv[++arg]));
+        else if (std::atoi(argv[arg]) > 0) flockSize = std::atoi(argv[arg]);
+    }
+    bool headless = headlessFrames > 0;
 
-int main() {
-    // Create SFML window
-    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Part 4: Flocking Behavior and Blending/Arbitration");
+    // Create SFML window (headless runs only fill the render buffers)
+    sf::RenderWindow window;
+    if (!headless) window.create(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Part 4: Flocking Behavior and Blending/Arbitration");
 
-    // Load Boid texture
+    // Load Boid texture (not when headless: uploading a texture needs an OpenGL context, which needs a display)
     sf::Texture texture;
-    if (!texture.loadFromFile("boid.png")) {
+    if (!headless && !texture.loadFromFile("boid.png")) {
         std::cerr << "Error: Failed to load boid.png" << std::endl;
         return -1;
     }
 
     // Create a vector to store the flock of boids
     std::vector<FlockBoid> flock;
-    // Vectors to store breadcrumbs and timers for each boid
-    std::vector<std::vector<sf::CircleShape>> breadcrumbs(flock.size());
-    std::vector<int> breadcrumbTimers(flock.size(), 0);
-
-    // Initialize the flock with 30 boids
-    for (int i = 0; i < 30; i++) {
-        flock.emplace_back(rand() % 800, rand() % 600, texture);
-        breadcrumbs.emplace_back(); // Create an empty breadcrumb list for each boid
-        breadcrumbTimers.emplace_back(0); // Initialize timer for each boid
+    // Breadcrumb trail and timer for each boid
+    BreadcrumbTrails breadcrumbs(flockSize, MAX_BREADCRUMBS);
+    std::vector<int> breadcrumbTimers(flockSize, 0);
+
+    // Structure-of-arrays flock and the vertex array it is rendered through
+    FlockSystem flockSystem(FlockBoid::WORLD_WIDTH, FlockBoid::WORLD_HEIGHT);
+    flockSystem.setThreadCount(threadCount);
+    sf::VertexArray boidVertices;
+
+    // Breadcrumbs and FlockBoid sprites are drawn through one batch
+    SpriteBatch batch;
+
+    // Threads for updating FlockBoid objects (FlockSystem has its own)
+    WorkerPool workers(useFlockSystem ? 1 : threadCount);
+
+    // Initialize the flock
+    if (!useFlockSystem) flock.reserve(flockSize);
+    for (int i = 0; i < flockSize; i++) {
+        if (useFlockSystem) flockSystem.addBoid(rand() % 800, rand() % 600);
+        else flock.emplace_back(rand() % 800, rand() % 600, texture);
     }
 
-    // Clock to manage delta time
+    // Neighbor grid with cells as large as the biggest flocking radius
+    NeighborGrid grid(FlockBoid::WORLD_WIDTH, FlockBoid::WORLD_HEIGHT, FlockBoid::NEIGHBOR_RADIUS);
+
+    // Fused single-pass flocking kernel; press F to compare against the per-rule passes
+    bool fusedKernel = true;
+
+    // Clock to manage delta time, turned into fixed simulation steps (one step per frame when headless)
     sf::Clock clock;
+    FixedTimestep timestep;
+    timestep.setUncapped(headless);
 
-    while (window.isOpen()) {
+    // Headless timings
+    int frame = 0;
+    double updateMs = 0, fillMs = 0;
+    auto runStart = std::chrono::steady_clock::now();
+
+    while (headless ? frame < headlessFrames : window.isOpen()) {
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (!headless && window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) window.close();
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F) {
+                fusedKernel = !fusedKernel;
+                std::cout << (fusedKernel ? "Fused flocking kernel" : "Per-rule flocking passes") << std::endl;
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::S && useFlockSystem) {
+                bool simd = flockSystem.setSimdEnabled(!flockSystem.isSimdEnabled());
+                std::cout << (simd ? "SIMD force kernel" : "Scalar force kernel") << std::endl;
+            }
         }
 
-        // Get delta time
-        float deltaTime = clock.restart().asSeconds();
-
-        // Render
-        window.clear(sf::Color::White);
+        // Run the simulation steps due this frame
+        int steps = timestep.advance(clock.restart().asSeconds());
+        float deltaTime = timestep.getStep();
+        auto updateStart = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            // Update the whole flock before drawing. FlockBoids read their neighbors from the grid
+            // snapshot and only write themselves, so they can update in parallel in any order.
+            if (useFlockSystem) {
+                flockSystem.update(deltaTime);
+            } else {
+                grid.build(flock); // Rebuild the neighbor grid once per step
+                workers.parallelFor(flock.size(), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        flock[i].update(deltaTime, grid, fusedKernel);
+                    }
+                });
+            }
 
-        // Iterate over flock
-        for (size_t i = 0; i < flock.size(); i++) {
-            // Drop a breadcrumb every few frames
-            breadcrumbTimers[i]++;
-            if (breadcrumbTimers[i] >= BREADCRUMB_INTERVAL) {
-                breadcrumbTimers[i] = 0;
-                sf::CircleShape breadcrumb(3); // Small breadcrumb dot
-                breadcrumb.setFillColor(sf::Color::Blue);
-                breadcrumb.setPosition(flock[i].getPosition());
-                breadcrumbs[i].push_back(breadcrumb);
-
-                // Limit breadcrumb trail length
-                if (breadcrumbs[i].size() > MAX_BREADCRUMBS) {
-                    breadcrumbs[i].erase(breadcrumbs[i].begin()); // Remove oldest breadcrumb
+            // Drop a breadcrumb every few steps
+            for (int i = 0; i < flockSize; i++) {
+                breadcrumbTimers[i]++;
+                if (breadcrumbTimers[i] >= BREADCRUMB_INTERVAL) {
+                    breadcrumbTimers[i] = 0;
+                    sf::Vector2f boidPosition = useFlockSystem ? flockSystem.getPosition(i) : flock[i].getPosition();
+                    breadcrumbs.push(i, boidPosition); // Replaces the oldest crumb once the trail is full
                 }
             }
+        }
 
-            // Draw breadcrumbs before rendering the boid
-            for (const auto& crumb : breadcrumbs[i]) {
-                window.draw(crumb);
+        // Fill the render buffers, with boids blended between their last two steps
+        auto fillStart = std::chrono::steady_clock::now();
+        float alpha = timestep.getAlpha();
+        batch.clear();
+
+        // Batch breadcrumbs and boids
+        for (int i = 0; i < flockSize; i++) {
+            breadcrumbs.draw(i, batch, 3.0f, sf::Color::Blue);
+            if (!useFlockSystem) {
+                flock[i].interpolate(alpha);
+                flock[i].draw(batch);
             }
+        }
+
+        // The whole FlockSystem goes into its own vertex array
+        if (useFlockSystem) {
+            flockSystem.buildVertices(boidVertices, texture, BOID_SCALE, alpha);
+        }
+        auto fillEnd = std::chrono::steady_clock::now();
+        updateMs += std::chrono::duration<double, std::milli>(fillStart - updateStart).count();
+        fillMs += std::chrono::duration<double, std::milli>(fillEnd - fillStart).count();
+        frame++;
 
-            // Update and render each boid
-            flock[i].update(deltaTime, flock);
-            flock[i].draw(window);
+        if (headless) continue;
+
+        // Render: breadcrumbs and boids take a few draw calls in total
+        window.clear(sf::Color::White);
+        batch.draw(window);
+        if (useFlockSystem) {
+            window.draw(boidVertices, &texture);
         }
 
         // Display frame
         window.display();
     }
 
+    // Report average frame timings and simulation throughput for headless runs
+    if (headless) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+        size_t drawCalls = batch.getDrawCallCount() + (useFlockSystem ? 1 : 0);
+        size_t vertices = batch.getVertexCount() + (useFlockSystem ? boidVertices.getVertexCount() : 0);
+        std::cout << frame << " frames, " << flockSize << " boids: update " << updateMs / frame << " ms, buffer fill "
+                  << fillMs / frame << " ms, " << drawCalls << " draw calls, " << vertices << " vertices, "
+                  << timestep.getStepCount() / seconds << " steps/s" << std::endl;
+    }
+
     return 0;
 }
@@ -0,0 +1,114 @@
+/**
+ * @file hw2sim.cpp
+ * @brief Runs the wander and flocking simulations headless (no window, no drawing) and reports ticks per second.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 2/23/2025
+ */
+
+#include <SFML/Graphics.hpp>
+#include "headers/WanderBoid.h"
+#include "headers/FlockBoid.h"
+#include "headers/NeighborGrid.h"
+#include "headers/FlockSystem.h"
+#include "headers/WorkerPool.h"
+#include "headers/BreadcrumbTrails.h"
+#include "headers/HeadlessRunner.h"
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+
+constexpr int DEFAULT_AGENTS = 1000; // Agents per simulation when no count is given
+constexpr long long DEFAULT_TICKS = 6000; // Ticks per simulation when no count is given (100 s at 60 Hz)
+
+// Wandering boids, each with its own breadcrumb trail (Part 3)
+HeadlessStats runWander(HeadlessRunner& runner, int agents, long long ticks) {
+    sf::Texture texture; // Never loaded; sprites only keep a pointer to it
+    BreadcrumbTrails breadcrumbs(agents, BREADCRUMB_LIMIT);
+    std::deque<WanderBoid> boids; // WanderBoid owns its random generator, so it is not copied around
+    for (int i = 0; i < agents; i++) {
+        boids.emplace_back(nullptr, texture, &breadcrumbs, i);
+    }
+
+    return runner.run(ticks, [&](float deltaTime) {
+        for (WanderBoid& boid : boids) {
+            boid.update(deltaTime);
+        }
+    });
+}
+
+// FlockBoid objects with the neighbor grid, split across threads like hw2pt4 (Part 4)
+HeadlessStats runFlock(HeadlessRunner& runner, int agents, long long ticks, unsigned threadCount) {
+    sf::Texture texture;
+    std::vector<FlockBoid> flock;
+    flock.reserve(agents);
+    for (int i = 0; i < agents; i++) {
+        flock.emplace_back(rand() % 800, rand() % 600, texture);
+    }
+    NeighborGrid grid(FlockBoid::WORLD_WIDTH, FlockBoid::WORLD_HEIGHT, FlockBoid::NEIGHBOR_RADIUS);
+    WorkerPool workers(threadCount);
+
+    return runner.run(ticks, [&](float deltaTime) {
+        grid.build(flock);
+        workers.parallelFor(flock.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                flock[i].update(deltaTime, grid);
+            }
+        });
+    });
+}
+
+// Structure-of-arrays FlockSystem (Part 4, --soa)
+HeadlessStats runFlockSystem(HeadlessRunner& runner, int agents, long long ticks, unsigned threadCount) {
+    FlockSystem flockSystem(FlockBoid::WORLD_WIDTH, FlockBoid::WORLD_HEIGHT);
+    flockSystem.setThreadCount(threadCount);
+    for (int i = 0; i < agents; i++) {
+        flockSystem.addBoid(rand() % 800, rand() % 600);
+    }
+
+    return runner.run(ticks, [&](float deltaTime) {
+        flockSystem.update(deltaTime);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    // Command line: [wander|flock|soa] [agents] [ticks] [--threads N] [--verbose], e.g. ./hw2sim flock 5000 600
+    std::string simulation = "all";
+    int agents = DEFAULT_AGENTS;
+    long long ticks = DEFAULT_TICKS;
+    unsigned threadCount = 0; // 0 uses the hardware thread count
+    HeadlessRunner runner;
+    int counts = 0; // Number of plain numbers seen (agents first, then ticks)
+    for (int arg = 1; arg < argc; arg++) {
+        std::string value = argv[arg];
+        if (value == "wander" || value == "flock" || value == "soa") simulation = value;
+        else if (value == "--threads" && arg + 1 < argc) threadCount = std::max(1, std::atoi(argv[++arg]));
+        else if (value == "--verbose") runner.setVerbose(true);
+        else if (std::atoll(argv[arg]) > 0) {
+            if (counts++ == 0) agents = std::atoi(argv[arg]);
+            else ticks = std::atoll(argv[arg]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [wander|flock|soa] [agents] [ticks] [--threads N] [--verbose]" << std::endl;
+            return -1;
+        }
+    }
+
+    if (simulation == "all" || simulation == "wander") {
+        HeadlessRunner::report(std::cout, "wander", agents, runWander(runner, agents, ticks));
+    }
+    if (simulation == "all" || simulation == "flock") {
+        HeadlessRunner::report(std::cout, "flock", agents, runFlock(runner, agents, ticks, threadCount));
+    }
+    if (simulation == "all" || simulation == "soa") {
+        HeadlessRunner::report(std::cout, "soa", agents, runFlockSystem(runner, agents, ticks, threadCount));
+    }
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "../headers/BreadcrumbTrails.h"
+
+// Constructor
+BreadcrumbTrails::BreadcrumbTrails(size_t trailCount, size_t capacity)
+    : capacity(capacity), positionX(trailCount * capacity), positionY(trailCount * capacity),
+      oldest(trailCount, 0), count(trailCount, 0) {}
+
+// Write the next slot, or overwrite the oldest crumb once the trail is full
+void BreadcrumbTrails::push(size_t trail, sf::Vector2f position) {
+    if (capacity == 0) return;
+    size_t slot;
+    if (count[trail] < capacity) {
+        slot = (oldest[trail] + count[trail]) % capacity;
+        count[trail]++;
+    } else {
+        slot = oldest[trail];
+        oldest[trail] = (oldest[trail] + 1) % capacity;
+    }
+    positionX[trail * capacity + slot] = position.x;
+    positionY[trail * capacity + slot] = position.y;
+}
+
+// Crumbs are indexed from the oldest
+sf::Vector2f BreadcrumbTrails::get(size_t trail, size_t index) const {
+    size_t slot = trail * capacity + (oldest[trail] + index) % capacity;
+    return {positionX[slot], positionY[slot]};
+}
+
+// Add one trail's crumbs as dots
+void BreadcrumbTrails::draw(size_t trail, SpriteBatch& batch, float radius, sf::Color color) const {
+    for (size_t i = 0; i < count[trail]; i++) {
+        batch.addDot(get(trail, i), radius, color);
+    }
+}
+
+// Add every trail's crumbs as dots
+void BreadcrumbTrails::draw(SpriteBatch& batch, float radius, sf::Color color) const {
+    for (size_t trail = 0; trail < count.size(); trail++) {
+        draw(trail, batch, radius, color);
+    }
+}
@@ -0,0 +1,47 @@
+#include "../headers/FixedTimestep.h"
+#include <cmath>
+
+// Constructor
+FixedTimestep::FixedTimestep(float step, int maxSteps)
+    : step(step), maxSteps(maxSteps < 1 ? 1 : maxSteps), accumulator(0), uncapped(false), stepCount(0), droppedStepCount(0) {}
+
+// Add the frame time and return how many whole steps are due
+int FixedTimestep::advance(float frameTime) {
+    if (uncapped) {
+        stepCount++;
+        return 1;
+    }
+
+    accumulator += frameTime > 0 ? frameTime : 0;
+    int steps = static_cast<int>(accumulator / step);
+    accumulator -= steps * step;
+
+    // Drop whatever the catch-up limit does not allow
+    if (steps > maxSteps) {
+        droppedStepCount += steps - maxSteps;
+        steps = maxSteps;
+    }
+    if (accumulator < 0) accumulator = 0; // Float rounding
+
+    stepCount += steps;
+    return steps;
+}
+
+// Switch uncapped mode, starting the accumulator over
+void FixedTimestep::setUncapped(bool enabled) {
+    uncapped = enabled;
+    accumulator = 0;
+}
+
+// Linear blend of two positions
+sf::Vector2f FixedTimestep::lerp(sf::Vector2f from, sf::Vector2f to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+// Blend two angles through the smaller difference
+float FixedTimestep::lerpAngle(float from, float to, float alpha) {
+    float difference = std::fmod(to - from, 360.0f);
+    if (difference > 180.0f) difference -= 360.0f;
+    if (difference < -180.0f) difference += 360.0f;
+    return from + difference * alpha;
+}
@@ -1,4 +1,5 @@
 #include "../headers/FlockBoid.h"
+#include "../headers/FixedTimestep.h"
 
 // Constructor
 FlockBoid::FlockBoid(float x, float y, sf::Texture& texture) {
@@ -6,6 +7,8 @@ FlockBoid::FlockBoid(float x, float y, sf::Texture& texture) {
     velocity = sf::Vector2f((rand() % 200 - 100) / 100.0f, (rand() % 200 - 100) / 100.0f); // Random initial velocity
     velocity = normalize(velocity) * MAX_SPEED; // Limit initial velocity to max speed
     acceleration = sf::Vector2f(0, 0); // Initialize acceleration
+    previousPosition = position; // Nothing to interpolate from yet
+    previousRotation = atan2(velocity.y, velocity.x) * 180.0f / 3.14159265f;
 
     sprite.setTexture(texture); // Set texture for the sprite
     sprite.setScale(0.03f, 0.03f); // Set scale for the sprite
@@ -20,6 +23,31 @@ void FlockBoid::update(float deltaTime, const std::vector<FlockBoid>& flock) {
 
     // Combine all behavior forces to calculate final acceleration
     acceleration += sep + ali + coh;
+    integrate(deltaTime);
+}
+
+// Update function using a neighbor grid; same rules and weights as above
+void FlockBoid::update(float deltaTime, const NeighborGrid& grid, bool fused) {
+    if (fused) {
+        acceleration += flockingForce([&grid, this](float radius, auto visit) {
+            grid.forEachNeighbor(position, radius, [&](const NeighborGrid::Entry& other) {
+                visit(other.position, other.velocity);
+            });
+        });
+    } else {
+        sf::Vector2f sep = separate(grid) * 2.0f; // Separation behavior
+        sf::Vector2f ali = align(grid) * 0.9f; // Alignment behavior
+        sf::Vector2f coh = cohere(grid) * 0.8f; // Cohesion behavior
+        acceleration += sep + ali + coh;
+    }
+
+    integrate(deltaTime);
+}
+
+// Integrate function applies the accumulated acceleration and moves the boid
+void FlockBoid::integrate(float deltaTime) {
+    previousPosition = position; // Keep the old state for interpolation
+    previousRotation = sprite.getRotation();
 
     velocity += acceleration; // Update velocity based on acceleration
     velocity = limit(velocity, MAX_SPEED); // Limit velocity to max speed
@@ -28,41 +56,57 @@ void FlockBoid::update(float deltaTime, const std::vector<FlockBoid>& flock) {
     acceleration = sf::Vector2f(0, 0); // Reset acceleration each frame
 
     // Wrap around screen edges
-    if (position.x < 0) position.x = 800;
-    if (position.x > 800) position.x = 0;
-    if (position.y < 0) position.y = 600;
-    if (position.y > 600) position.y = 0;
+    if (position.x < 0) position.x = WORLD_WIDTH;
+    if (position.x > WORLD_WIDTH) position.x = 0;
+    if (position.y < 0) position.y = WORLD_HEIGHT;
+    if (position.y > WORLD_HEIGHT) position.y = 0;
 
     sprite.setPosition(position); // Update sprite position
     sprite.setRotation(atan2(velocity.y, velocity.x) * 180.0f / 3.14159265f); // Update sprite rotation
 }
 
+// Places the sprite between the last two updates
+void FlockBoid::interpolate(float alpha) {
+    // Wrapping around the world is a jump, not motion, so draw the new side straight away
+    if (std::abs(position.x - previousPosition.x) > WORLD_WIDTH / 2 || std::abs(position.y - previousPosition.y) > WORLD_HEIGHT / 2) {
+        alpha = 1.0f;
+    }
+    sprite.setPosition(FixedTimestep::lerp(previousPosition, position, alpha));
+    sprite.setRotation(FixedTimestep::lerpAngle(previousRotation, atan2(velocity.y, velocity.x) * 180.0f / 3.14159265f, alpha));
+}
+
 // Draw function
 void FlockBoid::draw(sf::RenderWindow& window) {
     window.draw(sprite);
 }
 
+// Batched draw function
+void FlockBoid::draw(SpriteBatch& batch) const {
+    batch.addSprite(sprite);
+}
+
 /** OpenAI's ChatGPT was used to suggest implementations for FlockBoid's separate, align, and cohere
  * functionality. The following prompt was used: "Create the methods for a flocking boid that implements
  * separation, alignment, and cohesion behaviors in C++." The code provided by ChatGPT was modified
  * to fit the context of the project.
  */
 // Separation behavior calculates a force to keep boids apart
-sf::Vector2f FlockBoid::separate(const std::vector<FlockBoid>& flock) {
+template <typename ForEachNeighbor>
+sf::Vector2f FlockBoid::separateFrom(ForEachNeighbor forEachNeighbor) {
     sf::Vector2f steer(0, 0);
     int count = 0;
     
-    // Iterate through flock to calculate separation force
-    for (const auto& other : flock) {
-        float dist = hypot(other.position.x - position.x, other.position.y - position.y); // Calculate distance
+    // Iterate through neighbors to calculate separation force
+    forEachNeighbor(SEPARATION_RADIUS, [&](sf::Vector2f otherPosition, sf::Vector2f) {
+        float dist = hypot(otherPosition.x - position.x, otherPosition.y - position.y); // Calculate distance
         if (dist > 0 && dist < SEPARATION_RADIUS) { // If within separation range
-            sf::Vector2f diff = position - other.position; // Vector pointing away from the other boid
+            sf::Vector2f diff = position - otherPosition; // Vector pointing away from the other boid
             float weight = (SEPARATION_RADIUS - dist) / SEPARATION_RADIUS; // Weighted influence
             diff = normalize(diff) * weight; // Apply weighted repulsion
             steer += diff * 3.0f; // Increase separation strength
             count++; // Count the number of boids influencing the separation
         }
-    }
+    });
     
     if (count > 0) steer /= static_cast<float>(count); // Average the steering force 
     if (hypot(steer.x, steer.y) > 0) steer = normalize(steer) * MAX_FORCE; // Limit steering force
@@ -72,18 +116,19 @@ sf::Vector2f FlockBoid::separate(const std::vector<FlockBoid>& flock) {
 }
 
 // Alignment behavior calculates a force to align boids with neighbors
-sf::Vector2f FlockBoid::align(const std::vector<FlockBoid>& flock) {
+template <typename ForEachNeighbor>
+sf::Vector2f FlockBoid::alignFrom(ForEachNeighbor forEachNeighbor) {
     sf::Vector2f avgVelocity(0, 0);
     int count = 0;
     
-    // Iterate through flock to calculate alignment force
-    for (const auto& other : flock) {
-        float dist = hypot(other.position.x - position.x, other.position.y - position.y); // Calculate distance
+    // Iterate through neighbors to calculate alignment force
+    forEachNeighbor(ALIGNMENT_RADIUS, [&](sf::Vector2f otherPosition, sf::Vector2f otherVelocity) {
+        float dist = hypot(otherPosition.x - position.x, otherPosition.y - position.y); // Calculate distance
         if (dist > 0 && dist < ALIGNMENT_RADIUS) { // If within alignment range
-            avgVelocity += other.velocity; // Sum velocities of neighbors
+            avgVelocity += otherVelocity; // Sum velocities of neighbors
             count++; // Count the number of boids influencing the alignment
         }
-    }
+    });
     
     if (count > 0) {
         avgVelocity /= static_cast<float>(count); // Average the velocities
@@ -97,18 +142,19 @@ sf::Vector2f FlockBoid::align(const std::vector<FlockBoid>& flock) {
 }
 
 // Cohesion behavior calculates a force to move boids toward the center of mass
-sf::Vector2f FlockBoid::cohere(const std::vector<FlockBoid>& flock) {
+template <typename ForEachNeighbor>
+sf::Vector2f FlockBoid::cohereFrom(ForEachNeighbor forEachNeighbor) {
     sf::Vector2f centerMass(0, 0);
     int count = 0;
     
-    // Iterate through flock to calculate cohesion force
-    for (const auto& other : flock) {
-        float dist = hypot(other.position.x - position.x, other.position.y - position.y); // Calculate distance
+    // Iterate through neighbors to calculate cohesion force
+    forEachNeighbor(COHESION_RADIUS, [&](sf::Vector2f otherPosition, sf::Vector2f) {
+        float dist = hypot(otherPosition.x - position.x, otherPosition.y - position.y); // Calculate distance
         if (dist > 0 && dist < COHESION_RADIUS) { // If within cohesion range
-            centerMass += other.position; // Sum positions of neighbors
+            centerMass += otherPosition; // Sum positions of neighbors
             count++; // Count the number of boids influencing the cohesion
         }
-    }
+    });
     
     if (count > 0) {
         centerMass /= static_cast<float>(count); // Average the positions
@@ -122,6 +168,88 @@ sf::Vector2f FlockBoid::cohere(const std::vector<FlockBoid>& flock) {
 
 /** End ChatGPT citation */
 
+// Fused kernel gathers all three rules in one pass; see separateFrom, alignFrom and cohereFrom for the rules
+template <typename ForEachNeighbor>
+sf::Vector2f FlockBoid::flockingForce(ForEachNeighbor forEachNeighbor) {
+    constexpr float SEPARATION_RADIUS_SQ = SEPARATION_RADIUS * SEPARATION_RADIUS;
+    constexpr float ALIGNMENT_RADIUS_SQ = ALIGNMENT_RADIUS * ALIGNMENT_RADIUS;
+    constexpr float COHESION_RADIUS_SQ = COHESION_RADIUS * COHESION_RADIUS;
+    constexpr float QUERY_RADIUS = std::max({SEPARATION_RADIUS, ALIGNMENT_RADIUS, COHESION_RADIUS});
+
+    sf::Vector2f separation(0, 0), velocitySum(0, 0), positionSum(0, 0);
+    int separationCount = 0, alignmentCount = 0, cohesionCount = 0;
+
+    forEachNeighbor(QUERY_RADIUS, [&](sf::Vector2f otherPosition, sf::Vector2f otherVelocity) {
+        sf::Vector2f diff = position - otherPosition; // Vector pointing away from the other boid
+        float distSq = diff.x * diff.x + diff.y * diff.y;
+        if (distSq <= 0) return; // Skip self (and boids on exactly the same spot)
+
+        if (distSq < SEPARATION_RADIUS_SQ) {
+            float dist = std::sqrt(distSq);
+            float weight = (SEPARATION_RADIUS - dist) / SEPARATION_RADIUS; // Weighted influence
+            separation += diff * (weight * 3.0f / dist); // Normalized, weighted repulsion
+            separationCount++;
+        }
+        if (distSq < ALIGNMENT_RADIUS_SQ) {
+            velocitySum += otherVelocity;
+            alignmentCount++;
+        }
+        if (distSq < COHESION_RADIUS_SQ) {
+            positionSum += otherPosition;
+            cohesionCount++;
+        }
+    });
+
+    sf::Vector2f force(0, 0);
+
+    // Separation: average, then scale to the maximum force
+    if (separationCount > 0) {
+        separation /= static_cast<float>(separationCount);
+        force += normalize(separation) * MAX_FORCE * 2.0f;
+    }
+
+    // Alignment: steer toward the average neighbor velocity
+    if (alignmentCount > 0) {
+        sf::Vector2f desired = normalize(velocitySum / static_cast<float>(alignmentCount)) * (MAX_SPEED * 0.8f);
+        force += limit(desired - velocity, MAX_FORCE * 0.7f) * 0.9f;
+    }
+
+    // Cohesion: steer toward the neighbors' center of mass
+    if (cohesionCount > 0) {
+        sf::Vector2f centerMass = positionSum / static_cast<float>(cohesionCount);
+        force += normalize(centerMass - position) * (MAX_FORCE * 0.6f) * 0.8f;
+    }
+
+    return force;
+}
+
+// Neighbor sources for the rules: every boid in the flock, or only the boids in nearby grid cells
+namespace {
+    auto allBoids(const std::vector<FlockBoid>& flock) {
+        return [&flock](float, auto visit) {
+            for (const auto& other : flock) {
+                visit(other.getPosition(), other.getVelocity());
+            }
+        };
+    }
+
+    auto gridNeighbors(const NeighborGrid& grid, sf::Vector2f position) {
+        return [&grid, position](float radius, auto visit) {
+            grid.forEachNeighbor(position, radius, [&](const NeighborGrid::Entry& other) {
+                visit(other.position, other.velocity);
+            });
+        };
+    }
+}
+
+sf::Vector2f FlockBoid::separate(const std::vector<FlockBoid>& flock) { return separateFrom(allBoids(flock)); }
+sf::Vector2f FlockBoid::align(const std::vector<FlockBoid>& flock) { return alignFrom(allBoids(flock)); }
+sf::Vector2f FlockBoid::cohere(const std::vector<FlockBoid>& flock) { return cohereFrom(allBoids(flock)); }
+
+sf::Vector2f FlockBoid::separate(const NeighborGrid& grid) { return separateFrom(gridNeighbors(grid, position)); }
+sf::Vector2f FlockBoid::align(const NeighborGrid& grid) { return alignFrom(gridNeighbors(grid, position)); }
+sf::Vector2f FlockBoid::cohere(const NeighborGrid& grid) { return cohereFrom(gridNeighbors(grid, position)); }
+
 // Utility function to limit the magnitude of a vector
 sf::Vector2f FlockBoid::limit(sf::Vector2f vec, float max) {
     float mag = hypot(vec.x, vec.y);
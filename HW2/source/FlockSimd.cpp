@@ -0,0 +1,118 @@
+#include "../headers/FlockSimd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLOCK_SIMD_X86 1
+#endif
+
+#ifdef FLOCK_SIMD_X86
+
+// Runtime check for the AVX2 kernel
+bool FlockSimd::avx2Supported() {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+namespace {
+    // Sum the 8 lanes of a vector
+    __attribute__((target("avx2,fma"))) inline float horizontalSum(__m256 v) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+}
+
+// AVX2 kernel: 8 neighbors per iteration, radius tests as masks
+__attribute__((target("avx2,fma")))
+void FlockSimd::accumulateAvx2(const float* positionX, const float* positionY,
+                               const float* velocityX, const float* velocityY,
+                               int first, int last, float boidX, float boidY,
+                               const FlockRadii& radii, FlockNeighborSums& sums) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    const __m256 separationRadius = _mm256_set1_ps(radii.separation);
+    const __m256 separationScale = _mm256_set1_ps(3.0f / radii.separation);
+    const __m256 separationRadiusSq = _mm256_set1_ps(radii.separationSq);
+    const __m256 alignmentRadiusSq = _mm256_set1_ps(radii.alignmentSq);
+    const __m256 cohesionRadiusSq = _mm256_set1_ps(radii.cohesionSq);
+    const __m256 x = _mm256_set1_ps(boidX);
+    const __m256 y = _mm256_set1_ps(boidY);
+
+    __m256 separationX = zero, separationY = zero, separationCount = zero;
+    __m256 velocitySumX = zero, velocitySumY = zero, alignmentCount = zero;
+    __m256 positionSumX = zero, positionSumY = zero, cohesionCount = zero;
+
+    int j = first;
+    for (; j + 8 <= last; j += 8) {
+        __m256 otherX = _mm256_loadu_ps(positionX + j);
+        __m256 otherY = _mm256_loadu_ps(positionY + j);
+        __m256 dx = _mm256_sub_ps(x, otherX);
+        __m256 dy = _mm256_sub_ps(y, otherY);
+        // No fma here, so distSq rounds like the scalar path and the radius tests agree exactly
+        __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 notSelf = _mm256_cmp_ps(distSq, zero, _CMP_GT_OQ);
+
+        // Separation: weight * 3 / dist, with 1/dist from rsqrt plus one Newton-Raphson step
+        __m256 separationMask = _mm256_and_ps(notSelf, _mm256_cmp_ps(distSq, separationRadiusSq, _CMP_LT_OQ));
+        if (_mm256_movemask_ps(separationMask)) {
+            __m256 inverseDist = _mm256_rsqrt_ps(distSq);
+            inverseDist = _mm256_mul_ps(inverseDist, _mm256_fnmadd_ps(_mm256_mul_ps(half, distSq),
+                                                                      _mm256_mul_ps(inverseDist, inverseDist), threeHalves));
+            __m256 dist = _mm256_mul_ps(distSq, inverseDist);
+            __m256 factor = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(separationRadius, dist), separationScale), inverseDist);
+            factor = _mm256_and_ps(separationMask, factor); // Masked lanes add nothing (and drop inf/nan from self)
+            separationX = _mm256_fmadd_ps(dx, factor, separationX);
+            separationY = _mm256_fmadd_ps(dy, factor, separationY);
+            separationCount = _mm256_add_ps(separationCount, _mm256_and_ps(separationMask, one));
+        }
+
+        // Alignment: masked add of neighbor velocities
+        __m256 alignmentMask = _mm256_and_ps(notSelf, _mm256_cmp_ps(distSq, alignmentRadiusSq, _CMP_LT_OQ));
+        velocitySumX = _mm256_add_ps(velocitySumX, _mm256_and_ps(alignmentMask, _mm256_loadu_ps(velocityX + j)));
+        velocitySumY = _mm256_add_ps(velocitySumY, _mm256_and_ps(alignmentMask, _mm256_loadu_ps(velocityY + j)));
+        alignmentCount = _mm256_add_ps(alignmentCount, _mm256_and_ps(alignmentMask, one));
+
+        // Cohesion: masked add of neighbor positions
+        __m256 cohesionMask = _mm256_and_ps(notSelf, _mm256_cmp_ps(distSq, cohesionRadiusSq, _CMP_LT_OQ));
+        positionSumX = _mm256_add_ps(positionSumX, _mm256_and_ps(cohesionMask, otherX));
+        positionSumY = _mm256_add_ps(positionSumY, _mm256_and_ps(cohesionMask, otherY));
+        cohesionCount = _mm256_add_ps(cohesionCount, _mm256_and_ps(cohesionMask, one));
+    }
+
+    sums.separationX += horizontalSum(separationX);
+    sums.separationY += horizontalSum(separationY);
+    sums.separationCount += static_cast<int>(horizontalSum(separationCount));
+    sums.velocityX += horizontalSum(velocitySumX);
+    sums.velocityY += horizontalSum(velocitySumY);
+    sums.alignmentCount += static_cast<int>(horizontalSum(alignmentCount));
+    sums.positionX += horizontalSum(positionSumX);
+    sums.positionY += horizontalSum(positionSumY);
+    sums.cohesionCount += static_cast<int>(horizontalSum(cohesionCount));
+
+    // Leftover neighbors
+    for (; j < last; j++) {
+        accumulateNeighbor(boidX - positionX[j], boidY - positionY[j], positionX[j], positionY[j],
+                           velocityX[j], velocityY[j], radii, sums);
+    }
+}
+
+#else
+
+// No SIMD kernel on this architecture; FlockSystem stays on the scalar path
+bool FlockSimd::avx2Supported() {
+    return false;
+}
+
+void FlockSimd::accumulateAvx2(const float* positionX, const float* positionY,
+                               const float* velocityX, const float* velocityY,
+                               int first, int last, float boidX, float boidY,
+                               const FlockRadii& radii, FlockNeighborSums& sums) {
+    for (int j = first; j < last; j++) {
+        accumulateNeighbor(boidX - positionX[j], boidY - positionY[j], positionX[j], positionY[j],
+                           velocityX[j], velocityY[j], radii, sums);
+    }
+}
+
+#endif
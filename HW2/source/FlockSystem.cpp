@@ -0,0 +1,246 @@
+#include "../headers/FlockSystem.h"
+#include "../headers/FixedTimestep.h"
+#include <algorithm>
+
+// Constructor
+FlockSystem::FlockSystem(float worldWidth, float worldHeight) : worldWidth(worldWidth), worldHeight(worldHeight) {
+    simdEnabled = FlockSimd::avx2Supported(); // Runtime CPU dispatch
+    columns = std::max(1, static_cast<int>(std::ceil(worldWidth / NEIGHBOR_RADIUS))); // Cells across
+    rows = std::max(1, static_cast<int>(std::ceil(worldHeight / NEIGHBOR_RADIUS))); // Cells down
+    cellStart.assign(columns * rows + 1, 0);
+}
+
+// Add a boid with a random initial velocity at full speed
+int FlockSystem::addBoid(float x, float y) {
+    float vx = (rand() % 200 - 100) / 100.0f;
+    float vy = (rand() % 200 - 100) / 100.0f;
+    float speed = std::sqrt(vx * vx + vy * vy);
+    if (speed > 0) {
+        vx = vx / speed * MAX_SPEED;
+        vy = vy / speed * MAX_SPEED;
+    }
+
+    int id = static_cast<int>(ids.size());
+    positionX.push_back(x);
+    positionY.push_back(y);
+    velocityX.push_back(vx);
+    velocityY.push_back(vy);
+    orientation.push_back(std::atan2(vy, vx) * 180.0f / 3.14159265f);
+    previousX.push_back(x);
+    previousY.push_back(y);
+    previousOrientation.push_back(orientation.back());
+    ids.push_back(id);
+    slotOf.push_back(id);
+    return id;
+}
+
+// Set the number of threads for the per-boid passes
+void FlockSystem::setThreadCount(unsigned threadCount) {
+    workers.reset();
+    if (threadCount != 1) workers.reset(new WorkerPool(threadCount));
+    if (workers && workers->getThreadCount() == 1) workers.reset(); // Only one hardware thread
+}
+
+// Update function runs each stage as a pass over the whole flock
+void FlockSystem::update(float deltaTime) {
+    sortByCell();
+    forceX.resize(size());
+    forceY.resize(size());
+
+    // Forces read the previous state only; integration waits until every force is done
+    forEachRange([this](size_t begin, size_t end) { computeForces(begin, end); });
+    forEachRange([this, deltaTime](size_t begin, size_t end) {
+        integrate(begin, end, deltaTime);
+        computeOrientations(begin, end);
+    });
+}
+
+// Run a pass over all slots, on the worker threads if there are any
+void FlockSystem::forEachRange(const std::function<void(size_t, size_t)>& pass) {
+    if (workers) workers->parallelFor(size(), pass);
+    else pass(0, size());
+}
+
+// Sort every boid array by grid cell so neighbors are contiguous (counting sort)
+void FlockSystem::sortByCell() {
+    size_t count = size();
+    cellOfSlot.resize(count);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+
+    // Count boids per cell
+    for (size_t i = 0; i < count; i++) {
+        cellOfSlot[i] = rowOf(positionY[i]) * columns + columnOf(positionX[i]);
+        cellStart[cellOfSlot[i] + 1]++;
+    }
+
+    // Prefix sum gives the first slot of each cell
+    for (size_t cell = 1; cell < cellStart.size(); cell++) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    // Destination slot of every boid (stable within a cell)
+    std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+    std::vector<int> destination(count);
+    for (size_t i = 0; i < count; i++) {
+        destination[i] = next[cellOfSlot[i]]++;
+    }
+
+    // Scatter each array into sorted order
+    scratch.resize(count);
+    for (std::vector<float>* array : {&positionX, &positionY, &velocityX, &velocityY, &orientation}) {
+        for (size_t i = 0; i < count; i++) {
+            scratch[destination[i]] = (*array)[i];
+        }
+        array->swap(scratch);
+    }
+
+    scratchIds.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        scratchIds[destination[i]] = ids[i];
+    }
+    ids.swap(scratchIds);
+    for (size_t i = 0; i < count; i++) {
+        slotOf[ids[i]] = static_cast<int>(i);
+    }
+}
+
+// Fused flocking kernel, same rules and weights as FlockBoid::flockingForce
+void FlockSystem::computeForces(size_t begin, size_t end) {
+    const FlockRadii radii = {SEPARATION_RADIUS, SEPARATION_RADIUS * SEPARATION_RADIUS,
+                              ALIGNMENT_RADIUS * ALIGNMENT_RADIUS, COHESION_RADIUS * COHESION_RADIUS};
+
+    for (size_t i = begin; i < end; i++) {
+        float px = positionX[i], py = positionY[i];
+        FlockNeighborSums sums;
+
+        int minColumn = columnOf(px - NEIGHBOR_RADIUS), maxColumn = columnOf(px + NEIGHBOR_RADIUS);
+        int minRow = rowOf(py - NEIGHBOR_RADIUS), maxRow = rowOf(py + NEIGHBOR_RADIUS);
+        for (int row = minRow; row <= maxRow; row++) {
+            // Cells in a row are adjacent, so their boids form one contiguous slot range
+            int first = cellStart[row * columns + minColumn];
+            int last = cellStart[row * columns + maxColumn + 1];
+            if (simdEnabled) {
+                FlockSimd::accumulateAvx2(positionX.data(), positionY.data(), velocityX.data(), velocityY.data(),
+                                          first, last, px, py, radii, sums);
+            } else {
+                for (int j = first; j < last; j++) {
+                    FlockSimd::accumulateNeighbor(px - positionX[j], py - positionY[j], positionX[j], positionY[j],
+                                                  velocityX[j], velocityY[j], radii, sums);
+                }
+            }
+        }
+
+        applyNeighborSums(i, sums);
+    }
+}
+
+// Turn neighbor sums into the weighted sum of separation, alignment and cohesion
+void FlockSystem::applyNeighborSums(size_t i, const FlockNeighborSums& sums) {
+    float px = positionX[i], py = positionY[i];
+    float fx = 0, fy = 0;
+
+    // Separation: direction of the summed repulsion (averaging would not change it), at full force
+    if (sums.separationCount > 0) {
+        float length = std::sqrt(sums.separationX * sums.separationX + sums.separationY * sums.separationY);
+        if (length > 0) {
+            fx += sums.separationX / length * MAX_FORCE * 2.0f;
+            fy += sums.separationY / length * MAX_FORCE * 2.0f;
+        }
+    }
+
+    // Alignment: steer toward the average neighbor velocity, limited
+    if (sums.alignmentCount > 0) {
+        float length = std::sqrt(sums.velocityX * sums.velocityX + sums.velocityY * sums.velocityY);
+        float desiredX = (length > 0) ? sums.velocityX / length * (MAX_SPEED * 0.8f) : 0;
+        float desiredY = (length > 0) ? sums.velocityY / length * (MAX_SPEED * 0.8f) : 0;
+        float steerX = desiredX - velocityX[i];
+        float steerY = desiredY - velocityY[i];
+        float steerLength = std::sqrt(steerX * steerX + steerY * steerY);
+        if (steerLength > MAX_FORCE * 0.7f) {
+            steerX = steerX / steerLength * (MAX_FORCE * 0.7f);
+            steerY = steerY / steerLength * (MAX_FORCE * 0.7f);
+        }
+        fx += steerX * 0.9f;
+        fy += steerY * 0.9f;
+    }
+
+    // Cohesion: steer toward the neighbors' center of mass
+    if (sums.cohesionCount > 0) {
+        float toCenterX = sums.positionX / sums.cohesionCount - px;
+        float toCenterY = sums.positionY / sums.cohesionCount - py;
+        float length = std::sqrt(toCenterX * toCenterX + toCenterY * toCenterY);
+        if (length > 0) {
+            fx += toCenterX / length * (MAX_FORCE * 0.6f) * 0.8f;
+            fy += toCenterY / length * (MAX_FORCE * 0.6f) * 0.8f;
+        }
+    }
+
+    forceX[i] = fx;
+    forceY[i] = fy;
+}
+
+// Integrate velocities and positions, then wrap around the world edges
+void FlockSystem::integrate(size_t begin, size_t end, float deltaTime) {
+    for (size_t i = begin; i < end; i++) {
+        float vx = velocityX[i] + forceX[i];
+        float vy = velocityY[i] + forceY[i];
+        float speed = std::sqrt(vx * vx + vy * vy);
+        if (speed > MAX_SPEED) {
+            vx = vx / speed * MAX_SPEED;
+            vy = vy / speed * MAX_SPEED;
+        }
+        velocityX[i] = vx;
+        velocityY[i] = vy;
+
+        // Slots are already sorted for this update, so the old state stays next to the new one
+        previousX[i] = positionX[i];
+        previousY[i] = positionY[i];
+        float px = positionX[i] + vx * deltaTime;
+        float py = positionY[i] + vy * deltaTime;
+        if (px < 0) px = worldWidth;
+        if (px > worldWidth) px = 0;
+        if (py < 0) py = worldHeight;
+        if (py > worldHeight) py = 0;
+        positionX[i] = px;
+        positionY[i] = py;
+    }
+}
+
+// Orientation follows the velocity
+void FlockSystem::computeOrientations(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        previousOrientation[i] = orientation[i];
+        orientation[i] = std::atan2(velocityY[i], velocityX[i]) * 180.0f / 3.14159265f;
+    }
+}
+
+// Write one rotated, textured quad per boid
+void FlockSystem::buildVertices(sf::VertexArray& vertices, const sf::Texture& texture, float scale, float alpha) const {
+    sf::Vector2f textureSize(static_cast<float>(texture.getSize().x), static_cast<float>(texture.getSize().y));
+    float halfWidth = textureSize.x * scale / 2.0f;
+    float halfHeight = textureSize.y * scale / 2.0f;
+    const sf::Vector2f corners[4] = {{-halfWidth, -halfHeight}, {halfWidth, -halfHeight}, {halfWidth, halfHeight}, {-halfWidth, halfHeight}};
+    const sf::Vector2f texCoords[4] = {{0, 0}, {textureSize.x, 0}, {textureSize.x, textureSize.y}, {0, textureSize.y}};
+
+    vertices.setPrimitiveType(sf::Quads);
+    vertices.resize(size() * 4);
+    for (size_t i = 0; i < size(); i++) {
+        // Blend the last two states; a wrap around the world is drawn on the new side straight away
+        float x = positionX[i], y = positionY[i], angle = orientation[i];
+        if (alpha < 1.0f && std::abs(x - previousX[i]) < worldWidth / 2 && std::abs(y - previousY[i]) < worldHeight / 2) {
+            x = previousX[i] + (x - previousX[i]) * alpha;
+            y = previousY[i] + (y - previousY[i]) * alpha;
+            angle = FixedTimestep::lerpAngle(previousOrientation[i], angle, alpha);
+        }
+
+        float radians = angle * 3.14159265f / 180.0f;
+        float cosine = std::cos(radians), sine = std::sin(radians);
+        for (int corner = 0; corner < 4; corner++) {
+            sf::Vertex& vertex = vertices[i * 4 + corner];
+            vertex.position = sf::Vector2f(x + corners[corner].x * cosine - corners[corner].y * sine,
+                                           y + corners[corner].x * sine + corners[corner].y * cosine);
+            vertex.texCoords = texCoords[corner];
+            vertex.color = sf::Color::White;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#include "../headers/HeadlessRunner.h"
+#include <chrono>
+
+// Constructor
+HeadlessRunner::HeadlessRunner(float step) : timestep(step), verbose(false) {
+    timestep.setUncapped(true); // No frame clock; every tick is one step
+}
+
+// Run the tick function back to back and time it
+HeadlessStats HeadlessRunner::run(long long ticks, const std::function<void(float)>& tick) {
+    std::ios::iostate coutState = std::cout.rdstate();
+    if (!verbose) std::cout.setstate(std::ios::failbit); // Failed streams skip formatting
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < ticks; i++) {
+        timestep.advance(0);
+        tick(timestep.getStep());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout.clear(coutState);
+
+    HeadlessStats stats;
+    stats.ticks = ticks;
+    stats.seconds = std::chrono::duration<double>(end - start).count();
+    stats.step = timestep.getStep();
+    return stats;
+}
+
+// Print a one-line summary
+void HeadlessRunner::report(std::ostream& out, const std::string& name, size_t agents, const HeadlessStats& stats) {
+    out << name << ": " << agents << " agents, " << stats.ticks << " ticks in " << stats.seconds << " s ("
+        << stats.ticksPerSecond() << " ticks/s, " << stats.realTimeFactor() << "x real time)" << std::endl;
+}
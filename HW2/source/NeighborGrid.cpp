@@ -0,0 +1,34 @@
+#include "../headers/NeighborGrid.h"
+#include "../headers/FlockBoid.h"
+
+// Constructor
+NeighborGrid::NeighborGrid(float width, float height, float cellSize) : cellSize(cellSize) {
+    columns = std::max(1, static_cast<int>(std::ceil(width / cellSize))); // Cells across
+    rows = std::max(1, static_cast<int>(std::ceil(height / cellSize))); // Cells down
+    cellStart.assign(columns * rows + 1, 0);
+}
+
+// Build function sorts a snapshot of the flock into cells (counting sort)
+void NeighborGrid::build(const std::vector<FlockBoid>& flock) {
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    std::vector<int> cellOf(flock.size());
+
+    // Count boids per cell
+    for (size_t i = 0; i < flock.size(); i++) {
+        sf::Vector2f position = flock[i].getPosition();
+        cellOf[i] = rowOf(position.y) * columns + columnOf(position.x);
+        cellStart[cellOf[i] + 1]++;
+    }
+
+    // Prefix sum gives the start of each cell
+    for (size_t cell = 1; cell < cellStart.size(); cell++) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    // Scatter boids into their cells
+    entries.resize(flock.size());
+    std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < flock.size(); i++) {
+        entries[next[cellOf[i]]++] = {flock[i].getPosition(), flock[i].getVelocity(), static_cast<int>(i)};
+    }
+}
@@ -0,0 +1,109 @@
+#include "../headers/SpriteBatch.h"
+#include <cmath>
+#include <array>
+
+// Clear all arrays (sf::VertexArray::clear keeps its capacity)
+void SpriteBatch::clear() {
+    for (auto& layer : layers) {
+        layer.second.clear();
+    }
+    dots.clear();
+    lines.clear();
+}
+
+// Find or add the quad array of a texture
+sf::VertexArray& SpriteBatch::layerFor(const sf::Texture* texture) {
+    for (auto& layer : layers) {
+        if (layer.first == texture) return layer.second;
+    }
+    layers.emplace_back(texture, sf::VertexArray(sf::Quads));
+    return layers.back().second;
+}
+
+// Add a sprite as a quad, transformed the same way sf::Sprite draws itself
+void SpriteBatch::addSprite(const sf::Sprite& sprite) {
+    const sf::Texture* texture = sprite.getTexture();
+    if (!texture) return;
+
+    const sf::Transform& transform = sprite.getTransform();
+    sf::IntRect rect = sprite.getTextureRect();
+    float width = static_cast<float>(std::abs(rect.width));
+    float height = static_cast<float>(std::abs(rect.height));
+    float left = static_cast<float>(rect.left);
+    float top = static_cast<float>(rect.top);
+    float right = left + rect.width;
+    float bottom = top + rect.height;
+
+    sf::VertexArray& quads = layerFor(texture);
+    quads.append(sf::Vertex(transform.transformPoint(0, 0), sprite.getColor(), sf::Vector2f(left, top)));
+    quads.append(sf::Vertex(transform.transformPoint(width, 0), sprite.getColor(), sf::Vector2f(right, top)));
+    quads.append(sf::Vertex(transform.transformPoint(width, height), sprite.getColor(), sf::Vector2f(right, bottom)));
+    quads.append(sf::Vertex(transform.transformPoint(0, height), sprite.getColor(), sf::Vector2f(left, bottom)));
+}
+
+// Add a circle shape as a dot; its local center is (radius, radius)
+void SpriteBatch::addCircle(const sf::CircleShape& shape) {
+    float radius = shape.getRadius();
+    sf::Vector2f center = shape.getTransform().transformPoint(radius, radius);
+    sf::Vector2f scale = shape.getScale();
+    addDot(center, radius * std::sqrt(std::abs(scale.x * scale.y)), shape.getFillColor());
+}
+
+// Unit circle points of a dot, computed once
+static const std::array<sf::Vector2f, SpriteBatch::DOT_SEGMENTS + 1>& dotOutline() {
+    static const std::array<sf::Vector2f, SpriteBatch::DOT_SEGMENTS + 1> outline = [] {
+        std::array<sf::Vector2f, SpriteBatch::DOT_SEGMENTS + 1> points;
+        for (int segment = 0; segment <= SpriteBatch::DOT_SEGMENTS; segment++) {
+            float angle = segment * 2.0f * 3.14159265f / SpriteBatch::DOT_SEGMENTS;
+            points[segment] = sf::Vector2f(std::cos(angle), std::sin(angle));
+        }
+        return points;
+    }();
+    return outline;
+}
+
+// Add a dot as a fan of triangles around its center
+void SpriteBatch::addDot(sf::Vector2f center, float radius, sf::Color color) {
+    const auto& outline = dotOutline();
+    sf::Vector2f previous = center + outline[0] * radius;
+    for (int segment = 1; segment <= DOT_SEGMENTS; segment++) {
+        sf::Vector2f next = center + outline[segment] * radius;
+        dots.append(sf::Vertex(center, color));
+        dots.append(sf::Vertex(previous, color));
+        dots.append(sf::Vertex(next, color));
+        previous = next;
+    }
+}
+
+// Add a line segment
+void SpriteBatch::addLine(sf::Vector2f from, sf::Vector2f to, sf::Color color) {
+    lines.append(sf::Vertex(from, color));
+    lines.append(sf::Vertex(to, color));
+}
+
+// Draw lines, dots, then every texture's quads
+void SpriteBatch::draw(sf::RenderTarget& target) const {
+    if (lines.getVertexCount() > 0) target.draw(lines);
+    if (dots.getVertexCount() > 0) target.draw(dots);
+    for (const auto& layer : layers) {
+        if (layer.second.getVertexCount() > 0) target.draw(layer.second, layer.first);
+    }
+}
+
+// Count the non-empty arrays
+size_t SpriteBatch::getDrawCallCount() const {
+    size_t count = (lines.getVertexCount() > 0) + (dots.getVertexCount() > 0);
+    for (const auto& layer : layers) {
+        count += layer.second.getVertexCount() > 0;
+    }
+    return count;
+}
+
+// Total vertices across all arrays
+size_t SpriteBatch::getVertexCount() const {
+    size_t count = lines.getVertexCount() + dots.getVertexCount();
+    for (const auto& layer : layers) {
+        count += layer.second.getVertexCount();
+    }
+    return count;
+}
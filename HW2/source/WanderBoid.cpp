@@ -1,25 +1,16 @@
 #include "../headers/WanderBoid.h"
+#include "../headers/FixedTimestep.h"
 #include <cmath>
 
-// Breadcrumb class constructor
-Crumb::Crumb(sf::Vector2f pos) {
-    shape.setRadius(3.0f); // Set radius for the crumb
-    shape.setFillColor(sf::Color::Blue); // Set color for the crumb
-    shape.setPosition(pos); // Set position for the crumb
-}
-
-// Draws the crumb
-void Crumb::draw(sf::RenderWindow& window) const {
-    window.draw(shape);
-}
-
 // WanderBoid constructor
-WanderBoid::WanderBoid(sf::RenderWindow* w, sf::Texture& tex, std::vector<Crumb>* crumbs)
-    : window(w), breadcrumbs(crumbs), rng(rd()), angleChangeDist(-WANDER_ANGLE_SMOOTHING, WANDER_ANGLE_SMOOTHING) {
+WanderBoid::WanderBoid(sf::RenderWindow* w, sf::Texture& tex, BreadcrumbTrails* crumbs, size_t trail)
+    : window(w), breadcrumbs(crumbs), trail(trail), rng(rd()), angleChangeDist(-WANDER_ANGLE_SMOOTHING, WANDER_ANGLE_SMOOTHING) {
     position = {WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2}; // Initialize position
     velocity = {MAX_SPEED, 0}; // Initialize velocity
     wanderAngle = 0; // Initialize wander angle
     orientation = 0; // Initialize orientation
+    previousPosition = position; // Nothing to interpolate from yet
+    previousOrientation = orientation;
     sprite.setTexture(tex); // Set texture for the sprite
     sprite.setScale(0.1f, 0.1f); // Set scale for the sprite
     sprite.setOrigin(tex.getSize().x / 2, tex.getSize().y / 2); // Set origin for the sprite
@@ -28,16 +19,33 @@ WanderBoid::WanderBoid(sf::RenderWindow* w, sf::Texture& tex, std::vector<Crumb>
 
 // Updates the boid's position and state
 void WanderBoid::update(float deltaTime) {
+    previousPosition = position; // Keep the old state for interpolation
+    previousOrientation = orientation;
     applyWander(deltaTime); // Apply wander behavior
     handleBoundaries(); // Handle screen boundaries
     dropBreadcrumbs(); // Drop breadcrumbs
 }
 
+// Places the sprite between the last two updates
+void WanderBoid::interpolate(float alpha) {
+    // Wrapping across the window is a jump, not motion, so draw the new side straight away
+    if (std::abs(position.x - previousPosition.x) > WINDOW_WIDTH / 2 || std::abs(position.y - previousPosition.y) > WINDOW_HEIGHT / 2) {
+        alpha = 1.0f;
+    }
+    sprite.setPosition(FixedTimestep::lerp(previousPosition, position, alpha));
+    sprite.setRotation(FixedTimestep::lerpAngle(previousOrientation, orientation, alpha));
+}
+
 // Draws the boid
 void WanderBoid::draw() {
     window->draw(sprite);
 }
 
+// Adds the boid to a batch
+void WanderBoid::draw(SpriteBatch& batch) const {
+    batch.addSprite(sprite);
+}
+
 // Applies the wander behavior to determine the boid's movement direction
 void WanderBoid::applyWander(float deltaTime) {
     // Calculate the center of the wander circle ahead of the boid
@@ -83,11 +91,8 @@ void WanderBoid::handleBoundaries() {
 void WanderBoid::dropBreadcrumbs() {
     static int dropTimer = BREADCRUMB_INTERVAL;
     if (--dropTimer <= 0) {
-        breadcrumbs->push_back(Crumb(position)); // Drop a breadcrumb at the current position
+        breadcrumbs->push(trail, position); // Drop a breadcrumb; the trail drops its oldest once full
         dropTimer = BREADCRUMB_INTERVAL;
-        if (breadcrumbs->size() > BREADCRUMB_LIMIT) {
-            breadcrumbs->erase(breadcrumbs->begin()); // Remove the oldest breadcrumb if limit exceeded
-        }
     }
 }
 
@@ -0,0 +1,80 @@
+#include "../headers/WorkerPool.h"
+#include <algorithm>
+
+// Constructor
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned thread = 1; thread < threadCount; thread++) {
+        workers.emplace_back(&WorkerPool::run, this, thread);
+    }
+}
+
+// Destructor
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Run one contiguous range per thread and wait for all of them
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& body) {
+    if (workers.empty() || count < 2) {
+        if (count > 0) body(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->body = &body;
+        this->count = count;
+        pending = static_cast<unsigned>(workers.size());
+        generation++;
+    }
+    jobReady.notify_all();
+
+    // The caller takes the first range
+    size_t begin, end;
+    rangeOf(0, begin, end);
+    if (begin < end) body(begin, end);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this] { return pending == 0; });
+    this->body = nullptr;
+}
+
+// Ranges depend only on the index count and the thread count
+void WorkerPool::rangeOf(unsigned thread, size_t& begin, size_t& end) const {
+    size_t threads = workers.size() + 1;
+    begin = count * thread / threads;
+    end = count * (thread + 1) / threads;
+}
+
+// Worker loop
+void WorkerPool::run(unsigned thread) {
+    unsigned seen = 0;
+    while (true) {
+        size_t begin, end;
+        const std::function<void(size_t, size_t)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            job = body;
+            rangeOf(thread, begin, end);
+        }
+
+        if (begin < end) (*job)(begin, end);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        jobDone.notify_one();
+    }
+}
@@ -52,6 +52,17 @@
       * @return A SteeringData object containing linear acceleration to arrive at the target.
       */       
      SteeringData calculateAcceleration(const Kinematic& character, const Kinematic& target) override;
+
+     /**
+      * @brief Calculates the linear accelerations of many characters, 4 at a time.
+      * @param characters Array of count entities performing the behavior.
+      * @param targets Array of count targets; targets[i] belongs to characters[i].
+      * @param results Array of count results to write.
+      * @param count Number of characters.
+      * @note Gives the same results as calling calculateAcceleration for each character.
+      */
+     void calculateAccelerations(const Kinematic* characters, const Kinematic* targets,
+                                 SteeringData* results, size_t count) override;
  };
  
  #endif // ARRIVE_H
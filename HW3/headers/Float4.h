@@ -0,0 +1,148 @@
+/**
+ * @file Float4.h
+ * @brief Defines Float4 and Mask4, a small 4-lane float vector used by the batch steering kernels.
+ *
+ * Resources Used:
+ * - Intel Intrinsics Guide: https://www.intel.com/content/www/us/en/docs/intrinsics-guide/
+ * - Arm NEON Intrinsics Reference: https://developer.arm.com/architectures/instruction-sets/intrinsics/
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef FLOAT4_H
+#define FLOAT4_H
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FLOAT4_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FLOAT4_NEON 1
+#endif
+
+#if defined(FLOAT4_SSE) || defined(FLOAT4_NEON)
+#define FLOAT4_SIMD 1 // Lanes map to real vector registers
+#endif
+
+/**
+ * @struct Mask4
+ * @brief Result of a lane-wise comparison; each lane is all ones (true) or all zeros (false).
+ */
+struct Mask4 {
+#if defined(FLOAT4_SSE)
+    __m128 v;
+#elif defined(FLOAT4_NEON)
+    uint32x4_t v;
+#else
+    bool v[4];
+#endif
+};
+
+/**
+ * @struct Float4
+ * @brief Four floats processed together.
+ *
+ * Uses SSE2 on x86-64 and NEON on 64-bit ARM, which both CPUs always have, so no compiler
+ * flags are needed; other targets fall back to plain loops. Add, subtract, multiply, divide
+ * and square root are IEEE operations in every version, so each lane gives the same result
+ * as the scalar code doing the same operations in the same order.
+ */
+struct Float4 {
+#if defined(FLOAT4_SSE)
+    __m128 v;
+#elif defined(FLOAT4_NEON)
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+
+    /**
+     * @brief Loads 4 floats from memory.
+     */
+    static Float4 load(const float* p) {
+        Float4 r;
+#if defined(FLOAT4_SSE)
+        r.v = _mm_loadu_ps(p);
+#elif defined(FLOAT4_NEON)
+        r.v = vld1q_f32(p);
+#else
+        for (int i = 0; i < 4; i++) r.v[i] = p[i];
+#endif
+        return r;
+    }
+
+    /**
+     * @brief Sets all 4 lanes to the same value.
+     */
+    static Float4 splat(float x) {
+        Float4 r;
+#if defined(FLOAT4_SSE)
+        r.v = _mm_set1_ps(x);
+#elif defined(FLOAT4_NEON)
+        r.v = vdupq_n_f32(x);
+#else
+        for (int i = 0; i < 4; i++) r.v[i] = x;
+#endif
+        return r;
+    }
+
+    /**
+     * @brief Stores the 4 lanes to memory.
+     */
+    void store(float* p) const {
+#if defined(FLOAT4_SSE)
+        _mm_storeu_ps(p, v);
+#elif defined(FLOAT4_NEON)
+        vst1q_f32(p, v);
+#else
+        for (int i = 0; i < 4; i++) p[i] = v[i];
+#endif
+    }
+};
+
+#if defined(FLOAT4_SSE)
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float4 operator/(Float4 a, Float4 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Float4 sqrt(Float4 a) { return {_mm_sqrt_ps(a.v)}; }
+inline Float4 max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Float4 abs(Float4 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+inline Mask4 operator<(Float4 a, Float4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline Mask4 operator>(Float4 a, Float4 b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+inline Mask4 operator&(Mask4 a, Mask4 b) { return {_mm_and_ps(a.v, b.v)}; }
+inline Float4 select(Mask4 m, Float4 a, Float4 b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+#elif defined(FLOAT4_NEON)
+inline Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 operator/(Float4 a, Float4 b) { return {vdivq_f32(a.v, b.v)}; }
+inline Float4 sqrt(Float4 a) { return {vsqrtq_f32(a.v)}; }
+inline Float4 max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Float4 abs(Float4 a) { return {vabsq_f32(a.v)}; }
+inline Mask4 operator<(Float4 a, Float4 b) { return {vcltq_f32(a.v, b.v)}; }
+inline Mask4 operator>(Float4 a, Float4 b) { return {vcgtq_f32(a.v, b.v)}; }
+inline Mask4 operator&(Mask4 a, Mask4 b) { return {vandq_u32(a.v, b.v)}; }
+inline Float4 select(Mask4 m, Float4 a, Float4 b) { return {vbslq_f32(m.v, a.v, b.v)}; }
+#else
+#define FLOAT4_LANEWISE(expr) Float4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+#define MASK4_LANEWISE(expr) Mask4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+inline Float4 operator+(Float4 a, Float4 b) { FLOAT4_LANEWISE(a.v[i] + b.v[i]); }
+inline Float4 operator-(Float4 a, Float4 b) { FLOAT4_LANEWISE(a.v[i] - b.v[i]); }
+inline Float4 operator*(Float4 a, Float4 b) { FLOAT4_LANEWISE(a.v[i] * b.v[i]); }
+inline Float4 operator/(Float4 a, Float4 b) { FLOAT4_LANEWISE(a.v[i] / b.v[i]); }
+inline Float4 sqrt(Float4 a) { FLOAT4_LANEWISE(std::sqrt(a.v[i])); }
+inline Float4 max(Float4 a, Float4 b) { FLOAT4_LANEWISE(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+inline Float4 abs(Float4 a) { FLOAT4_LANEWISE(std::abs(a.v[i])); }
+inline Mask4 operator<(Float4 a, Float4 b) { MASK4_LANEWISE(a.v[i] < b.v[i]); }
+inline Mask4 operator>(Float4 a, Float4 b) { MASK4_LANEWISE(a.v[i] > b.v[i]); }
+inline Mask4 operator&(Mask4 a, Mask4 b) { MASK4_LANEWISE(a.v[i] && b.v[i]); }
+inline Float4 select(Mask4 m, Float4 a, Float4 b) { FLOAT4_LANEWISE(m.v[i] ? a.v[i] : b.v[i]); }
+#undef FLOAT4_LANEWISE
+#undef MASK4_LANEWISE
+#endif
+
+#endif // FLOAT4_H
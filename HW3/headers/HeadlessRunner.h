@@ -0,0 +1,119 @@
+/**
+ * @file HeadlessRunner.h
+ * @brief Defines the HeadlessRunner class, which steps a simulation without a window and times it.
+ *
+ * Resources Used:
+ * - cppreference, std::chrono: https://en.cppreference.com/w/cpp/chrono
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include "headers/FixedTimestep.h"
+
+/**
+ * @struct HeadlessStats
+ * @brief Timing of one headless run.
+ */
+struct HeadlessStats
+{
+    long long ticks = 0; // Simulation steps run
+    double seconds = 0;  // Wall-clock time of the run
+    float step = 0;      // Simulated seconds per tick
+
+    /**
+     * @brief Get the simulation steps run per wall-clock second.
+     */
+    double ticksPerSecond() const { return seconds > 0 ? ticks / seconds : 0; }
+
+    /**
+     * @brief Get how many times faster than real time the simulation ran.
+     */
+    double realTimeFactor() const { return ticksPerSecond() * step; }
+};
+
+/**
+ * @class HeadlessRunner
+ * @brief Runs a tick function a fixed number of times, back to back, with no window or draw calls.
+ *
+ * Every tick gets the fixed step as its delta time, so a headless run simulates the same thing
+ * as the windowed demo, only as fast as the CPU allows. Agents log to std::cout, so it is muted
+ * during the run unless verbose is set.
+ */
+class HeadlessRunner
+{
+public:
+    /**
+     * @brief Constructor to set the simulation step.
+     * @param step Delta time passed to every tick.
+     */
+    explicit HeadlessRunner(float step = 1.0f / 60.0f)
+        : timestep(step),
+          verbose(false)
+    {
+        timestep.setUncapped(true); // No frame clock; every tick is one step
+    }
+
+    /**
+     * @brief Run the simulation.
+     * @param ticks Number of steps to run.
+     * @param tick Called once per step with the step as delta time.
+     * @return Ticks run and wall-clock time.
+     */
+    HeadlessStats run(long long ticks, const std::function<void(float)> &tick)
+    {
+        std::ios::iostate coutState = std::cout.rdstate();
+        if (!verbose)
+        {
+            std::cout.setstate(std::ios::failbit); // Failed streams skip formatting
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < ticks; i++)
+        {
+            timestep.advance(0);
+            tick(timestep.getStep());
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout.clear(coutState);
+
+        HeadlessStats stats;
+        stats.ticks = ticks;
+        stats.seconds = std::chrono::duration<double>(end - start).count();
+        stats.step = timestep.getStep();
+        return stats;
+    }
+
+    /**
+     * @brief Keep or mute std::cout during runs (muted by default).
+     * @param enabled True to keep agent logging.
+     */
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    /**
+     * @brief Print one line summarizing a run.
+     * @param out Stream to print to.
+     * @param name Name of the simulation.
+     * @param agents Number of agents simulated.
+     * @param stats Result of run.
+     */
+    static void report(std::ostream &out, const std::string &name, size_t agents, const HeadlessStats &stats)
+    {
+        out << name << ": " << agents << " agents, " << stats.ticks << " ticks in " << stats.seconds << " s ("
+            << stats.ticksPerSecond() << " ticks/s, " << stats.realTimeFactor() << "x real time)" << std::endl;
+    }
+
+private:
+    FixedTimestep timestep; // Uncapped, one step per tick
+    bool verbose;           // Keep std::cout during runs
+};
+
+#endif // HEADLESS_RUNNER_H
@@ -16,42 +16,12 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <deque>
 #include "headers/Arrive.h"
 #include "headers/Align.h"
 #include "headers/Kinematic.h"
-
-/**
- * @class Breadcrumb
- * @brief Visual representation of past positions for tracking movement.
- */
-class Breadcrumb
-{
-public:
-    /**
-     * @brief Constructor for a breadcrumb at the given position.
-     * @param pos Position of the breadcrumb.
-     */
-    Breadcrumb(sf::Vector2f pos)
-    {
-        shape.setRadius(3.0f);
-        shape.setFillColor(sf::Color::Blue);
-        shape.setPosition(pos);
-        shape.setOrigin(3.0f, 3.0f);
-    }
-
-    /**
-     * @brief Draw the breadcrumb on the window.
-     * @param window The window to draw to.
-     */
-    void draw(sf::RenderWindow &window) const
-    {
-        window.draw(shape);
-    }
-
-private:
-    sf::CircleShape shape;
-};
+#include "headers/SpriteBatch.h"
+#include "headers/BreadcrumbTrails.h"
+#include "headers/FixedTimestep.h"
 
 /**
  * @class PathFollower
@@ -68,6 +38,7 @@ public:
     PathFollower(sf::Vector2f startPosition, sf::Texture &texture)
         : arriveBehavior(250.0f, 175.0f, 5.0f, 120.0f, 0.2f),
           alignBehavior(15.0f, 200.0f, 1.0f, 40.0f, 0.05f),
+          breadcrumbs(1, MAX_BREADCRUMBS),
           breadcrumbCounter(0),
           currentWaypoint(0)
     {
@@ -89,6 +60,10 @@ public:
         sprite.setScale(0.05f, 0.05f);
         sprite.setOrigin(texture.getSize().x / 2, texture.getSize().y / 2);
         sprite.setPosition(startPosition);
+
+        // Nothing to interpolate from yet
+        previousPosition = startPosition;
+        previousOrientation = 0;
     }
 
     /**
@@ -112,7 +87,7 @@ public:
         }
 
         // Clear breadcrumbs
-        breadcrumbs.clear();
+        breadcrumbs.clear(0);
     }
 
     /**
@@ -124,6 +99,7 @@ public:
         character.position = position;
         character.velocity = {0, 0};
         sprite.setPosition(position);
+        previousPosition = position; // Teleport, so don't interpolate across it
 
         // Reset target and path
         target.position = position;
@@ -131,7 +107,7 @@ public:
         currentWaypoint = 0;
 
         // Clear breadcrumbs
-        breadcrumbs.clear();
+        breadcrumbs.clear(0);
     }
 
     /**
@@ -140,77 +116,65 @@ public:
      */
     void update(float deltaTime)
     {
-        // If no path or at the end of the path, don't move
-        if (path.empty() || currentWaypoint >= path.size())
+        savePreviousState();
+        if (!updateTarget())
         {
-            // Stop moving when we've reached the final waypoint
-            character.velocity = {0, 0};
-            character.rotation = 0;
             return;
         }
 
-        // Target is the current waypoint we're moving toward
-        target.position = path[currentWaypoint];
-
-        // Calculate desired orientation based on direction to target
-        sf::Vector2f dirToTarget = target.position - character.position;
-        float distToTarget = std::sqrt(dirToTarget.x * dirToTarget.x + dirToTarget.y * dirToTarget.y);
-
-        if (distToTarget > 0.1f)
-        {
-            // Normalize direction vector
-            dirToTarget /= distToTarget;
-            float desiredOrientation = std::atan2(dirToTarget.y, dirToTarget.x) * (180.0f / 3.14159265f);
-            target.orientation = desiredOrientation;
-        }
-
-        // Apply Arrive behavior to navigate to current waypoint
+        // Apply Arrive and Align behaviors (Align only reads orientation and rotation, which Arrive does not change)
         SteeringData arriveAcceleration = arriveBehavior.calculateAcceleration(character, target);
-        character.velocity += arriveAcceleration.linear * deltaTime;
+        SteeringData alignAcceleration = alignBehavior.calculateAcceleration(character, target);
+        applySteering(arriveAcceleration, alignAcceleration, deltaTime);
+    }
 
-        // Limit velocity to max speed if needed
-        float currentSpeed = std::sqrt(character.velocity.x * character.velocity.x +
-                                       character.velocity.y * character.velocity.y);
-        const float MAX_SPEED = 175.0f;
-        if (currentSpeed > MAX_SPEED)
+    /**
+     * @brief Update a whole crowd of agents, evaluating each steering behavior once for all of them.
+     * @param agents Agents to update.
+     * @param deltaTime Time since last update.
+     * @note Same result as calling update on each agent. All agents use the first agent's
+     * Arrive and Align tuning, which the constructor sets the same for every agent.
+     */
+    static void updateCrowd(std::vector<PathFollower> &agents, float deltaTime)
+    {
+        // Gather the agents that are still following a path
+        std::vector<size_t> moving;
+        std::vector<Kinematic> characters, targets;
+        for (size_t i = 0; i < agents.size(); i++)
         {
-            character.velocity *= (MAX_SPEED / currentSpeed);
+            agents[i].savePreviousState();
+            if (agents[i].updateTarget())
+            {
+                moving.push_back(i);
+                characters.push_back(agents[i].character);
+                targets.push_back(agents[i].target);
+            }
         }
-
-        // Apply Align behavior to match orientation
-        SteeringData alignAcceleration = alignBehavior.calculateAcceleration(character, target);
-        character.rotation += alignAcceleration.angular * deltaTime;
-
-        if (character.velocity.x != 0 || character.velocity.y != 0)
+        if (moving.empty())
         {
-            float angle = std::atan2(character.velocity.y, character.velocity.x) * (180.0f / 3.14159265f);
-            character.orientation = angle;
-            sprite.setRotation(angle);
+            return;
         }
 
-        // Update character position and orientation
-        character.update(deltaTime);
-
-        // Check if we've reached the current waypoint
-        distToTarget = std::sqrt(
-            (target.position.x - character.position.x) * (target.position.x - character.position.x) +
-            (target.position.y - character.position.y) * (target.position.y - character.position.y));
-
-        // Waypoint reached threshold
-        const float WAYPOINT_THRESHOLD = 10.0f;
+        // One batch call per behavior
+        std::vector<SteeringData> arriveAccelerations(moving.size()), alignAccelerations(moving.size());
+        PathFollower &first = agents[moving[0]];
+        first.arriveBehavior.calculateAccelerations(characters.data(), targets.data(), arriveAccelerations.data(), moving.size());
+        first.alignBehavior.calculateAccelerations(characters.data(), targets.data(), alignAccelerations.data(), moving.size());
 
-        if (distToTarget < WAYPOINT_THRESHOLD)
+        for (size_t i = 0; i < moving.size(); i++)
         {
-            std::cout << "Reached waypoint " << currentWaypoint << "/" << path.size() << std::endl;
-            currentWaypoint++;
+            agents[moving[i]].applySteering(arriveAccelerations[i], alignAccelerations[i], deltaTime);
         }
+    }
 
-        // Update sprite position and rotation
-        sprite.setPosition(character.position);
-        sprite.setRotation(character.orientation);
-
-        // Handle breadcrumbs
-        dropBreadcrumbs();
+    /**
+     * @brief Place the sprite between the state before and after the last update.
+     * @param alpha Blend factor from FixedTimestep::getAlpha(); 1 draws the latest state.
+     */
+    void interpolate(float alpha)
+    {
+        sprite.setPosition(FixedTimestep::lerp(previousPosition, character.position, alpha));
+        sprite.setRotation(FixedTimestep::lerpAngle(previousOrientation, character.orientation, alpha));
     }
 
     /**
@@ -238,9 +202,13 @@ public:
     void draw(sf::RenderWindow &window)
     {
         // Draw breadcrumbs first
-        for (const auto &crumb : breadcrumbs)
+        for (size_t i = 0; i < breadcrumbs.size(0); i++)
         {
-            crumb.draw(window);
+            sf::CircleShape crumb(3.0f);
+            crumb.setFillColor(sf::Color::Blue);
+            crumb.setOrigin(3.0f, 3.0f);
+            crumb.setPosition(breadcrumbs.get(0, i));
+            window.draw(crumb);
         }
 
         // Draw the path
@@ -269,6 +237,26 @@ public:
         window.draw(sprite);
     }
 
+    /**
+     * @brief Add the agent, its breadcrumbs and its path to a sprite batch.
+     * @param batch Batch collecting this frame's sprites, dots and lines.
+     */
+    void draw(SpriteBatch &batch) const
+    {
+        breadcrumbs.draw(0, batch, 3.0f, sf::Color::Blue);
+
+        if (path.size() > 1)
+        {
+            batch.addLineStrip(path, sf::Color(0, 150, 0, 150));
+            for (const auto &waypoint : path)
+            {
+                batch.addDot(waypoint, 5, sf::Color(0, 100, 0));
+            }
+        }
+
+        batch.addSprite(sprite);
+    }
+
 private:
     Kinematic character;   // The agent's kinematic state
     Kinematic target;      // The target's kinematic state
@@ -276,14 +264,114 @@ private:
     Arrive arriveBehavior; // Arrive behavior for path following
     Align alignBehavior;   // Align behavior for orientation matching
 
+    sf::Vector2f previousPosition; // Position before the last update, for interpolation
+    float previousOrientation;     // Orientation before the last update, for interpolation
+
     std::vector<sf::Vector2f> path; // The path to follow
     int currentWaypoint;            // Index of the current waypoint
 
-    std::deque<Breadcrumb> breadcrumbs;            // Breadcrumbs for visualizing the path
+    BreadcrumbTrails breadcrumbs;                  // Ring buffer of breadcrumb positions
     int breadcrumbCounter;                         // Counter for breadcrumb dropping
     static constexpr int BREADCRUMB_INTERVAL = 120; // Frames between dropping breadcrumbs
     static constexpr int MAX_BREADCRUMBS = 50;     // Maximum number of breadcrumbs
 
+    /**
+     * @brief Remember the current state so rendering can blend from it after the next update.
+     */
+    void savePreviousState()
+    {
+        previousPosition = character.position;
+        previousOrientation = character.orientation;
+    }
+
+    /**
+     * @brief Aim the target at the current waypoint, or stop if the path is done.
+     * @return True if the agent still has a waypoint to steer toward.
+     */
+    bool updateTarget()
+    {
+        // If no path or at the end of the path, don't move
+        if (path.empty() || currentWaypoint >= path.size())
+        {
+            // Stop moving when we've reached the final waypoint
+            character.velocity = {0, 0};
+            character.rotation = 0;
+            return false;
+        }
+
+        // Target is the current waypoint we're moving toward
+        target.position = path[currentWaypoint];
+
+        // Calculate desired orientation based on direction to target
+        sf::Vector2f dirToTarget = target.position - character.position;
+        float distToTarget = std::sqrt(dirToTarget.x * dirToTarget.x + dirToTarget.y * dirToTarget.y);
+
+        if (distToTarget > 0.1f)
+        {
+            // Normalize direction vector
+            dirToTarget /= distToTarget;
+            float desiredOrientation = std::atan2(dirToTarget.y, dirToTarget.x) * (180.0f / 3.14159265f);
+            target.orientation = desiredOrientation;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Apply the steering results, move the agent and advance along the path.
+     * @param arriveAcceleration Arrive result for this frame.
+     * @param alignAcceleration Align result for this frame.
+     * @param deltaTime Time since last update.
+     */
+    void applySteering(const SteeringData &arriveAcceleration, const SteeringData &alignAcceleration, float deltaTime)
+    {
+        // Navigate to current waypoint
+        character.velocity += arriveAcceleration.linear * deltaTime;
+
+        // Limit velocity to max speed if needed
+        float currentSpeed = std::sqrt(character.velocity.x * character.velocity.x +
+                                       character.velocity.y * character.velocity.y);
+        const float MAX_SPEED = 175.0f;
+        if (currentSpeed > MAX_SPEED)
+        {
+            character.velocity *= (MAX_SPEED / currentSpeed);
+        }
+
+        // Match orientation
+        character.rotation += alignAcceleration.angular * deltaTime;
+
+        if (character.velocity.x != 0 || character.velocity.y != 0)
+        {
+            float angle = std::atan2(character.velocity.y, character.velocity.x) * (180.0f / 3.14159265f);
+            character.orientation = angle;
+            sprite.setRotation(angle);
+        }
+
+        // Update character position and orientation
+        character.update(deltaTime);
+
+        // Check if we've reached the current waypoint
+        float distToTarget = std::sqrt(
+            (target.position.x - character.position.x) * (target.position.x - character.position.x) +
+            (target.position.y - character.position.y) * (target.position.y - character.position.y));
+
+        // Waypoint reached threshold
+        const float WAYPOINT_THRESHOLD = 10.0f;
+
+        if (distToTarget < WAYPOINT_THRESHOLD)
+        {
+            std::cout << "Reached waypoint " << currentWaypoint << "/" << path.size() << std::endl;
+            currentWaypoint++;
+        }
+
+        // Update sprite position and rotation
+        sprite.setPosition(character.position);
+        sprite.setRotation(character.orientation);
+
+        // Handle breadcrumbs
+        dropBreadcrumbs();
+    }
+
     /**
      * @brief Drop breadcrumbs to visualize the agent's path.
      */
@@ -293,12 +381,7 @@ private:
         if (breadcrumbCounter >= BREADCRUMB_INTERVAL)
         {
             breadcrumbCounter = 0;
-            breadcrumbs.push_back(Breadcrumb(character.position));
-
-            if (breadcrumbs.size() > MAX_BREADCRUMBS)
-            {
-                breadcrumbs.pop_front();
-            }
+            breadcrumbs.push(0, character.position); // Replaces the oldest crumb once the trail is full
         }
     }
 };
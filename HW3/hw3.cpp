@@ -18,6 +18,8 @@
 #include <vector>
 #include <chrono>
 #include <iomanip>
+#include <random>
+#include <cstdlib>
 
 // Include headers
 #include "headers/Graph.h"
@@ -26,6 +28,10 @@
 #include "headers/Heuristics.h"
 #include "headers/Environment.h"
 #include "headers/PathFollower.h"
+#include "headers/PathSmoothing.h"
+#include "headers/NavAsset.h"
+#include "headers/FixedTimestep.h"
+#include "headers/HeadlessRunner.h"
 
 
 /**
@@ -88,6 +94,77 @@ Environment createIndoorEnvironment(int width, int height)
     return env;
 }
 
+/**
+ * @brief Runs a crowd of path followers without a window and reports ticks per second.
+ * @param environment Environment the agents move in.
+ * @param graph Navigation graph for pathfinding.
+ * @param astar A* search used for every new path.
+ * @param agentCount Number of agents.
+ * @param ticks Number of simulation steps.
+ * @param clearance Distance smoothed paths keep from walls.
+ * @return Exit status.
+ * @note Each agent wanders between random reachable vertices: whenever its path is done, it
+ * gets an A* path to a new one. Pathfinding runs inside the tick, so it counts toward the timing.
+ */
+int runHeadlessCrowd(const Environment &environment, const Graph &graph, AStar &astar,
+                     int agentCount, long long ticks, float clearance)
+{
+    std::mt19937 rng(484); // Fixed seed so runs are repeatable
+    std::uniform_int_distribution<int> vertexDistribution(0, graph.size() - 1);
+
+    // Pick a random vertex that is not inside an obstacle
+    auto randomOpenVertex = [&]()
+    {
+        int vertex = vertexDistribution(rng);
+        while (environment.isObstacle(graph.getVertexPosition(vertex)))
+        {
+            vertex = vertexDistribution(rng);
+        }
+        return vertex;
+    };
+
+    // Agents start on random open vertices; the texture is never loaded (no display needed)
+    sf::Texture agentTexture;
+    std::vector<PathFollower> agents;
+    agents.reserve(agentCount);
+    for (int i = 0; i < agentCount; i++)
+    {
+        agents.emplace_back(graph.getVertexPosition(randomOpenVertex()), agentTexture);
+    }
+
+    long long pathsFound = 0;
+    HeadlessRunner runner;
+    HeadlessStats stats = runner.run(ticks, [&](float deltaTime)
+                                     {
+        // Give every agent that finished its path a new one
+        for (PathFollower &agent : agents)
+        {
+            if (!agent.pathCompleted())
+            {
+                continue;
+            }
+
+            sf::Vector2f agentPos = agent.getPosition();
+            std::vector<int> path = astar.findPath(graph, environment.pointToVertex(agentPos), randomOpenVertex());
+            std::vector<sf::Vector2f> waypoints;
+            for (int vertex : path)
+            {
+                waypoints.push_back(graph.getVertexPosition(vertex));
+            }
+            if (!waypoints.empty())
+            {
+                agent.setPath(PathSmoothing::smoothFrom(agentPos, waypoints, environment, clearance));
+                pathsFound++;
+            }
+        }
+
+        PathFollower::updateCrowd(agents, deltaTime); });
+
+    HeadlessRunner::report(std::cout, "path followers", agents.size(), stats);
+    std::cout << pathsFound << " paths found" << std::endl;
+    return 0;
+}
+
 /**
  * @brief Main function for the pathfinding and path following demonstration.
  * @note OpenAI's ChatGPT was used to suggest the structure of this main functin and to output statistics.
@@ -95,17 +172,36 @@ Environment createIndoorEnvironment(int width, int height)
  * Include statistical output."
  * The response was modified to fit the context of the code.
  */
-int main()
+int main(int argc, char *argv[])
 {
-    // Create window
+    // Command line: --headless TICKS [AGENTS] runs a crowd of path followers without a window
+    long long headlessTicks = 0;
+    int headlessAgents = 100;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (std::string(argv[arg]) == "--headless" && arg + 1 < argc)
+        {
+            headlessTicks = std::max(1LL, std::atoll(argv[++arg]));
+        }
+        else if (headlessTicks > 0 && std::atoi(argv[arg]) > 0)
+        {
+            headlessAgents = std::atoi(argv[arg]);
+        }
+    }
+    bool headless = headlessTicks > 0;
+
+    // Create window (not when headless)
     int windowWidth = 640;
     int windowHeight = 480;
-    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight),
-                            "CSC 584/484 - Pathfinding and Path Following");
+    sf::RenderWindow window;
+    if (!headless)
+    {
+        window.create(sf::VideoMode(windowWidth, windowHeight), "CSC 584/484 - Pathfinding and Path Following");
+    }
 
-    // Load texture for the agent
+    // Load texture for the agent (uploading it needs a display, so not when headless)
     sf::Texture agentTexture;
-    if (!agentTexture.loadFromFile("boid.png"))
+    if (!headless && !agentTexture.loadFromFile("boid.png"))
     {
         std::cerr << "Failed to load boid.png! Creating fallback texture." << std::endl;
     }
@@ -117,15 +213,39 @@ int main()
     // Create graph representation of the environment
     std::cout << "Creating graph representation..." << std::endl;
     int gridSize = 20; // 20px grid cells
-    Graph environmentGraph = environment.createGraph(gridSize);
+    const float PATH_CLEARANCE = 10.0f; // Distance smoothed paths keep from walls
+    const int NAV_LANDMARKS = 4;        // Landmark distance tables stored in the nav asset
+    NavAsset navAsset;
+    Graph environmentGraph = navAsset.loadOrBuild("nav_grid_20.dat", environment, gridSize, NAV_LANDMARKS);
     std::cout << "Graph created with " << environmentGraph.size() << " vertices" << std::endl;
 
+    // Adaptive (quadtree) graph over the same environment, toggled with G
+    const int ADAPTIVE_MAX_CELL = 160; // Largest cell used in open room interiors
+    Graph adaptiveGraph = environment.createAdaptiveGraph(gridSize, ADAPTIVE_MAX_CELL);
+    std::cout << "Adaptive graph created with " << adaptiveGraph.size() << " vertices" << std::endl;
+    Graph *activeGraph = &environmentGraph;
+    environment.setVertexPositions(activeGraph->getVertexPositions());
+
     // Create pathfinding algorithms
     Dijkstra dijkstra;
 
-    // A* with Euclidean distance heuristic
-    AStar astar([](int current, int goal, const Graph &g)
-                { return Heuristics::euclidean(current, goal, g); });
+    // A* with Euclidean distance heuristic, tightened by the asset's landmark tables when available
+    // (the tables index the uniform grid graph, so they are not used on the adaptive graph)
+    AStar astar([&navAsset, &environmentGraph](int current, int goal, const Graph &g)
+                {
+                    float estimate = Heuristics::euclidean(current, goal, g);
+                    if (navAsset.isLoaded() && &g == &environmentGraph)
+                    {
+                        estimate = std::max(estimate, Heuristics::landmark(current, goal, navAsset.landmarkDistances(),
+                                                                           navAsset.landmarkCount(), navAsset.vertexCount()));
+                    }
+                    return estimate; });
+
+    // Headless run: a crowd of path followers on the uniform grid graph
+    if (headless)
+    {
+        return runHeadlessCrowd(environment, environmentGraph, astar, headlessAgents, headlessTicks, PATH_CLEARANCE);
+    }
 
     // Create path follower (agent)
     sf::Vector2f startPos(100, 100); // Starting position
@@ -146,7 +266,7 @@ int main()
     if (fontLoaded)
     {
         instructionText.setFont(font);
-        instructionText.setString("Left-click: A* | Right-click: Dijkstra | R: Reset agent");
+        instructionText.setString("Left-click: A* | Right-click: Dijkstra | R: Reset agent | G: Toggle adaptive graph");
         instructionText.setCharacterSize(10);
         instructionText.setFillColor(sf::Color::Black);
         instructionText.setPosition(5, 5);
@@ -189,8 +309,12 @@ int main()
         }
     }
 
-    // Clock for timing
+    // Batch for the agent, its path and the graph vertices
+    SpriteBatch batch;
+
+    // Clock for timing; the agent moves in fixed simulation steps
     sf::Clock clock;
+    FixedTimestep timestep;
 
     // Main loop
     while (window.isOpen())
@@ -218,6 +342,19 @@ int main()
                         statsText.setString("Agent position reset");
                     }
                 }
+                else if (event.key.code == sf::Keyboard::G)
+                {
+                    // Switch between the uniform grid and the adaptive graph
+                    activeGraph = (activeGraph == &environmentGraph) ? &adaptiveGraph : &environmentGraph;
+                    environment.setVertexPositions(activeGraph->getVertexPositions());
+
+                    std::string graphName = (activeGraph == &environmentGraph) ? "uniform grid" : "adaptive";
+                    std::cout << "Using " << graphName << " graph (" << activeGraph->size() << " vertices)" << std::endl;
+                    if (fontLoaded)
+                    {
+                        statsText.setString("Using " + graphName + " graph (" + std::to_string(activeGraph->size()) + " vertices)");
+                    }
+                }
             }
             else if (event.type == sf::Event::MouseButtonPressed)
             {
@@ -261,7 +398,7 @@ int main()
                 if (event.mouseButton.button == sf::Mouse::Left)
                 {
                     // Use A* algorithm
-                    path = astar.findPath(environmentGraph, startVertex, goalVertex);
+                    path = astar.findPath(*activeGraph, startVertex, goalVertex);
                     nodesExplored = astar.getNodesExplored();
                     maxFringe = astar.getMaxFringeSize();
                     pathCost = astar.getPathCost();
@@ -270,7 +407,7 @@ int main()
                 else if (event.mouseButton.button == sf::Mouse::Right)
                 {
                     // Use Dijkstra's algorithm
-                    path = dijkstra.findPath(environmentGraph, startVertex, goalVertex);
+                    path = dijkstra.findPath(*activeGraph, startVertex, goalVertex);
                     nodesExplored = dijkstra.getNodesExplored();
                     maxFringe = dijkstra.getMaxFringeSize();
                     pathCost = dijkstra.getPathCost();
@@ -296,9 +433,14 @@ int main()
                 std::vector<sf::Vector2f> waypoints;
                 for (int vertex : path)
                 {
-                    waypoints.push_back(environmentGraph.getVertexPosition(vertex));
+                    waypoints.push_back(activeGraph->getVertexPosition(vertex));
                 }
 
+                // Skip grid waypoints the agent can reach in a straight line
+                size_t gridWaypoints = waypoints.size();
+                waypoints = PathSmoothing::smoothFrom(agentPos, waypoints, environment, PATH_CLEARANCE);
+                std::cout << "Smoothed path from " << gridWaypoints << " to " << waypoints.size() << " waypoints" << std::endl;
+
                 std::cout << "Path found with " << waypoints.size() << " waypoints:" << std::endl;
                 for (size_t i = 0; i < waypoints.size(); i++)
                 {
@@ -327,9 +469,13 @@ int main()
             }
         }
 
-        // Update
-        float deltaTime = clock.restart().asSeconds();
-        agent.update(deltaTime);
+        // Update once per simulation step due this frame
+        int steps = timestep.advance(clock.restart().asSeconds());
+        for (int step = 0; step < steps; step++)
+        {
+            agent.update(timestep.getStep());
+        }
+        agent.interpolate(timestep.getAlpha());
 
         // Render
         window.clear(sf::Color::White);
@@ -337,17 +483,17 @@ int main()
         // Draw environment
         environment.draw(window);
 
-        // Draw graph vertices if enabled
+        // Draw graph vertices (if enabled), agent and path through one batch
+        batch.clear();
         if (showGraph)
         {
             for (const auto &vertex : graphVertices)
             {
-                window.draw(vertex);
+                batch.addCircle(vertex);
             }
         }
-
-        // Draw agent and path
-        agent.draw(window);
+        agent.draw(batch);
+        batch.draw(window);
 
         // Draw text
         if (fontLoaded)
@@ -1,5 +1,8 @@
 #include "../headers/Arrive.h"
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "../headers/Float4.h"
 
 // Constructor
 Arrive::Arrive(float maxAcceleration, float maxSpeed, float targetRadius, float slowRadius, float timeToTarget)
@@ -56,3 +59,64 @@ SteeringData Arrive::calculateAcceleration(const Kinematic& character, const Kin
     result.angular = 0;
     return result;
 }
+
+// Batch version: gathers 4 characters into lanes and runs the steps above without branches
+void Arrive::calculateAccelerations(const Kinematic* characters, const Kinematic* targets,
+                                    SteeringData* results, size_t count) {
+#ifdef FLOAT4_SIMD
+    for (size_t first = 0; first < count; first += 4) {
+        size_t lanes = std::min<size_t>(4, count - first);
+
+        // Unused lanes stay at zero (inside the target radius, so they produce no steering)
+        float dirX[4] = {}, dirY[4] = {}, velX[4] = {}, velY[4] = {};
+        for (size_t i = 0; i < lanes; i++) {
+            const Kinematic& character = characters[first + i];
+            const Kinematic& target = targets[first + i];
+            dirX[i] = target.position.x - character.position.x;
+            dirY[i] = target.position.y - character.position.y;
+            velX[i] = character.velocity.x;
+            velY[i] = character.velocity.y;
+        }
+        Float4 directionX = Float4::load(dirX), directionY = Float4::load(dirY);
+        Float4 velocityX = Float4::load(velX), velocityY = Float4::load(velY);
+        Float4 zero = Float4::splat(0);
+
+        // Target speed slows down inside the slow radius
+        Float4 distance = sqrt(directionX * directionX + directionY * directionY);
+        Float4 speed = Float4::splat(maxSpeed);
+        Float4 targetSpeed = select(distance > Float4::splat(slowRadius), speed, speed * (distance / Float4::splat(slowRadius)));
+
+        // Target velocity along the direction (zero direction stays zero)
+        Float4 safeDistance = max(distance, Float4::splat(FLT_MIN));
+        Float4 linearX = ((directionX / safeDistance) * targetSpeed - velocityX) / Float4::splat(timeToTarget);
+        Float4 linearY = ((directionY / safeDistance) * targetSpeed - velocityY) / Float4::splat(timeToTarget);
+
+        // Hard stop when both the acceleration and the speed are tiny
+        Mask4 stop = (sqrt(linearX * linearX + linearY * linearY) < Float4::splat(0.01f)) &
+                     (sqrt(velocityX * velocityX + velocityY * velocityY) < Float4::splat(1.0f));
+        linearX = select(stop, zero, linearX);
+        linearY = select(stop, zero, linearY);
+
+        // Clamp acceleration
+        Float4 accelMagnitude = sqrt(linearX * linearX + linearY * linearY);
+        Mask4 clamp = accelMagnitude > Float4::splat(maxAcceleration);
+        linearX = select(clamp, (linearX / accelMagnitude) * Float4::splat(maxAcceleration), linearX);
+        linearY = select(clamp, (linearY / accelMagnitude) * Float4::splat(maxAcceleration), linearY);
+
+        // No steering inside the target radius
+        Mask4 arrived = distance < Float4::splat(targetRadius);
+        linearX = select(arrived, zero, linearX);
+        linearY = select(arrived, zero, linearY);
+
+        float outX[4], outY[4];
+        linearX.store(outX);
+        linearY.store(outY);
+        for (size_t i = 0; i < lanes; i++) {
+            results[first + i] = SteeringData(sf::Vector2f(outX[i], outY[i]), 0);
+        }
+    }
+#else
+    // Without a vector backend the lanes are plain loops, so the per-agent version is faster
+    SteeringBehavior::calculateAccelerations(characters, targets, results, count);
+#endif
+}
@@ -0,0 +1,75 @@
+/**
+ * @file ActionRegistry.h
+ * @brief Defines the ActionRegistry, which interns action names as small integer ids.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#ifndef ACTION_REGISTRY_H
+#define ACTION_REGISTRY_H
+
+#include <string>
+
+/**
+ * @brief Integer id of an action; decisions pass these around instead of names
+ */
+using ActionId = int;
+
+/**
+ * @namespace ActionRegistry
+ * @brief Maps action names to ids and back.
+ *
+ * The monster's actions are registered first, in the order below, so their ids are compile-time
+ * constants and Monster::executeAction can dispatch on them with a switch. Other names (player
+ * targets, labels from learned trees) get the next free id the first time they are interned.
+ * Names are only needed for logging and for the recorded CSV data.
+ */
+namespace ActionRegistry
+{
+    /**
+     * @brief Ids of the built-in actions
+     */
+    enum : ActionId
+    {
+        NONE = -1, // No action chosen yet
+        IDLE = 0,
+        PATHFIND_TO_PLAYER,
+        WANDER,
+        FOLLOW_PATH,
+        DANCE,
+        FLEE,
+        BUILTIN_COUNT
+    };
+
+    /**
+     * @brief Get the id of an action name, registering it if it is new
+     * @param name Action name
+     * @return Action id
+     */
+    ActionId intern(const std::string &name);
+
+    /**
+     * @brief Get the id of an action name without registering it
+     * @param name Action name
+     * @return Action id, or NONE if the name was never interned
+     */
+    ActionId find(const std::string &name);
+
+    /**
+     * @brief Get the name of an action
+     * @param id Action id
+     * @return Action name, or an empty string for NONE or an unknown id
+     */
+    const std::string &getName(ActionId id);
+
+    /**
+     * @brief Get the number of registered actions
+     */
+    int size();
+}
+
+#endif // ACTION_REGISTRY_H
@@ -18,56 +18,54 @@
 #ifndef BEHAVIOR_TREE_H
 #define BEHAVIOR_TREE_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <random>
 #include <vector>
 #include <string>
 #include <functional>
-#include <unordered_map>
 #include <SFML/System.hpp>
 #include "headers/Kinematic.h"
+#include "headers/Blackboard.h"
 
 /**
  * @brief Return status of behavior tree nodes
  */
-enum class BehaviorStatus
+enum class BehaviorStatus : uint8_t
 {
     SUCCESS, // Node executed successfully
     FAILURE, // Node execution failed
     RUNNING  // Node is still executing
 };
 
+class ConditionNode;
+class BehaviorInstance;
+class BehaviorTree;
+class WorkerPool;
+
 /**
- * @struct BehaviorState
- * @brief Helper struct to maintain state between ticks
+ * @struct BehaviorGuard
+ * @brief A condition that decided the running branch, and the result it had then
+ *
+ * BehaviorInstance re-checks a guard when a key it observes changes; a different result
+ * means the branch would no longer be chosen.
  */
-struct BehaviorState
+struct BehaviorGuard
 {
-    bool initialized = false;
-    float timer = 0.0f;
-    int phase = 0;
-    int counter = 0;
-    std::unordered_map<std::string, float> floatParams;
-    std::unordered_map<std::string, int> intParams;
-    std::unordered_map<std::string, bool> boolParams;
-
-    /**
-     * @brief Resets all state variables to their default values.
-     */
-    void reset()
-    {
-        initialized = false;
-        timer = 0.0f;
-        phase = 0;
-        counter = 0;
-        floatParams.clear();
-        intParams.clear();
-        boolParams.clear();
-    }
+    const ConditionNode *condition = nullptr;
+    bool expected = false; // Result when the branch was chosen
+    size_t depth = 0;      // Depth on the active path of the composite that owns the guard
 };
 
 /**
  * @class BehaviorNode
  * @brief Abstract base class for all behavior tree nodes
+ *
+ * Nodes only describe the tree and do not change while it runs. Anything a node has to remember
+ * between ticks (which child is running, how often it repeated) is kept in the BehaviorInstance
+ * of the agent, at the offset BehaviorTree gave the node, so one tree can drive many agents.
  */
 class BehaviorNode
 {
@@ -75,14 +73,66 @@ public:
     virtual ~BehaviorNode() = default;
 
     /**
-     * @brief Pure virtual function to tick/update the node
+     * @brief Pure virtual function to tick/update the node for one agent
+     * @param instance The agent's state
+     */
+    virtual BehaviorStatus tick(BehaviorInstance &instance) const = 0;
+
+    /**
+     * @brief Reset the node's state for one agent
+     * @param instance The agent's state
+     */
+    virtual void reset(BehaviorInstance &instance) const = 0;
+
+    /**
+     * @brief Get the number of bytes of per-agent state this node needs (at most 4-byte aligned)
+     */
+    virtual size_t getStateSize() const { return 0; }
+
+    /**
+     * @brief Add the children of this node
+     */
+    virtual void getChildren(std::vector<const BehaviorNode *> &children) const {}
+
+    /**
+     * @brief Get the offset of this node's state in a BehaviorInstance
      */
-    virtual BehaviorStatus tick() = 0;
+    size_t getStateOffset() const { return stateOffset; }
+
+    // Used by BehaviorInstance to resume at the running leaf instead of ticking down from the root
+
+    /**
+     * @brief Get the child that tick would continue with, if this node is running
+     * @return Running child, or nullptr for leaves and nodes that must be ticked whole
+     */
+    virtual const BehaviorNode *getRunningChild(const BehaviorInstance &instance) const { return nullptr; }
+
+    /**
+     * @brief Continue after the running child finished, as tick would have
+     * @param instance The agent's state
+     * @param childStatus SUCCESS or FAILURE returned by the running child
+     * @return Status of this node
+     */
+    virtual BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const { return childStatus; }
+
+    /**
+     * @brief Add the guards of the running child: conditions evaluated before it was reached
+     * @param instance The agent's state
+     * @param guards Receives the guards (depth is set by the caller)
+     */
+    virtual void getGuards(const BehaviorInstance &instance, std::vector<BehaviorGuard> &guards) const {}
 
     /**
-     * @brief Reset the node's internal state
+     * @brief Get the condition that decides whether this subtree can start
+     * @return The condition itself, the first child's leading condition for sequences, or nullptr
      */
-    virtual void reset() = 0;
+    virtual const ConditionNode *getLeadingCondition() const { return nullptr; }
+
+    /**
+     * @brief After this node failed, check whether it failed at its leading condition
+     * @note A sequence can also fail later, after its leading condition passed
+     */
+    virtual bool failedAtLeadingCondition(const BehaviorInstance &instance) const { return false; }
 
     /**
      * @brief Get the name of this node
@@ -91,6 +141,13 @@ public:
 
 protected:
     std::string nodeName = "Unnamed Node";
+
+private:
+    friend class BehaviorTree;
+
+    // Written once by the tree that places the node; nothing changes them while it runs
+    mutable size_t stateOffset = 0;               // Set by BehaviorTree::setRootNode
+    mutable const BehaviorTree *owner = nullptr; // Tree the node was placed in
 };
 
 /**
@@ -102,10 +159,10 @@ class BehaviorActionNode : public BehaviorNode
 public:
     /**
      * @brief Constructor for action node
-     * @param action Function that performs the action and returns status
+     * @param action Function that performs the action for an agent and returns status
      * @param name Name of the action
      */
-    BehaviorActionNode(std::function<BehaviorStatus()> action, const std::string &name)
+    BehaviorActionNode(std::function<BehaviorStatus(BehaviorInstance &)> action, const std::string &name)
         : action(action)
     {
         nodeName = "Action: " + name;
@@ -115,37 +172,44 @@ public:
      * @brief Execute the action
      * @return Status of the action execution
      */
-    BehaviorStatus tick() override
+    BehaviorStatus tick(BehaviorInstance &instance) const override
     {
-        return action();
+        return action(instance);
     }
 
     /**
      * @brief Reset the node's state
      */
-    void reset() override
+    void reset(BehaviorInstance &instance) const override
     {
-        // Most action nodes are stateless, so nothing to reset
+        // Action nodes keep their memory in the blackboard, so nothing to reset
     }
 
 private:
-    std::function<BehaviorStatus()> action;
+    std::function<BehaviorStatus(BehaviorInstance &)> action;
 };
 
 /**
  * @class ConditionNode
  * @brief Leaf node that checks a condition
+ *
+ * The condition must not change anything: BehaviorInstance calls it again whenever it re-checks
+ * a guard. Sensing that updates the blackboard belongs in BehaviorTree::setPerception, and the
+ * condition then only reads the keys it wrote.
  */
 class ConditionNode : public BehaviorNode
 {
 public:
     /**
      * @brief Constructor for condition node
-     * @param condition Function that checks a condition
+     * @param condition Function that checks a condition for an agent, without side effects
      * @param name Name of the condition
+     * @param observedKeys Keys the condition reads; BehaviorInstance re-checks it while another branch
+     * runs when one of them is notified as changed (none: it is only checked when reached)
      */
-    ConditionNode(std::function<bool()> condition, const std::string &name)
-        : condition(condition)
+    ConditionNode(std::function<bool(BehaviorInstance &)> condition, const std::string &name,
+                  const std::vector<int> &observedKeys = {})
+        : condition(condition), observedKeys(observedKeys)
     {
         nodeName = "Condition: " + name;
     }
@@ -154,21 +218,50 @@ public:
      * @brief Check the condition
      * @return SUCCESS if condition is true, FAILURE otherwise
      */
-    BehaviorStatus tick() override
+    BehaviorStatus tick(BehaviorInstance &instance) const override
     {
-        return condition() ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
+        return condition(instance) ? BehaviorStatus::SUCCESS : BehaviorStatus::FAILURE;
     }
 
     /**
      * @brief Reset the node's state
      */
-    void reset() override
+    void reset(BehaviorInstance &instance) const override
     {
         // Condition nodes are stateless, so nothing to reset
     }
 
+    const ConditionNode *getLeadingCondition() const override { return this; }
+    bool failedAtLeadingCondition(const BehaviorInstance &instance) const override { return true; }
+
+    /**
+     * @brief Check whether the condition reads any of the given keys
+     */
+    bool observesAny(const std::vector<int> &keys) const
+    {
+        for (int key : keys)
+        {
+            if (std::find(observedKeys.begin(), observedKeys.end(), key) != observedKeys.end())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
 private:
-    std::function<bool()> condition;
+    std::function<bool(BehaviorInstance &)> condition;
+    std::vector<int> observedKeys;
+};
+
+/**
+ * @struct CompositeState
+ * @brief Per-agent state of a sequence or selector
+ */
+struct CompositeState
+{
+    uint32_t currentChild = 0;
+    bool isRunning = false;
 };
 
 /**
@@ -200,17 +293,35 @@ public:
      * @brief Execute children in sequence
      * @return SUCCESS if all children succeeded, FAILURE if any child failed, RUNNING if a child is still running
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
 
     /**
      * @brief Reset the node's state and all children
      */
-    void reset() override;
+    void reset(BehaviorInstance &instance) const override;
+
+    size_t getStateSize() const override { return sizeof(CompositeState); }
+    void getChildren(std::vector<const BehaviorNode *> &result) const override;
+    const BehaviorNode *getRunningChild(const BehaviorInstance &instance) const override;
+    BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const override;
+
+    /**
+     * @brief Conditions before the running child passed, so each must stay true
+     */
+    void getGuards(const BehaviorInstance &instance, std::vector<BehaviorGuard> &guards) const override;
+
+    const ConditionNode *getLeadingCondition() const override
+    {
+        return children.empty() ? nullptr : children.front()->getLeadingCondition();
+    }
+
+    /**
+     * @brief Check whether the first child is the one that failed, at its own leading condition
+     */
+    bool failedAtLeadingCondition(const BehaviorInstance &instance) const override;
 
 private:
     std::vector<std::shared_ptr<BehaviorNode>> children;
-    size_t currentChild = 0;
-    bool isRunning = false;
 };
 
 /**
@@ -242,17 +353,26 @@ public:
      * @brief Try children in order until one succeeds
      * @return SUCCESS if any child succeeded, FAILURE if all children failed, RUNNING if a child is still running
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
 
     /**
      * @brief Reset the node's state and all children
      */
-    void reset() override;
+    void reset(BehaviorInstance &instance) const override;
+
+    size_t getStateSize() const override { return sizeof(CompositeState); }
+    void getChildren(std::vector<const BehaviorNode *> &result) const override;
+    const BehaviorNode *getRunningChild(const BehaviorInstance &instance) const override;
+    BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const override;
+
+    /**
+     * @brief Higher priority children that failed on their leading condition; each must stay false
+     * @note Children that failed later, after their leading condition passed, are not guarded
+     */
+    void getGuards(const BehaviorInstance &instance, std::vector<BehaviorGuard> &guards) const override;
 
 private:
     std::vector<std::shared_ptr<BehaviorNode>> children;
-    size_t currentChild = 0;
-    bool isRunning = false;
 };
 
 /**
@@ -276,11 +396,18 @@ public:
     /**
      * @brief Reset the node's state and child
      */
-    void reset() override
+    void reset(BehaviorInstance &instance) const override
     {
-        child->reset();
+        child->reset(instance);
     }
 
+    void getChildren(std::vector<const BehaviorNode *> &result) const override { result.push_back(child.get()); }
+
+    /**
+     * @brief A running decorator always continues with its child
+     */
+    const BehaviorNode *getRunningChild(const BehaviorInstance &instance) const override { return child.get(); }
+
 protected:
     std::shared_ptr<BehaviorNode> child;
 };
@@ -305,7 +432,9 @@ public:
      * @brief Invert the result of the child
      * @return FAILURE if child succeeded, SUCCESS if child failed, RUNNING if child is still running
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
+
+    BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const override;
 };
 
 /**
@@ -329,18 +458,30 @@ public:
      * @brief Repeat the child
      * @return SUCCESS if completed all repetitions, RUNNING otherwise
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
 
     /**
      * @brief Reset the node's state and child
      */
-    void reset() override;
+    void reset(BehaviorInstance &instance) const override;
+
+    size_t getStateSize() const override { return sizeof(int32_t); } // Repetitions so far
+    BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const override;
 
 private:
-    int repeatCount = 0;
     int maxRepeatCount;
 };
 
+/**
+ * @struct RandomSelectorState
+ * @brief Per-agent state of a random selector
+ */
+struct RandomSelectorState
+{
+    int32_t selectedChild = -1;
+    BehaviorStatus lastStatus = BehaviorStatus::FAILURE;
+};
+
 /**
  * @class RandomSelectorNode
  * @brief Composite node that randomly selects a child to execute
@@ -370,22 +511,32 @@ public:
      * @brief Randomly select a child to execute
      * @return Status of the selected child
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
 
     /**
      * @brief Reset the node's state and all children
      */
-    void reset() override;
+    void reset(BehaviorInstance &instance) const override;
+
+    size_t getStateSize() const override { return sizeof(RandomSelectorState); }
+    void getChildren(std::vector<const BehaviorNode *> &result) const override;
+    const BehaviorNode *getRunningChild(const BehaviorInstance &instance) const override;
+    BehaviorStatus resume(BehaviorInstance &instance, BehaviorStatus childStatus) const override;
 
 private:
     std::vector<std::shared_ptr<BehaviorNode>> children;
-    int selectedChild = -1;
-    BehaviorStatus lastStatus = BehaviorStatus::FAILURE;
 };
 
 /**
  * @class ParallelNode
  * @brief Composite node that executes all children simultaneously
+ *
+ * By default the children are ticked one after another in the same tick. With setWorkerPool
+ * they are ticked on the pool's threads at the same time, which shortens the tick when the
+ * children are expensive queries such as line of sight or path checks. Children ticked that way
+ * may read the agent and the blackboard but must not write either, issue commands or draw from the
+ * instance's random generator, so no RandomSelectorNode below them (debug builds check this); their
+ * statuses are joined under the same success and failure policies.
  */
 class ParallelNode : public BehaviorNode
 {
@@ -409,30 +560,49 @@ public:
     void addChild(std::shared_ptr<BehaviorNode> child)
     {
         children.push_back(child);
-        childStatuses.push_back(BehaviorStatus::FAILURE);
     }
 
+    /**
+     * @brief Tick the children concurrently on a worker pool
+     * @param pool Pool to use, or nullptr to tick them one after another (the default)
+     * @note Only for side-effect-free children (see the class description). The pool can be shared
+     * with other nodes and agents; when it is busy the children are ticked on the calling thread.
+     */
+    void setWorkerPool(WorkerPool *pool) { workers = pool; }
+
     /**
      * @brief Execute all children simultaneously
      * @return SUCCESS if success policy met, FAILURE if failure policy met, RUNNING otherwise
      */
-    BehaviorStatus tick() override;
+    BehaviorStatus tick(BehaviorInstance &instance) const override;
 
     /**
      * @brief Reset the node's state and all children
      */
-    void reset() override;
+    void reset(BehaviorInstance &instance) const override;
+
+    size_t getStateSize() const override { return children.size() * sizeof(BehaviorStatus); } // Status of each child
+    void getChildren(std::vector<const BehaviorNode *> &result) const override;
 
 private:
     std::vector<std::shared_ptr<BehaviorNode>> children;
-    std::vector<BehaviorStatus> childStatuses;
     int successPolicy;
     int failurePolicy;
+    WorkerPool *workers = nullptr; // Set to tick the children concurrently
+
+    /**
+     * @brief Tick the children in [begin, end) that are still running
+     */
+    void tickChildren(BehaviorInstance &instance, size_t begin, size_t end) const;
 };
 
 /**
  * @class BehaviorTree
- * @brief Main class for constructing and executing behavior trees
+ * @brief A behavior tree definition, shared by every agent that runs it
+ *
+ * Build the nodes and blackboard keys, then call setRootNode; from then on the tree is read
+ * only. Each agent runs it through its own BehaviorInstance, which holds the few bytes of node
+ * state and the blackboard values that make the agent's progress through the tree.
  */
 class BehaviorTree
 {
@@ -443,27 +613,186 @@ public:
     BehaviorTree() : rootNode(nullptr) {}
 
     /**
-     * @brief Set the root node of the behavior tree
+     * @brief Set the root node of the behavior tree and lay out the per-agent node state
      * @param root Root node of the behavior tree
+     * @return False, leaving the tree unchanged, if a node was already placed in another tree
+     * @note Add all children first. A node belongs to one tree: its state offset is stored in the
+     * node, so sharing a subtree with a second tree would move the offsets the first one uses.
      */
-    void setRootNode(std::shared_ptr<BehaviorNode> root)
-    {
-        rootNode = root;
-    }
+    bool setRootNode(std::shared_ptr<BehaviorNode> root);
+
+    /**
+     * @brief Get the root node
+     */
+    const BehaviorNode *getRootNode() const { return rootNode.get(); }
+
+    /**
+     * @brief Get the blackboard keys and their starting values
+     */
+    Blackboard &getBlackboard() { return blackboard; }
+    const Blackboard &getBlackboard() const { return blackboard; }
+
+    /**
+     * @brief Get the bytes of node state each agent needs
+     */
+    size_t getStateSize() const { return stateSize; }
+
+    /**
+     * @brief Set what every tick does first, before guards are re-checked
+     * @param sense Writes what the agent senses (target visible, obstacle ahead) to its blackboard;
+     * the keys it changes are notified, so the guards that observe them are re-checked
+     */
+    void setPerception(std::function<void(BehaviorInstance &)> sense) { perception = sense; }
+
+    /**
+     * @brief Get the perception function (empty if none was set)
+     */
+    const std::function<void(BehaviorInstance &)> &getPerception() const { return perception; }
 
+private:
+    std::shared_ptr<BehaviorNode> rootNode;
+    Blackboard blackboard; // Keys and starting values; each instance gets its own copy of the values
+    std::function<void(BehaviorInstance &)> perception;
+    size_t stateSize = 0;
+};
+
+/**
+ * @class BehaviorInstance
+ * @brief One agent running a shared BehaviorTree: its node state, blackboard and running branch
+ *
+ * tick does not walk down from the root while a branch is running. It keeps the path of
+ * running nodes from the last tick and ticks only the leaf at its end; when the leaf finishes,
+ * its parents resume one by one, exactly as they would inside a tick from the root.
+ * ParallelNode is ticked as a whole.
+ *
+ * The conditions that chose the running branch are its guards. A guard whose ConditionNode
+ * observes a key passed to notifyChanged is re-checked before the next tick; if its result
+ * changed, the composite that owns it is reset and ticked again, which picks a new branch.
+ * Guards without observed keys are not re-checked. Changes to the blackboard are notified
+ * automatically, so a condition can observe blackboard key ids.
+ *
+ * Actions that change anything outside their own agent and blackboard (moving, requesting a path)
+ * pass the change to issue. With setDeferCommands on, issue only queues it, so the instances of
+ * many agents can tick on different threads and the queued commands are run afterwards, one
+ * agent at a time, with runCommands.
+ */
+class BehaviorInstance
+{
+public:
     /**
-     * @brief Tick/update the behavior tree
+     * @brief Constructor
+     * @param tree Tree to run; it must have its root node set
+     * @param agent The agent, handed back to actions and conditions by getAgent
+     */
+    BehaviorInstance(std::shared_ptr<const BehaviorTree> tree, void *agent = nullptr);
+
+    // The blackboard notifies this instance, so it stays where it was made
+    BehaviorInstance(const BehaviorInstance &) = delete;
+    BehaviorInstance &operator=(const BehaviorInstance &) = delete;
+
+    /**
+     * @brief Tick/update the behavior tree for this agent
      * @return Status of the root node execution
      */
     BehaviorStatus tick();
 
     /**
-     * @brief Reset the behavior tree
+     * @brief Reset the node state and drop queued commands
+     * @note Blackboard values are kept; reset the blackboard too to clear them
      */
     void reset();
 
+    /**
+     * @brief Report that a key some conditions observe has changed
+     * @param key Key passed to the ConditionNode constructors; blackboard keys are reported automatically
+     */
+    void notifyChanged(int key);
+
+    /**
+     * @brief Run a change an action makes to the world, or queue it while commands are deferred
+     * @param command The change, such as a move or a path request
+     */
+    void issue(std::function<void()> command);
+
+    /**
+     * @brief Queue the commands actions issue instead of running them (off by default)
+     */
+    void setDeferCommands(bool enabled) { deferCommands = enabled; }
+
+    /**
+     * @brief Run the queued commands in the order they were issued and clear the queue
+     */
+    void runCommands();
+
+    /**
+     * @brief Mark that nodes of this instance are being ticked on several threads (set by ParallelNode)
+     * @note While it is set, debug builds stop on blackboard changes, issued commands and random draws
+     */
+    void setTickingConcurrently(bool concurrent) { tickingConcurrently = concurrent; }
+    bool isTickingConcurrently() const { return tickingConcurrently; }
+
+    /**
+     * @brief Get this agent's blackboard
+     */
+    Blackboard &getBlackboard() { return blackboard; }
+
+    /**
+     * @brief Get this agent's random number generator, for nodes that choose at random
+     * @note Each instance has its own, so agents can tick on different threads; children of a pooled
+     * ParallelNode share it and must not draw from it
+     */
+    std::minstd_rand &getRandom();
+
+    /**
+     * @brief Get the agent passed to the constructor
+     */
+    template <typename T>
+    T &getAgent() const { return *static_cast<T *>(agent); }
+
+    /**
+     * @brief Get a node's state for this agent
+     */
+    template <typename T>
+    T &getState(const BehaviorNode &node)
+    {
+        return *reinterpret_cast<T *>(reinterpret_cast<unsigned char *>(state.data()) + node.getStateOffset());
+    }
+    template <typename T>
+    const T &getState(const BehaviorNode &node) const
+    {
+        return *reinterpret_cast<const T *>(reinterpret_cast<const unsigned char *>(state.data()) + node.getStateOffset());
+    }
+
+    /**
+     * @brief Get the number of nodes from the root to the running leaf (0 if nothing is running)
+     */
+    size_t getActiveDepth() const { return activePath.size(); }
+
+    /**
+     * @brief Get the tree this instance runs
+     */
+    const BehaviorTree &getTree() const { return *tree; }
+
 private:
-    std::shared_ptr<BehaviorNode> rootNode;
+    std::shared_ptr<const BehaviorTree> tree;
+    void *agent;
+    std::vector<uint32_t> state;                  // Node state, in 4-byte words so every node's state is aligned
+    Blackboard blackboard;                        // This agent's values of the tree's keys
+    std::vector<const BehaviorNode *> activePath; // Root first, running leaf last
+    std::vector<BehaviorGuard> guards;            // Guards of the active path, outermost first
+    std::vector<int> changedKeys;                 // Keys notified since the last tick
+    std::vector<std::function<void()>> commands;  // Commands issued while deferred, oldest first
+    bool deferCommands = false;
+    bool tickingConcurrently = false;
+    std::minstd_rand random{static_cast<unsigned>(std::rand())}; // Seeded when the instance is made
+
+    /**
+     * @brief Propagate the status of a node on the active path up to the root
+     * @param depth Depth of the node that returned the status
+     * @param status Status it returned
+     * @return Status of the root
+     */
+    BehaviorStatus settle(size_t depth, BehaviorStatus status);
 };
 
-#endif // BEHAVIOR_TREE_H
\ No newline at end of file
+#endif // BEHAVIOR_TREE_H
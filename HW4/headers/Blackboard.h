@@ -0,0 +1,141 @@
+/**
+ * @file Blackboard.h
+ * @brief Defines the Blackboard class, typed per-agent memory for behavior trees.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#ifndef BLACKBOARD_H
+#define BLACKBOARD_H
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @struct BlackboardKey
+ * @brief Handle to one value on a blackboard; the type is fixed when the key is added
+ */
+template <typename T>
+struct BlackboardKey
+{
+    int id = -1;       // Key number, passed to change listeners
+    size_t offset = 0; // Byte offset of the value
+};
+
+/**
+ * @class Blackboard
+ * @brief Values shared by the nodes of one agent's behavior tree, stored in one flat buffer.
+ *
+ * Keys are added once, while the tree is built, and each gets a fixed, aligned slot in the
+ * buffer, so reading or writing a value is a copy at a known offset instead of a string lookup.
+ * Values must be trivially copyable (numbers, bools, vectors of them).
+ *
+ * set only stores a value that differs from the old one, and then tells every listener the key's
+ * id; BehaviorInstance listens to re-check the conditions that observe that key.
+ *
+ * A copy shares the key names and starting values and gets its own values, so a tree's
+ * blackboard can be copied for each agent that runs it.
+ */
+class Blackboard
+{
+public:
+    /**
+     * @brief Add a key with its starting value
+     * @param name Key name, for debugging
+     * @param initial Starting value, also restored by reset
+     * @return Key to read and write the value with
+     */
+    template <typename T>
+    BlackboardKey<T> add(const std::string &name, const T &initial = T())
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Blackboard values must be trivially copyable");
+
+        // Copies share the keys, so they are copied before they change
+        if (keys.use_count() > 1)
+        {
+            keys = std::make_shared<Keys>(*keys);
+        }
+
+        BlackboardKey<T> key;
+        key.id = static_cast<int>(keys->names.size());
+        key.offset = (values.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+        keys->names.push_back(name);
+        values.resize(key.offset + sizeof(T));
+        std::memcpy(values.data() + key.offset, &initial, sizeof(T));
+        keys->initialValues.resize(values.size());
+        std::memcpy(keys->initialValues.data() + key.offset, &initial, sizeof(T));
+        return key;
+    }
+
+    /**
+     * @brief Read a value
+     */
+    template <typename T>
+    T get(BlackboardKey<T> key) const
+    {
+        T value;
+        std::memcpy(&value, values.data() + key.offset, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Write a value, notifying the listeners if it changed
+     */
+    template <typename T>
+    void set(BlackboardKey<T> key, const T &value)
+    {
+        unsigned char *slot = values.data() + key.offset;
+        if (std::memcmp(slot, &value, sizeof(T)) != 0)
+        {
+            std::memcpy(slot, &value, sizeof(T));
+            for (const std::function<void(int)> &listener : listeners)
+            {
+                listener(key.id);
+            }
+        }
+    }
+
+    /**
+     * @brief Add a function called with the key id whenever set changes a value
+     */
+    void addListener(std::function<void(int)> listener) { listeners.push_back(listener); }
+
+    /**
+     * @brief Restore every value to the one it was added with (listeners are not called)
+     */
+    void reset() { values = keys->initialValues; }
+
+    /**
+     * @brief Get the name a key was added with
+     */
+    const std::string &getName(int id) const { return keys->names[id]; }
+
+    /**
+     * @brief Get the number of keys
+     */
+    int getKeyCount() const { return static_cast<int>(keys->names.size()); }
+
+private:
+    /**
+     * @brief What the keys are, shared by copies
+     */
+    struct Keys
+    {
+        std::vector<std::string> names;           // Indexed by key id
+        std::vector<unsigned char> initialValues; // Values as added, for reset
+    };
+
+    std::shared_ptr<Keys> keys = std::make_shared<Keys>();
+    std::vector<unsigned char> values; // All values, each at its key's offset
+    std::vector<std::function<void(int)>> listeners;
+};
+
+#endif // BLACKBOARD_H
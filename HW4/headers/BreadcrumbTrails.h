@@ -0,0 +1,131 @@
+/**
+ * @file BreadcrumbTrails.h
+ * @brief Defines the BreadcrumbTrails class, fixed-size breadcrumb trails for one or many agents.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - File: Provided Breadcrumb class from TA Derek Martin
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef BREADCRUMB_TRAILS_H
+#define BREADCRUMB_TRAILS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "headers/SpriteBatch.h"
+
+/**
+ * @class BreadcrumbTrails
+ * @brief Stores the last few breadcrumb positions of each agent in ring buffers.
+ *
+ * All trails share two flat float arrays (x and y), capacity slots per trail, allocated once
+ * in the constructor. Dropping a crumb writes one slot and, once a trail is full, overwrites
+ * its oldest crumb, so trail upkeep is O(1) and never allocates.
+ */
+class BreadcrumbTrails
+{
+public:
+    /**
+     * @brief Constructor to allocate empty trails.
+     * @param trailCount Number of trails (usually one per agent).
+     * @param capacity Maximum crumbs kept per trail.
+     */
+    BreadcrumbTrails(size_t trailCount, size_t capacity)
+        : capacity(capacity),
+          positionX(trailCount * capacity),
+          positionY(trailCount * capacity),
+          oldest(trailCount, 0),
+          count(trailCount, 0)
+    {
+    }
+
+    /**
+     * @brief Drop a crumb on a trail, replacing the oldest one if the trail is full.
+     * @param trail Trail index.
+     * @param position Position of the crumb.
+     */
+    void push(size_t trail, sf::Vector2f position)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+
+        size_t slot;
+        if (count[trail] < capacity)
+        {
+            slot = (oldest[trail] + count[trail]) % capacity;
+            count[trail]++;
+        }
+        else
+        {
+            slot = oldest[trail];
+            oldest[trail] = (oldest[trail] + 1) % capacity;
+        }
+        positionX[trail * capacity + slot] = position.x;
+        positionY[trail * capacity + slot] = position.y;
+    }
+
+    /**
+     * @brief Remove all crumbs of a trail.
+     * @param trail Trail index.
+     */
+    void clear(size_t trail)
+    {
+        count[trail] = 0;
+    }
+
+    /**
+     * @brief Get the number of crumbs on a trail.
+     * @param trail Trail index.
+     */
+    size_t size(size_t trail) const
+    {
+        return count[trail];
+    }
+
+    /**
+     * @brief Get a crumb of a trail.
+     * @param trail Trail index.
+     * @param index Crumb index, 0 being the oldest.
+     */
+    sf::Vector2f get(size_t trail, size_t index) const
+    {
+        size_t slot = trail * capacity + (oldest[trail] + index) % capacity;
+        return sf::Vector2f(positionX[slot], positionY[slot]);
+    }
+
+    /**
+     * @brief Add the crumbs of one trail to a batch as dots.
+     * @param trail Trail index.
+     * @param batch Batch collecting this frame's dots.
+     * @param radius Dot radius.
+     * @param color Dot color.
+     */
+    void draw(size_t trail, SpriteBatch &batch, float radius, sf::Color color) const
+    {
+        for (size_t i = 0; i < count[trail]; i++)
+        {
+            batch.addDot(get(trail, i), radius, color);
+        }
+    }
+
+    /**
+     * @brief Get the number of trails.
+     */
+    size_t getTrailCount() const
+    {
+        return count.size();
+    }
+
+private:
+    size_t capacity;                         // Slots per trail
+    std::vector<float> positionX, positionY; // Crumb positions, capacity slots per trail
+    std::vector<size_t> oldest;              // Slot of each trail's oldest crumb
+    std::vector<size_t> count;               // Crumbs on each trail
+};
+
+#endif // BREADCRUMB_TRAILS_H
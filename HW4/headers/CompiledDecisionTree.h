@@ -0,0 +1,343 @@
+/**
+ * @file CompiledDecisionTree.h
+ * @brief Defines the CompiledDecisionTree class, a decision tree flattened into contiguous arrays.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#ifndef COMPILED_DECISION_TREE_H
+#define COMPILED_DECISION_TREE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ActionRegistry.h"
+#include "DecisionFeatures.h"
+
+class DecisionNode;
+class WorkerPool;
+
+/**
+ * @struct CompiledDecisionNode
+ * @brief One node of a compiled decision tree; children are indices into the node array
+ */
+struct CompiledDecisionNode
+{
+    enum class Type
+    {
+        ACTION,
+        BRANCH,
+        RANDOM,
+        PRIORITY
+    };
+
+    Type type = Type::ACTION;
+    ActionId action = ActionRegistry::NONE; // ACTION: action id
+    int condition = -1;                     // BRANCH: condition id
+    int trueChild = -1;                     // BRANCH: node taken when the condition is true
+    int falseChild = -1;                    // BRANCH: node taken when it is false; PRIORITY: when no condition is true
+    int firstLink = 0;                      // RANDOM and PRIORITY: first entry in the link array
+    int linkCount = 0;                      // RANDOM and PRIORITY: number of links
+    float totalWeight = 0;                  // RANDOM: sum of the child weights
+};
+
+/**
+ * @struct CompiledDecisionLink
+ * @brief One child of a random or priority node
+ */
+struct CompiledDecisionLink
+{
+    int child = -1;     // Node index of the child
+    int condition = -1; // PRIORITY: condition id guarding the child
+    float weight = 0;   // RANDOM: cumulative weight up to and including this child
+};
+
+/**
+ * @struct ConditionProfile
+ * @brief How often a condition was evaluated, how often it was true and what it cost
+ */
+struct ConditionProfile
+{
+    std::string name;          // Condition name, for reports
+    long long evaluations = 0; // Calls of the condition function
+    long long cacheHits = 0;   // Times the result was reused within a tick
+    long long trueCount = 0;   // Calls and cache hits that were true
+    double seconds = 0;        // Total time spent in the condition function, less the timer's own cost
+
+    /**
+     * @brief Get the number of times a decision reached the condition, called or cached
+     */
+    long long reached() const { return evaluations + cacheHits; }
+
+    /**
+     * @brief Get the fraction of times the condition was true when reached
+     */
+    double trueRate() const { return reached() > 0 ? static_cast<double>(trueCount) / reached() : 0; }
+
+    /**
+     * @brief Get the average time of one call in seconds
+     */
+    double averageCost() const { return evaluations > 0 ? std::max(0.0, seconds / evaluations) : 0; }
+};
+
+/**
+ * @class CompiledDecisionTree
+ * @brief A decision tree stored as a flat node array and evaluated with a loop instead of recursion.
+ *
+ * Built by DecisionTree::compile from the linked DecisionNode objects. Conditions are stored in a
+ * table and referred to by id, subtrees shared by several parents are compiled once, and nodes are
+ * laid out parent first so a decision walks forward through memory.
+ * Evaluating allocates nothing and returns an action id from the ActionRegistry.
+ *
+ * Conditions that have the same FeatureTest are the same predicate and share one id; if their
+ * names differ, the shared id is named after the test. Passing a tick to evaluate caches each
+ * condition's result for that tick. One walk reaches a condition at most once, so the cache only
+ * saves work for callers that decide more than once per tick (several decisions from the same
+ * state). Profiling counts calls, true results and time per condition.
+ *
+ * The cache and the profile are written by the const evaluate, so one compiled tree must not be
+ * evaluated from several threads at once; give each thread its own copy. evaluateBatch writes
+ * neither and may be split across a WorkerPool.
+ *
+ * reordered uses a profile to move cheap, likely conditions ahead of expensive, unlikely ones
+ * where that cannot change the decision.
+ *
+ * If every condition also has a FeatureTest, evaluateBatch decides for a whole crowd at once: the
+ * agents start as one group at the root, and each node tests its condition on the feature column
+ * for the whole group, then splits it between its children.
+ */
+class CompiledDecisionTree
+{
+public:
+    /**
+     * @brief Check whether the tree has any nodes
+     * @return True if nothing has been compiled
+     */
+    bool empty() const { return nodes.empty(); }
+
+    /**
+     * @brief Remove all nodes, conditions and actions
+     */
+    void clear();
+
+    /**
+     * @brief Walk the tree from the root to an action
+     * @return Id of the decided action, or ActionRegistry::NONE if the tree is empty
+     */
+    ActionId evaluate() const;
+
+    /**
+     * @brief Walk the tree from the root to an action, reusing condition results from the same tick
+     * @param tick Current tick; results cached under another tick are recomputed
+     * @return Id of the decided action, or ActionRegistry::NONE if the tree is empty
+     * @note Not thread safe: it writes the cache and the profile
+     */
+    ActionId evaluate(unsigned long tick) const;
+
+    /**
+     * @brief Turn condition profiling on or off (off by default); turning it on clears the counts
+     * and measures the cost of the timer, which is subtracted from every timed call
+     */
+    void setProfiling(bool enabled);
+
+    /**
+     * @brief Get the profile of every condition, indexed by condition id
+     */
+    const std::vector<ConditionProfile> &getConditionProfiles() const { return profiles; }
+
+    /**
+     * @brief Print one line per condition: calls, cache hits, true rate and average cost
+     * @param out Stream to print to
+     */
+    void printProfile(std::ostream &out) const;
+
+    /**
+     * @brief Write the condition profile to a text file, one condition per line
+     * @param filename File to write
+     * @return True if the file was written
+     */
+    bool saveProfile(const std::string &filename) const;
+
+    /**
+     * @brief Replace the condition profile with one saved by saveProfile
+     * @param filename File to read
+     * @return True if it was read; false if it is missing or was saved from a tree with other conditions
+     */
+    bool loadProfile(const std::string &filename);
+
+    /**
+     * @brief Make a copy with its guarded children reordered by the measured condition profile
+     * @param log Optional stream that gets one line per reordered group
+     * @return Copy of this tree that makes the same decisions with less expected condition cost
+     *
+     * Guarded children are the links of a priority node, and chains of branches where each false
+     * child is another branch nothing else points to (an if / else if list). The first true condition
+     * wins, so only runs of conditions that can never be true together may swap; those are conditions
+     * whose FeatureTests read the same feature with ranges that do not overlap. Within a run, children
+     * are sorted by average cost over how often they were true, which minimizes the expected cost of
+     * reaching the winner. A run only changes if that saves at least a fifth of its expected cost
+     * and more than timing noise (50 ns a decision), so conditions that measure about the same are
+     * not shuffled from run to run. Runs without a profile are left alone.
+     * Run it offline, after profiling the tree on a simulated run, or on a profile loaded with
+     * loadProfile.
+     */
+    CompiledDecisionTree reordered(std::ostream *log = nullptr) const;
+
+    /**
+     * @brief Check whether every condition has a FeatureTest, so evaluateBatch can be used
+     */
+    bool canEvaluateBatch() const;
+
+    /**
+     * @brief Decide for many agents at once from their features
+     * @param features One row per agent, with the columns the FeatureTests refer to
+     * @param actions Receives the decided action of each agent (one per row)
+     * @param seed Seed for random nodes; an agent's draw depends only on the seed, the agent and the node
+     * @param workers Optional pool to split the agents across threads
+     */
+    void evaluateBatch(const DecisionFeatures &features, ActionId *actions, unsigned seed,
+                       WorkerPool *workers = nullptr) const;
+
+    /**
+     * @brief Get the number of compiled nodes
+     */
+    size_t getNodeCount() const { return nodes.size(); }
+
+    /**
+     * @brief Get the number of distinct conditions
+     */
+    size_t getConditionCount() const { return conditions.size(); }
+
+    /**
+     * @brief Get the number of distinct actions
+     */
+    size_t getActionCount() const { return actionNodes.size(); }
+
+    // Building, used by the DecisionNode classes while compiling
+
+    /**
+     * @brief Get the node index a source node was compiled to
+     * @param source Source node
+     * @return Node index, or -1 if it has not been compiled yet
+     */
+    int findNode(const DecisionNode *source) const;
+
+    /**
+     * @brief Remember the node index a source node was compiled to, so shared subtrees are compiled once
+     * @param source Source node
+     * @param index Node index
+     */
+    void rememberNode(const DecisionNode *source, int index) { compiledNodes[source] = index; }
+
+    /**
+     * @brief Add a condition to the condition table
+     * @param condition Condition function
+     * @param name Condition name, for profiling
+     * @param batchTest Same condition as a feature test, for evaluateBatch (optional)
+     * @return Condition id; conditions with the same FeatureTest get the same id
+     */
+    int addCondition(const std::function<bool()> &condition, const std::string &name,
+                     const FeatureTest &batchTest = FeatureTest());
+
+    /**
+     * @brief Add an action leaf; leaves with the same action share one node
+     * @param action Action id
+     * @return Node index
+     */
+    int addAction(ActionId action);
+
+    /**
+     * @brief Add a branch node; its children are set once they are compiled
+     * @param conditionId Condition deciding between the children
+     * @return Node index
+     */
+    int addBranch(int conditionId);
+
+    /**
+     * @brief Set the children of a branch node
+     */
+    void setBranchChildren(int node, int trueChild, int falseChild);
+
+    /**
+     * @brief Add a random node with room for its links
+     * @param childCount Number of children
+     * @param totalWeight Sum of the child weights
+     * @return Node index
+     */
+    int addRandom(int childCount, float totalWeight);
+
+    /**
+     * @brief Add a priority node with room for its links
+     * @param childCount Number of children
+     * @return Node index
+     */
+    int addPriority(int childCount);
+
+    /**
+     * @brief Set one link of a random or priority node
+     * @param node Node index
+     * @param slot Link number within the node
+     * @param link Child, condition and cumulative weight
+     */
+    void setLink(int node, int slot, const CompiledDecisionLink &link);
+
+    /**
+     * @brief Set the node a priority node falls back to when no condition is true
+     */
+    void setFallback(int node, int fallback) { nodes[node].falseChild = fallback; }
+
+private:
+    std::vector<CompiledDecisionNode> nodes;        // Node 0 is the root
+    std::vector<CompiledDecisionLink> links;        // Children of random and priority nodes
+    std::vector<std::function<bool()>> conditions;  // Indexed by condition id
+    std::vector<FeatureTest> batchTests;            // Indexed by condition id
+    // Written by evaluate, so a tree is evaluated by one thread at a time
+    mutable std::vector<ConditionProfile> profiles;  // Indexed by condition id
+    mutable std::vector<unsigned long> cachedTicks; // Tick each cached result belongs to, indexed by condition id
+    mutable std::vector<uint8_t> cachedResults;     // Cached results, indexed by condition id
+    bool profiling = false;
+    double timerOverhead = 0; // Measured time of an empty timed interval, subtracted from each profiled call
+    std::unordered_map<ActionId, int> actionNodes;  // Leaf node of each action
+    std::unordered_map<const DecisionNode *, int> compiledNodes; // Source node to node index
+
+    /**
+     * @brief Walk the tree from the root to an action (see evaluate)
+     * @param tick Tick for the condition cache
+     * @param useCache False to call every condition reached
+     */
+    ActionId walk(unsigned long tick, bool useCache) const;
+
+    /**
+     * @brief Evaluate one condition, through the cache and the profiler
+     */
+    bool testCondition(int condition, unsigned long tick, bool useCache) const;
+
+    /**
+     * @brief Check whether two conditions can never be true at the same time
+     * @return True if both FeatureTests read the same feature and accept disjoint ranges
+     */
+    bool exclusive(int first, int second) const;
+
+    /**
+     * @brief Sort each run of mutually exclusive guards by cost over true rate (see reordered)
+     * @param guarded Children with their conditions, in evaluation order
+     * @param log Optional stream for the new order
+     * @return True if any guard moved
+     */
+    bool reorderGuarded(std::vector<CompiledDecisionLink> &guarded, std::ostream *log) const;
+
+    /**
+     * @brief Decide for the agents in [begin, end) (see evaluateBatch)
+     */
+    void evaluateRange(const DecisionFeatures &features, int begin, int end, ActionId *actions, unsigned seed) const;
+};
+
+#endif // COMPILED_DECISION_TREE_H
@@ -0,0 +1,105 @@
+/**
+ * @file DecisionFeatures.h
+ * @brief Defines DecisionFeatures, per-agent decision inputs stored as columns, and FeatureTest.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#ifndef DECISION_FEATURES_H
+#define DECISION_FEATURES_H
+
+#include <vector>
+
+/**
+ * @struct FeatureTest
+ * @brief A condition written as "feature compared to threshold", so it can be tested for many agents at once
+ */
+struct FeatureTest
+{
+    enum class Comparison
+    {
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL
+    };
+
+    int feature = -1; // Feature column, or -1 if the condition has no batch form
+    Comparison comparison = Comparison::LESS;
+    float threshold = 0;
+
+    FeatureTest() = default;
+
+    /**
+     * @brief Constructor
+     * @param feature Feature column to test
+     * @param comparison How the feature is compared
+     * @param threshold Value it is compared to
+     */
+    FeatureTest(int feature, Comparison comparison, float threshold)
+        : feature(feature), comparison(comparison), threshold(threshold) {}
+
+    /**
+     * @brief Check whether this test was set
+     */
+    bool isSet() const { return feature >= 0; }
+};
+
+/**
+ * @class DecisionFeatures
+ * @brief Decision inputs for a group of agents, one contiguous column per feature (structure of arrays).
+ *
+ * A FeatureTest reads one column, so testing it for every agent at a node is a tight loop over
+ * floats instead of one std::function call per agent.
+ */
+class DecisionFeatures
+{
+public:
+    /**
+     * @brief Constructor
+     * @param featureCount Number of feature columns
+     * @param agentCount Number of agents (rows)
+     */
+    DecisionFeatures(int featureCount = 0, int agentCount = 0) { resize(featureCount, agentCount); }
+
+    /**
+     * @brief Change the number of features and agents; values are reset to zero
+     */
+    void resize(int featureCount, int agentCount)
+    {
+        this->featureCount = featureCount;
+        this->agentCount = agentCount;
+        values.assign(static_cast<size_t>(featureCount) * agentCount, 0.0f);
+    }
+
+    /**
+     * @brief Get the values of one feature for all agents
+     */
+    float *column(int feature) { return values.data() + static_cast<size_t>(feature) * agentCount; }
+    const float *column(int feature) const { return values.data() + static_cast<size_t>(feature) * agentCount; }
+
+    /**
+     * @brief Set one agent's value of a feature
+     */
+    void set(int feature, int agent, float value) { column(feature)[agent] = value; }
+
+    /**
+     * @brief Get one agent's value of a feature
+     */
+    float get(int feature, int agent) const { return column(feature)[agent]; }
+
+    int getFeatureCount() const { return featureCount; }
+    int getAgentCount() const { return agentCount; }
+
+private:
+    std::vector<float> values; // values[feature * agentCount + agent]
+    int featureCount = 0;
+    int agentCount = 0;
+};
+
+#endif // DECISION_FEATURES_H
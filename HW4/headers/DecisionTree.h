@@ -22,9 +22,11 @@
 #include <functional>
 #include <string>
 #include <vector>
+#include <random>
 #include <SFML/System.hpp>
 #include "Kinematic.h"   // For access to the agent's kinematic data
 #include "Environment.h" // For environment state checking
+#include "CompiledDecisionTree.h"
 
 /**
  * @class DecisionNode
@@ -37,9 +39,9 @@ public:
 
     /**
      * @brief Pure virtual function to make a decision
-     * @return A string representing the action to take
+     * @return Id of the action to take (see ActionRegistry)
      */
-    virtual std::string makeDecision() = 0;
+    virtual ActionId makeDecision() = 0;
 
     /**
      * @brief Get the name of the decision node for debugging
@@ -47,8 +49,31 @@ public:
      */
     std::string getName() const { return nodeName; }
 
+    /**
+     * @brief Compile this node and its subtree into a flat tree
+     * @param compiled Tree being built
+     * @return Index of this node in the compiled tree
+     */
+    int compile(CompiledDecisionTree &compiled) const
+    {
+        int index = compiled.findNode(this);
+        if (index < 0)
+        {
+            index = compileNode(compiled);
+            compiled.rememberNode(this, index);
+        }
+        return index;
+    }
+
 protected:
     std::string nodeName = "Unnamed Node";
+
+    /**
+     * @brief Append this node, then its children, to a compiled tree
+     * @param compiled Tree being built
+     * @return Index of this node in the compiled tree
+     */
+    virtual int compileNode(CompiledDecisionTree &compiled) const = 0;
 };
 
 /**
@@ -64,21 +89,27 @@ public:
      */
     ActionNode(const std::string &actionName)
     {
-        actionValue = actionName;
+        actionValue = ActionRegistry::intern(actionName);
         nodeName = "Action: " + actionName;
     }
 
     /**
      * @brief Return the action
-     * @return The action name
+     * @return The action id
      */
-    std::string makeDecision() override
+    ActionId makeDecision() override
     {
         return actionValue;
     }
 
+protected:
+    int compileNode(CompiledDecisionTree &compiled) const override
+    {
+        return compiled.addAction(actionValue);
+    }
+
 private:
-    std::string actionValue;
+    ActionId actionValue;
 };
 
 /**
@@ -94,12 +125,15 @@ public:
      * @param trueNode Node to evaluate if condition is true
      * @param falseNode Node to evaluate if condition is false
      * @param conditionName Human-readable name for the condition
+     * @param batchTest The same condition as a feature test, for batch evaluation (optional)
      */
     DecisionBranch(
         std::function<bool()> condition,
         std::shared_ptr<DecisionNode> trueNode,
         std::shared_ptr<DecisionNode> falseNode,
-        const std::string &conditionName) : condition(condition), trueNode(trueNode), falseNode(falseNode)
+        const std::string &conditionName,
+        const FeatureTest &batchTest = FeatureTest()) : condition(condition), trueNode(trueNode), falseNode(falseNode),
+                                                        conditionName(conditionName), batchTest(batchTest)
     {
         nodeName = "Decision: " + conditionName;
     }
@@ -108,7 +142,7 @@ public:
      * @brief Make a decision by evaluating the condition
      * @return Result of the selected branch
      */
-    std::string makeDecision() override
+    ActionId makeDecision() override
     {
         if (condition())
         {
@@ -120,10 +154,15 @@ public:
         }
     }
 
+protected:
+    int compileNode(CompiledDecisionTree &compiled) const override;
+
 private:
     std::function<bool()> condition;
     std::shared_ptr<DecisionNode> trueNode;
     std::shared_ptr<DecisionNode> falseNode;
+    std::string conditionName;
+    FeatureTest batchTest;
 };
 
 /**
@@ -158,11 +197,11 @@ public:
      * @brief Make a random decision by selecting a child based on weights
      * @return Result of the selected child
      */
-    std::string makeDecision() override
+    ActionId makeDecision() override
     {
         if (children.empty())
         {
-            return "Idle"; // Default action if no children
+            return ActionRegistry::IDLE; // Default action if no children
         }
 
         // Generate a random value
@@ -183,6 +222,9 @@ public:
         return children.back()->makeDecision();
     }
 
+protected:
+    int compileNode(CompiledDecisionTree &compiled) const override;
+
 private:
     std::vector<std::shared_ptr<DecisionNode>> children;
     std::vector<float> weights;
@@ -210,19 +252,22 @@ public:
      * @param condition Function that returns true if this child should be selected
      * @param child Node to evaluate if condition is true
      * @param conditionName Human-readable name for the condition
+     * @param batchTest The same condition as a feature test, for batch evaluation (optional)
      */
-    void addChild(std::function<bool()> condition, std::shared_ptr<DecisionNode> child, const std::string &conditionName)
+    void addChild(std::function<bool()> condition, std::shared_ptr<DecisionNode> child, const std::string &conditionName,
+                  const FeatureTest &batchTest = FeatureTest())
     {
         conditions.push_back(condition);
         children.push_back(child);
         conditionNames.push_back(conditionName);
+        batchTests.push_back(batchTest);
     }
 
     /**
      * @brief Make a decision by evaluating conditions in order
      * @return Result of the first child whose condition is true
      */
-    std::string makeDecision() override
+    ActionId makeDecision() override
     {
         for (size_t i = 0; i < children.size(); i++)
         {
@@ -233,22 +278,44 @@ public:
         }
 
         // If no condition is true, return a default action
-        return "Idle";
+        return ActionRegistry::IDLE;
     }
 
+protected:
+    int compileNode(CompiledDecisionTree &compiled) const override;
+
 private:
     std::vector<std::function<bool()>> conditions;
     std::vector<std::shared_ptr<DecisionNode>> children;
     std::vector<std::string> conditionNames;
+    std::vector<FeatureTest> batchTests;
 };
 
 /**
  * @class EnvironmentState
  * @brief Stores and computes environmental state information for use in decisions
+ *
+ * update only copies the kinematic data. The features that cost something (obstacle distance,
+ * room, path status) are computed the first time a decision asks for them and kept until the
+ * character moves, so a tree only pays for the predicates it actually evaluates.
  */
 class EnvironmentState
 {
 public:
+    /**
+     * @brief Feature columns written by writeFeatures, for batch decisions
+     */
+    enum Feature
+    {
+        FEATURE_SPEED,             // Current speed
+        FEATURE_OBSTACLE_DISTANCE, // Distance to the nearest obstacle (up to 200)
+        FEATURE_ROOM,              // Current room id
+        FEATURE_IDLE_TIME,         // Seconds idle, 0 while moving
+        FEATURE_CHANGE_TARGET,     // 1 if shouldChangeTarget, else 0
+        FEATURE_RANDOM_ROLL,       // Random integer in [0, 100), drawn when the row is written
+        FEATURE_COUNT
+    };
+
     /**
      * @brief Constructor
      * @param character Reference to the character's kinematic data
@@ -258,8 +325,15 @@ public:
 
     /**
      * @brief Update the state based on current conditions
+     * @param deltaTime Simulated time since the last update; the state and idle timers advance by it
+     * @note Features that depend on the position are marked stale if the character moved
      */
-    void update();
+    void update(float deltaTime);
+
+    /**
+     * @brief Get the number of updates so far, so callers can tell decision ticks apart
+     */
+    unsigned long getUpdateCount() const { return updateCount; }
 
     // State parameters for decision making
 
@@ -391,27 +465,53 @@ public:
      */
     void resetStateTimer();
 
+    /**
+     * @brief Write this character's features into one row of a batch
+     * @param features Batch with FEATURE_COUNT columns
+     * @param agent Row to write
+     */
+    void writeFeatures(DecisionFeatures &features, int agent) const;
+
 private:
     const Kinematic &character;
     const Environment &environment;
 
+    /**
+     * @brief Bits of features that must be recomputed before they are read
+     */
+    enum StaleFeature : unsigned
+    {
+        STALE_OBSTACLE = 1, // distanceToNearestObstacle
+        STALE_ROOM = 2,     // currentRoom
+        STALE_PATH = 4,     // reachedWaypoint and completedPath
+        STALE_ALL = 7
+    };
+
     // Cached state variables
     sf::Vector2f position;
     sf::Vector2f velocity;
     float speed;
-    float distanceToNearestObstacle;
-    int currentRoom;
-    sf::Clock stateTimer;
-    bool reachedWaypoint;
-    bool completedPath;
+    mutable float distanceToNearestObstacle;
+    mutable int currentRoom;
+    float stateTime; // Simulated seconds since resetStateTimer
+    mutable bool reachedWaypoint;
+    mutable bool completedPath;
     bool pathBlocked;
     sf::Vector2f currentTarget;
-    sf::Clock idleTimer;
+    float idleTime; // Simulated seconds since the character stopped
     bool isIdle;
+    mutable unsigned staleFeatures; // StaleFeature bits
+    unsigned long updateCount;
+    mutable std::minstd_rand rollGenerator; // For FEATURE_RANDOM_ROLL, so rows can be written on any thread
 
     // Helper methods for state calculation
-    void findNearestObstacle();
-    int determineCurrentRoom();
+    void findNearestObstacle() const;
+    int determineCurrentRoom() const;
+
+    // Lazy accessors: compute the feature if it is stale, then return it
+    float getObstacleDistance() const;
+    int getCurrentRoom() const;
+    bool getReachedWaypoint() const;
 };
 
 /**
@@ -435,9 +535,62 @@ public:
 
     /**
      * @brief Make a decision by evaluating the tree
-     * @return String representing the decided action
+     * @return Id of the decided action; ActionRegistry::getName gives its name
+     */
+    virtual ActionId makeDecision();
+
+    /**
+     * @brief Compile the tree into a flat node array; makeDecision uses it from then on
+     * @note Compile again after changing the tree. Conditions are copied, so whatever they capture
+     * must outlive this tree, as it must for the linked nodes.
+     */
+    void compile();
+
+    /**
+     * @brief Get the compiled tree (empty until compile is called)
+     * @return Compiled tree
+     */
+    const CompiledDecisionTree &getCompiledTree() const { return compiledTree; }
+
+    /**
+     * @brief Count calls, true results and time per condition of the compiled tree (off by default)
+     * @param enabled True to profile; turning it on clears the counts
+     */
+    void setProfiling(bool enabled) { compiledTree.setProfiling(enabled); }
+
+    /**
+     * @brief Print the condition profile of the compiled tree
+     * @param out Stream to print to
+     */
+    void printProfile(std::ostream &out) const { compiledTree.printProfile(out); }
+
+    /**
+     * @brief Save the compiled tree's condition profile (see CompiledDecisionTree::saveProfile)
+     */
+    bool saveConditionProfile(const std::string &filename) const { return compiledTree.saveProfile(filename); }
+
+    /**
+     * @brief Load a saved condition profile into the compiled tree, for optimizeConditionOrder
+     * @return False if there is no saved profile or it belongs to a different tree
+     */
+    bool loadConditionProfile(const std::string &filename) { return compiledTree.loadProfile(filename); }
+
+    /**
+     * @brief Reorder the compiled tree's exclusive conditions from the profile gathered or loaded so far
+     * @param log Optional stream that gets one line per reordered group
+     * @note Decisions do not change; see CompiledDecisionTree::reordered. Compiling again undoes it.
+     */
+    void optimizeConditionOrder(std::ostream *log = nullptr) { compiledTree = compiledTree.reordered(log); }
+
+    /**
+     * @brief Decide for many agents at once with the compiled tree
+     * @param features One row of features per agent
+     * @param actions Receives one action per agent
+     * @param seed Seed for random nodes
+     * @param workers Optional pool to split the agents across threads
+     * @return False if the tree is not compiled or a condition has no FeatureTest
      */
-    virtual std::string makeDecision();
+    bool makeDecisions(const DecisionFeatures &features, ActionId *actions, unsigned seed, WorkerPool *workers = nullptr) const;
 
     /**
      * @brief Build a complex decision tree for controlling character movement
@@ -456,6 +609,7 @@ public:
 private:
     std::shared_ptr<DecisionNode> rootNode;
     EnvironmentState &environmentState;
+    CompiledDecisionTree compiledTree; // Flat copy of rootNode's tree, if compiled
 
     // Helper method to create nodes for specific targets
     std::shared_ptr<DecisionNode> createTargetSubtree(const sf::Vector2f &target);
@@ -17,7 +17,10 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
 #include "Graph.h"
+#include "SpatialHash.h"
 
 /**
  * @class Environment
@@ -32,7 +35,8 @@ public:
      * @param environmentHeight Height of the environment.
      */
     Environment(int environmentWidth, int environmentHeight)
-        : environmentWidth(environmentWidth), environmentHeight(environmentHeight) {}
+        : environmentWidth(environmentWidth), environmentHeight(environmentHeight),
+          roomIndex(environmentWidth, environmentHeight), obstacleIndex(environmentWidth, environmentHeight) {}
 
     /**
      * @brief Add a room to the environment.
@@ -40,6 +44,7 @@ public:
      */
     void addRoom(const sf::FloatRect &room)
     {
+        roomIndex.insert(rooms.size(), room);
         rooms.push_back(room);
     }
 
@@ -49,6 +54,7 @@ public:
      */
     void addObstacle(const sf::FloatRect &obstacle)
     {
+        obstacleIndex.insert(obstacles.size(), obstacle);
         obstacles.push_back(obstacle);
     }
 
@@ -146,6 +152,144 @@ public:
         return graph;
     }
 
+    /**
+     * @brief Create a graph whose cells adapt to the layout using quadtree subdivision.
+     * @param minCellSize Size of the finest cells, used next to obstacles, walls and doorways.
+     * @param maxCellSize Size of the coarsest cells, used in open room interiors.
+     * @return Graph with one vertex at the center of every walkable leaf cell.
+     * @note A cell is split while it touches an obstacle or is not fully inside a single room.
+     * Finest cells use the same rule as createGraph (the center must be walkable), so the walkable
+     * area matches createGraph(minCellSize). Leaves that share an edge or corner are connected when
+     * there is line of sight between their centers. maxCellSize is rounded down to minCellSize times
+     * a power of two.
+     */
+    Graph createAdaptiveGraph(int minCellSize, int maxCellSize)
+    {
+        // Cells are measured in units of the finest grid
+        struct Cell
+        {
+            int column, row, span;
+        };
+
+        int fineColumns = environmentWidth / minCellSize;
+        int fineRows = environmentHeight / minCellSize;
+        int rootSpan = 1;
+        while (rootSpan * 2 * minCellSize <= maxCellSize)
+        {
+            rootSpan *= 2;
+        }
+
+        // Subdivide the root cells until every leaf is uniformly walkable
+        std::vector<Cell> leaves;
+        std::vector<Cell> pending;
+        for (int row = 0; row < fineRows; row += rootSpan)
+        {
+            for (int col = 0; col < fineColumns; col += rootSpan)
+            {
+                pending.push_back({col, row, rootSpan});
+            }
+        }
+
+        while (!pending.empty())
+        {
+            Cell cell = pending.back();
+            pending.pop_back();
+
+            if (cell.column >= fineColumns || cell.row >= fineRows)
+            {
+                continue;
+            }
+
+            float size = static_cast<float>(cell.span * minCellSize);
+            sf::FloatRect bounds(cell.column * minCellSize, cell.row * minCellSize, size, size);
+
+            if (cell.span == 1)
+            {
+                if (!isObstacle({bounds.left + size / 2, bounds.top + size / 2}))
+                {
+                    leaves.push_back(cell);
+                }
+                continue;
+            }
+
+            // Cells hanging over the edge of the fine grid are always split
+            bool insideGrid = cell.column + cell.span <= fineColumns && cell.row + cell.span <= fineRows;
+            CellCoverage coverage = insideGrid ? classifyCell(bounds) : CellCoverage::Mixed;
+            if (coverage == CellCoverage::Free)
+            {
+                leaves.push_back(cell);
+            }
+            else if (coverage == CellCoverage::Mixed)
+            {
+                int half = cell.span / 2;
+                pending.push_back({cell.column, cell.row, half});
+                pending.push_back({cell.column + half, cell.row, half});
+                pending.push_back({cell.column, cell.row + half, half});
+                pending.push_back({cell.column + half, cell.row + half, half});
+            }
+        }
+
+        // Number leaves in reading order
+        std::sort(leaves.begin(), leaves.end(), [](const Cell &a, const Cell &b)
+                  { return a.row != b.row ? a.row < b.row : a.column < b.column; });
+
+        // Record which leaf owns every fine cell
+        std::vector<int> owner(fineColumns * fineRows, -1);
+        std::vector<sf::Vector2f> positions;
+        for (int leaf = 0; leaf < static_cast<int>(leaves.size()); leaf++)
+        {
+            const Cell &cell = leaves[leaf];
+            for (int row = cell.row; row < cell.row + cell.span; row++)
+            {
+                for (int col = cell.column; col < cell.column + cell.span; col++)
+                {
+                    owner[row * fineColumns + col] = leaf;
+                }
+            }
+            positions.push_back({(cell.column + cell.span * 0.5f) * minCellSize,
+                                 (cell.row + cell.span * 0.5f) * minCellSize});
+        }
+
+        Graph graph(leaves.size());
+        graph.setVertexPositions(positions);
+        vertexPositions = positions;
+
+        // Connect each leaf to the leaves found on the ring of fine cells around it
+        std::vector<int> lastSeenBy(leaves.size(), -1);
+        for (int leaf = 0; leaf < static_cast<int>(leaves.size()); leaf++)
+        {
+            const Cell &cell = leaves[leaf];
+            for (int row = cell.row - 1; row <= cell.row + cell.span; row++)
+            {
+                for (int col = cell.column - 1; col <= cell.column + cell.span; col++)
+                {
+                    bool onRing = row == cell.row - 1 || row == cell.row + cell.span ||
+                                  col == cell.column - 1 || col == cell.column + cell.span;
+                    if (!onRing || row < 0 || row >= fineRows || col < 0 || col >= fineColumns)
+                    {
+                        continue;
+                    }
+
+                    int neighbor = owner[row * fineColumns + col];
+                    if (neighbor < 0 || lastSeenBy[neighbor] == leaf)
+                    {
+                        continue;
+                    }
+                    lastSeenBy[neighbor] = leaf;
+
+                    if (hasLineOfSight(positions[leaf], positions[neighbor]))
+                    {
+                        float distanceX = positions[neighbor].x - positions[leaf].x;
+                        float distanceY = positions[neighbor].y - positions[leaf].y;
+                        graph.addEdge(leaf, neighbor, std::sqrt(distanceX * distanceX + distanceY * distanceY));
+                    }
+                }
+            }
+        }
+
+        return graph;
+    }
+
     /**
      * @brief Check if there's a clear line of sight between two points.
      * @param from Start point.
@@ -198,6 +342,88 @@ public:
         return true; // No obstacles in the way
     }
 
+    /**
+     * @brief Fast line of sight test that clips the segment against obstacle rectangles directly.
+     * @param from Start point.
+     * @param to End point.
+     * @param clearance Extra distance to keep from obstacles and room walls.
+     * @return True if the segment stays inside a single room and misses every (inflated) obstacle.
+     * @note Unlike hasLineOfSight, this does not walk the segment pixel by pixel, so its cost depends
+     * only on the number of obstacles. Segments that cross between room rectangles are treated as blocked.
+     */
+    bool hasClearPath(const sf::Vector2f &from, const sf::Vector2f &to, float clearance = 0.0f) const
+    {
+        // Both endpoints must lie in the same (shrunken) room; rooms are convex, so the whole segment does too
+        bool insideRoom = roomIndex.visitPoint(from, [&](int index)
+                                               {
+                                                   const sf::FloatRect &room = rooms[index];
+                                                   sf::FloatRect inner(room.left + clearance, room.top + clearance,
+                                                                       room.width - 2 * clearance, room.height - 2 * clearance);
+                                                   return inner.contains(from) && inner.contains(to); });
+
+        if (!insideRoom)
+        {
+            return false;
+        }
+
+        // The segment must not touch any obstacle grown by the clearance
+        bool blocked = obstacleIndex.visitSegment(from, to, clearance, [&](int index)
+                                                  {
+                                                      const sf::FloatRect &obstacle = obstacles[index];
+                                                      sf::FloatRect inflated(obstacle.left - clearance, obstacle.top - clearance,
+                                                                             obstacle.width + 2 * clearance, obstacle.height + 2 * clearance);
+                                                      return segmentIntersectsRect(from, to, inflated); });
+
+        return !blocked;
+    }
+
+    /**
+     * @brief Check if a line segment intersects an axis-aligned rectangle (Liang-Barsky clipping).
+     * @param from Start point of the segment.
+     * @param to End point of the segment.
+     * @param rect Rectangle to test against.
+     * @return True if any part of the segment lies inside the rectangle.
+     */
+    static bool segmentIntersectsRect(const sf::Vector2f &from, const sf::Vector2f &to, const sf::FloatRect &rect)
+    {
+        float tEnter = 0.0f;
+        float tExit = 1.0f;
+
+        const float start[2] = {from.x, from.y};
+        const float delta[2] = {to.x - from.x, to.y - from.y};
+        const float minimum[2] = {rect.left, rect.top};
+        const float maximum[2] = {rect.left + rect.width, rect.top + rect.height};
+
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (std::abs(delta[axis]) < 1e-6f)
+            {
+                // Segment is parallel to this slab, so it must start inside it
+                if (start[axis] < minimum[axis] || start[axis] > maximum[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            float t1 = (minimum[axis] - start[axis]) / delta[axis];
+            float t2 = (maximum[axis] - start[axis]) / delta[axis];
+            if (t1 > t2)
+            {
+                std::swap(t1, t2);
+            }
+
+            tEnter = std::max(tEnter, t1);
+            tExit = std::min(tExit, t2);
+            if (tEnter > tExit)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     /**
      * @brief Convert a point in the environment to a vertex in the graph.
      * @param point The point to convert.
@@ -253,27 +479,89 @@ public:
             return true;
         }
 
-        // Check if point is inside any obstacle
-        for (const auto &obstacle : obstacles)
+        // Check if point is inside any obstacle in its cell
+        if (obstacleIndex.visitPoint(point, [&](int index)
+                                     { return obstacles[index].contains(point); }))
+        {
+            return true;
+        }
+
+        // Check if point is outside all rooms in its cell
+        bool insideAnyRoom = roomIndex.visitPoint(point, [&](int index)
+                                                  { return rooms[index].contains(point); });
+
+        return !insideAnyRoom; // If not inside any room, it's considered an obstacle
+    }
+
+    /**
+     * @brief Check if a circle overlaps any obstacle.
+     * @param center Center of the circle.
+     * @param radius Radius of the circle.
+     * @return True if any obstacle rectangle is closer than the radius to the center.
+     */
+    bool isObstacleWithinRadius(const sf::Vector2f &center, float radius) const
+    {
+        return obstacleIndex.visitRadius(center, radius, [&](int index)
+                                         {
+                                             const sf::FloatRect &obstacle = obstacles[index];
+                                             float nearestX = std::clamp(center.x, obstacle.left, obstacle.left + obstacle.width);
+                                             float nearestY = std::clamp(center.y, obstacle.top, obstacle.top + obstacle.height);
+                                             float dx = center.x - nearestX;
+                                             float dy = center.y - nearestY;
+                                             return dx * dx + dy * dy <= radius * radius; });
+    }
+
+    /**
+     * @brief Replace the vertex positions used by pointToVertex and vertexToPoint.
+     * @param positions Vertex positions of a graph built for this environment.
+     * @note Used when the graph comes from a prebuilt asset instead of createGraph.
+     */
+    void setVertexPositions(const std::vector<sf::Vector2f> &positions)
+    {
+        vertexPositions = positions;
+    }
+
+    /**
+     * @brief Get the width of the environment.
+     */
+    int getWidth() const { return environmentWidth; }
+
+    /**
+     * @brief Get the height of the environment.
+     */
+    int getHeight() const { return environmentHeight; }
+
+    /**
+     * @brief Hash the layout of the environment (FNV-1a over dimensions, rooms and obstacles).
+     * @param gridSize Grid cell size the graph is built with.
+     * @return Hash that changes whenever a graph built with createGraph(gridSize) could change.
+     */
+    uint64_t layoutHash(int gridSize) const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const void *bytes, size_t count)
         {
-            if (obstacle.contains(point))
+            for (size_t i = 0; i < count; i++)
             {
-                return true;
+                hash ^= static_cast<const unsigned char *>(bytes)[i];
+                hash *= 1099511628211ull;
             }
-        }
+        };
 
-        // Check if point is outside all rooms
-        bool insideAnyRoom = false;
-        for (const auto &room : rooms)
+        mix(&environmentWidth, sizeof(environmentWidth));
+        mix(&environmentHeight, sizeof(environmentHeight));
+        mix(&gridSize, sizeof(gridSize));
+        for (const auto *rects : {&rooms, &obstacles})
         {
-            if (room.contains(point))
+            size_t count = rects->size();
+            mix(&count, sizeof(count));
+            for (const auto &rect : *rects)
             {
-                insideAnyRoom = true;
-                break;
+                float values[] = {rect.left, rect.top, rect.width, rect.height};
+                mix(values, sizeof(values));
             }
         }
-
-        return !insideAnyRoom; // If not inside any room, it's considered an obstacle
+        return hash;
     }
 
     /**
@@ -304,9 +592,64 @@ public:
     }
 
 private:
+    /**
+     * @brief How much of a cell is walkable.
+     */
+    enum class CellCoverage
+    {
+        Free,    // Inside one room and touching no obstacle
+        Blocked, // Outside every room or covered by an obstacle
+        Mixed    // Anything else; needs to be split
+    };
+
+    /**
+     * @brief Classify a cell for adaptive graph subdivision.
+     * @param bounds Cell rectangle.
+     * @return Coverage of the cell.
+     */
+    CellCoverage classifyCell(const sf::FloatRect &bounds) const
+    {
+        auto covers = [&bounds](const sf::FloatRect &rect)
+        {
+            return rect.left <= bounds.left && rect.top <= bounds.top &&
+                   rect.left + rect.width >= bounds.left + bounds.width &&
+                   rect.top + rect.height >= bounds.top + bounds.height;
+        };
+
+        bool touchesObstacle = false;
+        bool coveredByObstacle = obstacleIndex.visitRect(bounds, [&](int index)
+                                                         {
+                                                             if (obstacles[index].intersects(bounds))
+                                                             {
+                                                                 touchesObstacle = true;
+                                                             }
+                                                             return covers(obstacles[index]); });
+        if (coveredByObstacle)
+        {
+            return CellCoverage::Blocked;
+        }
+
+        bool touchesRoom = false;
+        bool insideRoom = roomIndex.visitRect(bounds, [&](int index)
+                                              {
+                                                  if (rooms[index].intersects(bounds))
+                                                  {
+                                                      touchesRoom = true;
+                                                  }
+                                                  return covers(rooms[index]); });
+        if (!touchesRoom)
+        {
+            return CellCoverage::Blocked;
+        }
+
+        return (insideRoom && !touchesObstacle) ? CellCoverage::Free : CellCoverage::Mixed;
+    }
+
     int environmentWidth, environmentHeight;   // Dimensions of the environment
     std::vector<sf::FloatRect> rooms;          // List of rooms in the environment
     std::vector<sf::FloatRect> obstacles;      // List of obstacles in the environment
+    SpatialHash roomIndex;                     // Broadphase over rooms
+    SpatialHash obstacleIndex;                 // Broadphase over obstacles
     std::vector<sf::Vector2f> vertexPositions; // Positions of vertices in the graph
     int gridColumns;                           // Number of columns in the grid
 };
@@ -0,0 +1,155 @@
+/**
+ * @file FixedTimestep.h
+ * @brief Defines the FixedTimestep class, which turns variable frame times into fixed simulation steps.
+ *
+ * Resources Used:
+ * - Glenn Fiedler, "Fix Your Timestep!": https://gafferongames.com/post/fix_your_timestep/
+ * - Book: "Game Programming Patterns" by Robert Nystrom, Game Loop chapter
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <SFML/System.hpp>
+#include <cmath>
+
+/**
+ * @class FixedTimestep
+ * @brief Accumulates frame time and hands it out as whole simulation steps of a fixed size.
+ *
+ * Each frame the main loop passes the measured frame time to advance and runs the returned
+ * number of steps with getStep() as the delta time. The leftover time stays in the accumulator;
+ * getAlpha() says how far rendering is between the last two simulation states. A slow frame
+ * runs at most maxSteps catch-up steps and drops the rest, so the simulation slows down instead
+ * of falling behind. Uncapped mode ignores the frame time and runs one step per call.
+ */
+class FixedTimestep
+{
+public:
+    /**
+     * @brief Constructor to set the step size and catch-up limit.
+     * @param step Simulation step in seconds.
+     * @param maxSteps Most steps a single frame can run.
+     */
+    explicit FixedTimestep(float step = 1.0f / 60.0f, int maxSteps = 5)
+        : step(step),
+          maxSteps(maxSteps < 1 ? 1 : maxSteps),
+          accumulator(0),
+          uncapped(false),
+          stepCount(0),
+          droppedStepCount(0)
+    {
+    }
+
+    /**
+     * @brief Add a frame's time to the accumulator.
+     * @param frameTime Measured time since the last frame, in seconds.
+     * @return Number of simulation steps to run this frame.
+     */
+    int advance(float frameTime)
+    {
+        if (uncapped)
+        {
+            stepCount++;
+            return 1;
+        }
+
+        accumulator += frameTime > 0 ? frameTime : 0;
+        int steps = static_cast<int>(accumulator / step);
+        accumulator -= steps * step;
+
+        // Drop whatever the catch-up limit does not allow
+        if (steps > maxSteps)
+        {
+            droppedStepCount += steps - maxSteps;
+            steps = maxSteps;
+        }
+        if (accumulator < 0)
+        {
+            accumulator = 0; // Float rounding
+        }
+
+        stepCount += steps;
+        return steps;
+    }
+
+    /**
+     * @brief Get the fixed step in seconds; pass it as the delta time of every step.
+     */
+    float getStep() const { return step; }
+
+    /**
+     * @brief Get how far rendering is between the previous and current simulation state.
+     * @return Blend factor in [0, 1); always 1 in uncapped mode.
+     */
+    float getAlpha() const { return uncapped ? 1.0f : accumulator / step; }
+
+    /**
+     * @brief Turn uncapped mode on or off.
+     * @param enabled True to run one step per advance call regardless of the frame time.
+     */
+    void setUncapped(bool enabled)
+    {
+        uncapped = enabled;
+        accumulator = 0;
+    }
+
+    /**
+     * @brief Check whether uncapped mode is on.
+     */
+    bool isUncapped() const { return uncapped; }
+
+    /**
+     * @brief Get the total number of steps handed out so far.
+     */
+    long long getStepCount() const { return stepCount; }
+
+    /**
+     * @brief Get the number of steps dropped because a frame hit the catch-up limit.
+     */
+    long long getDroppedStepCount() const { return droppedStepCount; }
+
+    /**
+     * @brief Blend two positions.
+     * @param from Previous position.
+     * @param to Current position.
+     * @param alpha Blend factor from getAlpha().
+     */
+    static sf::Vector2f lerp(sf::Vector2f from, sf::Vector2f to, float alpha)
+    {
+        return from + (to - from) * alpha;
+    }
+
+    /**
+     * @brief Blend two angles in degrees the short way around.
+     * @param from Previous angle.
+     * @param to Current angle.
+     * @param alpha Blend factor from getAlpha().
+     */
+    static float lerpAngle(float from, float to, float alpha)
+    {
+        float difference = std::fmod(to - from, 360.0f);
+        if (difference > 180.0f)
+        {
+            difference -= 360.0f;
+        }
+        if (difference < -180.0f)
+        {
+            difference += 360.0f;
+        }
+        return from + difference * alpha;
+    }
+
+private:
+    float step;                 // Simulation step in seconds
+    int maxSteps;               // Most steps per frame
+    float accumulator;          // Frame time not yet simulated
+    bool uncapped;              // One step per call, ignoring frame time
+    long long stepCount;        // Steps handed out
+    long long droppedStepCount; // Steps dropped by the catch-up limit
+};
+
+#endif // FIXED_TIMESTEP_H
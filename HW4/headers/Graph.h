@@ -99,6 +99,15 @@ public:
         return vertexPositions[vertex];
     }
 
+    /**
+     * @brief Get the positions of all vertices.
+     * @return Vector of positions, indexed by vertex.
+     */
+    const std::vector<sf::Vector2f> &getVertexPositions() const
+    {
+        return vertexPositions;
+    }
+
 private:
     std::vector<std::vector<std::pair<int, float>>> adjacencyList; // Adjacency list representation
     std::vector<sf::Vector2f> vertexPositions;                     // Positions of vertices in 2D space
@@ -113,6 +113,34 @@ namespace Heuristics
         return euclidean(current, goal, graph);
     }
 
+    /**
+     * @brief Landmark (ALT) heuristic using precomputed shortest path distances.
+     * @param current Current vertex.
+     * @param goal Goal vertex.
+     * @param distances Distances from each landmark to every vertex, landmark-major.
+     * @param landmarkCount Number of landmarks in the table.
+     * @param vertexCount Number of vertices per landmark row.
+     * @return Lower bound on the cost from current to goal.
+     *
+     * By the triangle inequality d(L, goal) <= d(L, current) + d(current, goal), so
+     * d(L, goal) - d(L, current) never overestimates, even on directed graphs.
+     */
+    inline float landmark(int current, int goal, const float *distances, int landmarkCount, int vertexCount)
+    {
+        float estimate = 0.0f;
+        for (int i = 0; i < landmarkCount; i++)
+        {
+            const float *row = distances + static_cast<size_t>(i) * vertexCount;
+            // Skip landmarks that cannot reach one of the vertices
+            if (std::isinf(row[current]) || std::isinf(row[goal]))
+            {
+                continue;
+            }
+            estimate = std::max(estimate, row[goal] - row[current]);
+        }
+        return estimate;
+    }
+
     /**
      * @brief Intentionally inadmissible heuristic that overestimates costs.
      * @param current Current vertex.
@@ -44,14 +44,14 @@ public:
 
     /**
      * @brief Make a decision based on the current state
-     * @return String representing the decided action
+     * @return Id of the decided action
      */
-    std::string makeDecision() override
+    ActionId makeDecision() override
     {
         if (!dtRoot)
         {
             std::cerr << "LearnedDecisionTree has no root node!" << std::endl;
-            return "Idle"; // Default action if no tree is defined
+            return ActionRegistry::IDLE; // Default action if no tree is defined
         }
 
         // Get the current state vector
@@ -63,7 +63,7 @@ public:
         // Log the decision for debugging
         std::cout << "Learned DT decision: " << decision << std::endl;
 
-        return decision;
+        return ActionRegistry::intern(decision);
     }
 
 private:
@@ -249,7 +249,7 @@ private:
         }
 
         // Add the current action as a feature for more context
-        stateVector.push_back(monster.getCurrentAction());
+        stateVector.push_back(monster.getCurrentActionName());
 
         // Log the state vector for debugging
         std::cout << "State vector: ";
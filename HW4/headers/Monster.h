@@ -23,16 +23,19 @@
 #include <vector>
 #include <string>
 #include <fstream>
-#include <deque>
 #include <memory>
 #include "headers/Kinematic.h"
 #include "headers/Arrive.h"
 #include "headers/Align.h"
 #include "headers/Graph.h"
 #include "headers/Environment.h"
+#include "headers/SpriteBatch.h"
+#include "headers/BreadcrumbTrails.h"
+#include "headers/ActionRegistry.h"
 
 // Forward declarations
 class BehaviorTree;
+class BehaviorInstance;
 class DecisionTree;
 class EnvironmentState;
 
@@ -60,6 +63,10 @@ public:
     Monster(sf::Vector2f startPosition, sf::Texture &texture, Environment &environment, Graph &graph,
             sf::Color color = sf::Color::Red);
 
+    // The behavior tree instance points back at this monster, so it stays where it was made
+    Monster(const Monster &) = delete;
+    Monster &operator=(const Monster &) = delete;
+
     /**
      * @brief Set the control type for the monster
      * @param type Type of control (behavior tree or decision tree)
@@ -74,9 +81,10 @@ public:
 
     /**
      * @brief Set the monster's behavior tree
-     * @param tree Pointer to the behavior tree
+     * @param tree Pointer to the behavior tree; it can be shared with other monsters, since this
+     * monster's progress through it is kept in its own BehaviorInstance
      */
-    void setBehaviorTree(std::shared_ptr<BehaviorTree> tree);
+    void setBehaviorTree(std::shared_ptr<const BehaviorTree> tree);
 
     /**
      * @brief Set the monster's decision tree
@@ -93,15 +101,43 @@ public:
      * @brief Update the monster's position and behavior
      * @param deltaTime Time since last update
      * @return True if the monster has caught the player
+     * @note Same as think followed by act
      */
     bool update(float deltaTime);
 
+    /**
+     * @brief First half of update: tick the behavior tree or decision tree
+     * @param deltaTime Time since last update
+     * @note Only changes this monster's decision state; moves and path requests are queued for act,
+     * so different monsters can think on different threads at the same time
+     */
+    void think(float deltaTime);
+
+    /**
+     * @brief Second half of update: run what think decided, then drop breadcrumbs and move the sprite
+     * @param deltaTime Time since last update
+     * @return True if the monster has caught the player
+     */
+    bool act(float deltaTime);
+
+    /**
+     * @brief Place the sprite between the state before and after the last update
+     * @param alpha Blend factor from FixedTimestep::getAlpha(); 1 draws the latest state
+     */
+    void interpolate(float alpha);
+
     /**
      * @brief Draw the monster and any visual debugging information
      * @param window Window to draw to
      */
     void draw(sf::RenderWindow &window);
 
+    /**
+     * @brief Add the monster, its breadcrumbs and its path to a sprite batch
+     * @param batch Batch collecting this frame's sprites, dots and lines
+     */
+    void draw(SpriteBatch &batch) const;
+
     /**
      * @brief Get the monster's position
      * @return Current position vector
@@ -128,10 +164,10 @@ public:
 
     /**
      * @brief Execute a specific action
-     * @param action The action to execute
+     * @param action Id of the action to execute
      * @param deltaTime Time since last update
      */
-    void executeAction(const std::string &action, float deltaTime);
+    void executeAction(ActionId action, float deltaTime);
 
     /**
      * @brief Check if the monster has caught the player
@@ -189,9 +225,15 @@ public:
 
     /**
      * @brief Get the current action
-     * @return String representation of the current action
+     * @return Id of the current action, or ActionRegistry::NONE before the first one
+     */
+    ActionId getCurrentAction() const { return currentAction; }
+
+    /**
+     * @brief Get the name of the current action, for logging and recorded data
+     * @return Name of the current action (empty before the first one)
      */
-    std::string getCurrentAction() const { return currentAction; }
+    const std::string &getCurrentActionName() const { return ActionRegistry::getName(currentAction); }
 
     /**
      * @brief Create an environment state for this monster
@@ -203,6 +245,8 @@ private:
     // Entity data
     Kinematic monsterKinematic;
     sf::Sprite sprite;
+    sf::Vector2f previousPosition; // Position before the last update, for interpolation
+    float previousOrientation;     // Orientation before the last update, for interpolation
     sf::Vector2f startPosition;
 
     // Movement behaviors
@@ -222,12 +266,13 @@ private:
 
     // Control
     ControlType controlType;
-    std::shared_ptr<BehaviorTree> behaviorTree;
+    std::shared_ptr<BehaviorInstance> behaviorTree; // This monster's state in its behavior tree
     std::shared_ptr<DecisionTree> decisionTree;
+    ActionId decidedAction; // Action the decision tree chose in think, run by act
     float currentDeltaTime;
 
     // State tracking
-    std::string currentAction;
+    ActionId currentAction;
     float timeInCurrentAction;
     float catchDistance;
 
@@ -246,11 +291,12 @@ private:
     void flee(float deltaTime);
 
     // Collision handling
+    static constexpr float COLLISION_RADIUS = 5.0f; // Clearance the monster's body keeps from obstacles
     bool checkCollision(sf::Vector2f proposedPosition) const;
     sf::Vector2f findValidMovement(sf::Vector2f currentPos, sf::Vector2f proposedPos) const;
 
     // Breadcrumb trail for visualization
-    std::deque<sf::CircleShape> breadcrumbs;
+    BreadcrumbTrails breadcrumbs; // Ring buffer of breadcrumb positions
     int breadcrumbCounter;
     sf::Color breadcrumbColor;
     static constexpr int BREADCRUMB_INTERVAL = 120; // More frequent breadcrumbs than before
@@ -0,0 +1,513 @@
+/**
+ * @file NavAsset.h
+ * @brief Defines a binary navigation asset that is memory mapped instead of rebuilt.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ * - POSIX mmap(2) manual page
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef NAV_ASSET_H
+#define NAV_ASSET_H
+
+#include "Graph.h"
+#include "Environment.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @struct NavAssetHeader
+ * @brief Fixed size header at the start of every navigation asset file.
+ *
+ * All sections are stored in native byte order and start on an 8-byte boundary,
+ * so they can be used in place straight from the mapping:
+ * - edge offsets: uint32 x (vertexCount + 1), CSR row starts
+ * - edge targets: int32 x edgeCount
+ * - edge weights: float x edgeCount
+ * - positions: float x 2 x vertexCount
+ * - occupancy: one bit per grid cell, set if the cell center is blocked
+ * - landmark ids: int32 x landmarkCount (optional)
+ * - landmark distances: float x landmarkCount x vertexCount, landmark-major (optional)
+ */
+struct NavAssetHeader
+{
+    char magic[4];              // Always "NAVG"
+    uint32_t version;           // Format version, bumped on any layout change
+    uint64_t layoutHash;        // Environment::layoutHash of the level this was built from
+    uint64_t fileSize;          // Total size in bytes, used to detect truncated files
+    uint32_t vertexCount;       // Number of vertices
+    uint32_t edgeCount;         // Number of directed edges
+    uint32_t gridColumns;       // Occupancy grid width in cells
+    uint32_t gridRows;          // Occupancy grid height in cells
+    float cellSize;             // Grid cell size in pixels
+    uint32_t landmarkCount;     // Number of landmark distance tables (0 if none)
+    uint64_t edgeOffsetsOffset; // Byte offset of each section from the start of the file
+    uint64_t edgeTargetsOffset;
+    uint64_t edgeWeightsOffset;
+    uint64_t positionsOffset;
+    uint64_t occupancyOffset;
+    uint64_t landmarkIdsOffset;
+    uint64_t landmarkDistancesOffset;
+};
+
+/**
+ * @class NavAsset
+ * @brief Read-only view of a navigation asset mapped into memory.
+ */
+class NavAsset
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    NavAsset() = default;
+    ~NavAsset() { unload(); }
+
+    NavAsset(const NavAsset &) = delete;
+    NavAsset &operator=(const NavAsset &) = delete;
+
+    /**
+     * @brief Map an asset file into memory and validate it.
+     * @param path File to load.
+     * @param expectedLayoutHash Layout hash the asset must have been built from.
+     * @return True if the file was mapped and matches the current format and level.
+     */
+    bool load(const std::string &path, uint64_t expectedLayoutHash)
+    {
+        unload();
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < static_cast<off_t>(sizeof(NavAssetHeader)))
+        {
+            close(fd);
+            return false;
+        }
+
+        void *mapping = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // The mapping stays valid after the descriptor is closed
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+
+        data = static_cast<const uint8_t *>(mapping);
+        dataSize = fileInfo.st_size;
+
+        if (!validate(expectedLayoutHash))
+        {
+            unload();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Release the mapping.
+     */
+    void unload()
+    {
+        if (data)
+        {
+            munmap(const_cast<uint8_t *>(data), dataSize);
+        }
+        data = nullptr;
+        dataSize = 0;
+    }
+
+    /**
+     * @brief Check whether an asset is currently mapped.
+     */
+    bool isLoaded() const { return data != nullptr; }
+
+    const NavAssetHeader &header() const { return *reinterpret_cast<const NavAssetHeader *>(data); }
+    int vertexCount() const { return header().vertexCount; }
+    int landmarkCount() const { return header().landmarkCount; }
+
+    const uint32_t *edgeOffsets() const { return section<uint32_t>(header().edgeOffsetsOffset); }
+    const int32_t *edgeTargets() const { return section<int32_t>(header().edgeTargetsOffset); }
+    const float *edgeWeights() const { return section<float>(header().edgeWeightsOffset); }
+    const float *positions() const { return section<float>(header().positionsOffset); }
+    const int32_t *landmarkIds() const { return section<int32_t>(header().landmarkIdsOffset); }
+    const float *landmarkDistances() const { return section<float>(header().landmarkDistancesOffset); }
+
+    /**
+     * @brief Get the position of a vertex straight from the mapping.
+     * @param vertex Vertex index.
+     * @return Position of the vertex.
+     */
+    sf::Vector2f getVertexPosition(int vertex) const
+    {
+        const float *xy = positions() + 2 * vertex;
+        return {xy[0], xy[1]};
+    }
+
+    /**
+     * @brief Check the occupancy bit of a grid cell.
+     * @param column Grid column.
+     * @param row Grid row.
+     * @return True if the cell center is blocked (cells outside the grid are blocked).
+     */
+    bool isCellBlocked(int column, int row) const
+    {
+        const NavAssetHeader &h = header();
+        if (column < 0 || row < 0 || column >= static_cast<int>(h.gridColumns) || row >= static_cast<int>(h.gridRows))
+        {
+            return true;
+        }
+        int cell = row * h.gridColumns + column;
+        return (section<uint8_t>(h.occupancyOffset)[cell / 8] >> (cell % 8)) & 1;
+    }
+
+    /**
+     * @brief Build a Graph from the mapped CSR arrays.
+     * @return Graph with the same edges and vertex positions as the asset.
+     * @note This only copies the arrays into adjacency lists; no obstacle or line of sight work is redone.
+     */
+    Graph toGraph() const
+    {
+        int n = vertexCount();
+        Graph graph(n);
+
+        const uint32_t *offsets = edgeOffsets();
+        const int32_t *targets = edgeTargets();
+        const float *weights = edgeWeights();
+        for (int vertex = 0; vertex < n; vertex++)
+        {
+            for (uint32_t edge = offsets[vertex]; edge < offsets[vertex + 1]; edge++)
+            {
+                graph.addEdge(vertex, targets[edge], weights[edge]);
+            }
+        }
+
+        graph.setVertexPositions(vertexPositions());
+        return graph;
+    }
+
+    /**
+     * @brief Copy the vertex positions out of the mapping.
+     * @return Vector of vertex positions.
+     */
+    std::vector<sf::Vector2f> vertexPositions() const
+    {
+        std::vector<sf::Vector2f> result(vertexCount());
+        for (int vertex = 0; vertex < vertexCount(); vertex++)
+        {
+            result[vertex] = getVertexPosition(vertex);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Load the asset for an environment, rebuilding and saving it if missing or stale.
+     * @param path Asset file to use.
+     * @param environment Environment the graph is for; its vertex positions are set from the asset.
+     * @param gridSize Grid cell size passed to createGraph.
+     * @param landmarkCount Number of landmark distance tables to precompute when rebuilding.
+     * @return Graph for the environment.
+     */
+    Graph loadOrBuild(const std::string &path, Environment &environment, int gridSize, int landmarkCount = 0)
+    {
+        if (load(path, environment.layoutHash(gridSize)))
+        {
+            std::cout << "Loaded navigation asset " << path << std::endl;
+            environment.setVertexPositions(vertexPositions());
+            return toGraph();
+        }
+
+        std::cout << "Building navigation asset " << path << "..." << std::endl;
+        Graph graph = environment.createGraph(gridSize);
+        if (!save(path, graph, environment, gridSize, landmarkCount) ||
+            !load(path, environment.layoutHash(gridSize)))
+        {
+            std::cerr << "Failed to write navigation asset " << path << std::endl;
+        }
+        return graph;
+    }
+
+    /**
+     * @brief Write a graph and its environment to an asset file.
+     * @param path File to write.
+     * @param graph Graph built by Environment::createGraph.
+     * @param environment Environment the graph was built from.
+     * @param gridSize Grid cell size passed to createGraph.
+     * @param landmarkCount Number of landmark distance tables to precompute (0 for none).
+     * @return True if the file was written.
+     */
+    static bool save(const std::string &path, const Graph &graph, const Environment &environment,
+                     int gridSize, int landmarkCount = 0)
+    {
+        NavAssetHeader h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "NAVG", 4);
+        h.version = VERSION;
+        h.layoutHash = environment.layoutHash(gridSize);
+        h.vertexCount = graph.size();
+        h.gridColumns = environment.getWidth() / gridSize;
+        h.gridRows = environment.getHeight() / gridSize;
+        h.cellSize = static_cast<float>(gridSize);
+
+        // Flatten adjacency lists into CSR arrays
+        std::vector<uint32_t> offsets(graph.size() + 1, 0);
+        std::vector<int32_t> targets;
+        std::vector<float> weights;
+        for (int vertex = 0; vertex < graph.size(); vertex++)
+        {
+            for (const auto &edge : graph.getNeighbors(vertex))
+            {
+                targets.push_back(edge.first);
+                weights.push_back(edge.second);
+            }
+            offsets[vertex + 1] = targets.size();
+        }
+        h.edgeCount = targets.size();
+
+        std::vector<float> positions;
+        for (int vertex = 0; vertex < graph.size(); vertex++)
+        {
+            sf::Vector2f position = graph.getVertexPosition(vertex);
+            positions.push_back(position.x);
+            positions.push_back(position.y);
+        }
+
+        std::vector<uint8_t> occupancy((h.gridColumns * h.gridRows + 7) / 8, 0);
+        for (uint32_t row = 0; row < h.gridRows; row++)
+        {
+            for (uint32_t column = 0; column < h.gridColumns; column++)
+            {
+                sf::Vector2f center((column + 0.5f) * gridSize, (row + 0.5f) * gridSize);
+                if (environment.isObstacle(center))
+                {
+                    int cell = row * h.gridColumns + column;
+                    occupancy[cell / 8] |= 1 << (cell % 8);
+                }
+            }
+        }
+
+        std::vector<int32_t> landmarks;
+        std::vector<float> landmarkDistances;
+        computeLandmarks(graph, landmarkCount, landmarks, landmarkDistances);
+        h.landmarkCount = landmarks.size();
+
+        // Lay out the sections after the header
+        uint64_t cursor = align(sizeof(NavAssetHeader));
+        auto place = [&cursor](uint64_t bytes)
+        {
+            uint64_t offset = cursor;
+            cursor = align(cursor + bytes);
+            return offset;
+        };
+        h.edgeOffsetsOffset = place(offsets.size() * sizeof(uint32_t));
+        h.edgeTargetsOffset = place(targets.size() * sizeof(int32_t));
+        h.edgeWeightsOffset = place(weights.size() * sizeof(float));
+        h.positionsOffset = place(positions.size() * sizeof(float));
+        h.occupancyOffset = place(occupancy.size());
+        h.landmarkIdsOffset = place(landmarks.size() * sizeof(int32_t));
+        h.landmarkDistancesOffset = place(landmarkDistances.size() * sizeof(float));
+        h.fileSize = cursor;
+
+        std::vector<uint8_t> buffer(h.fileSize, 0);
+        std::memcpy(buffer.data(), &h, sizeof(h));
+        auto copyTo = [&buffer](uint64_t offset, const void *source, size_t bytes)
+        {
+            if (bytes > 0)
+            {
+                std::memcpy(buffer.data() + offset, source, bytes);
+            }
+        };
+        copyTo(h.edgeOffsetsOffset, offsets.data(), offsets.size() * sizeof(uint32_t));
+        copyTo(h.edgeTargetsOffset, targets.data(), targets.size() * sizeof(int32_t));
+        copyTo(h.edgeWeightsOffset, weights.data(), weights.size() * sizeof(float));
+        copyTo(h.positionsOffset, positions.data(), positions.size() * sizeof(float));
+        copyTo(h.occupancyOffset, occupancy.data(), occupancy.size());
+        copyTo(h.landmarkIdsOffset, landmarks.data(), landmarks.size() * sizeof(int32_t));
+        copyTo(h.landmarkDistancesOffset, landmarkDistances.data(), landmarkDistances.size() * sizeof(float));
+
+        // Write to a temporary file and rename so readers never map a half-written asset
+        std::string temporaryPath = path + ".tmp";
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+        file.close();
+        if (!file)
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    const uint8_t *data = nullptr; // Start of the mapping
+    size_t dataSize = 0;           // Size of the mapping in bytes
+
+    template <typename T>
+    const T *section(uint64_t offset) const
+    {
+        return reinterpret_cast<const T *>(data + offset);
+    }
+
+    static uint64_t align(uint64_t value)
+    {
+        return (value + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    /**
+     * @brief Check the header and that every section lies inside the file.
+     * @param expectedLayoutHash Layout hash the asset must match.
+     * @return True if the asset can be used.
+     */
+    bool validate(uint64_t expectedLayoutHash) const
+    {
+        const NavAssetHeader &h = header();
+        if (std::memcmp(h.magic, "NAVG", 4) != 0 || h.version != VERSION ||
+            h.layoutHash != expectedLayoutHash || h.fileSize != dataSize)
+        {
+            return false;
+        }
+
+        auto fits = [this](uint64_t offset, uint64_t bytes)
+        {
+            return offset % 8 == 0 && offset <= dataSize && bytes <= dataSize - offset;
+        };
+        uint64_t n = h.vertexCount;
+        if (!fits(h.edgeOffsetsOffset, (n + 1) * sizeof(uint32_t)) ||
+            !fits(h.edgeTargetsOffset, h.edgeCount * sizeof(int32_t)) ||
+            !fits(h.edgeWeightsOffset, h.edgeCount * sizeof(float)) ||
+            !fits(h.positionsOffset, 2 * n * sizeof(float)) ||
+            !fits(h.occupancyOffset, (static_cast<uint64_t>(h.gridColumns) * h.gridRows + 7) / 8) ||
+            !fits(h.landmarkIdsOffset, h.landmarkCount * sizeof(int32_t)) ||
+            !fits(h.landmarkDistancesOffset, h.landmarkCount * n * sizeof(float)))
+        {
+            return false;
+        }
+
+        // Edge ranges must be monotonic and every target must be a valid vertex
+        const uint32_t *offsets = edgeOffsets();
+        if (offsets[0] != 0 || offsets[n] != h.edgeCount)
+        {
+            return false;
+        }
+        for (uint64_t vertex = 0; vertex < n; vertex++)
+        {
+            if (offsets[vertex] > offsets[vertex + 1])
+            {
+                return false;
+            }
+        }
+        const int32_t *targets = edgeTargets();
+        for (uint32_t edge = 0; edge < h.edgeCount; edge++)
+        {
+            if (targets[edge] < 0 || static_cast<uint32_t>(targets[edge]) >= n)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Single-source shortest path distances from one vertex.
+     * @param graph The graph to search.
+     * @param source Source vertex.
+     * @return Distance to every vertex (infinity if unreachable).
+     */
+    static std::vector<float> distancesFrom(const Graph &graph, int source)
+    {
+        std::vector<float> distance(graph.size(), std::numeric_limits<float>::infinity());
+        std::priority_queue<std::pair<float, int>,
+                            std::vector<std::pair<float, int>>,
+                            std::greater<std::pair<float, int>>>
+            fringe;
+
+        distance[source] = 0.0f;
+        fringe.push({0.0f, source});
+        while (!fringe.empty())
+        {
+            auto [cost, current] = fringe.top();
+            fringe.pop();
+            if (cost > distance[current])
+            {
+                continue;
+            }
+            for (const auto &edge : graph.getNeighbors(current))
+            {
+                float newCost = cost + edge.second;
+                if (newCost < distance[edge.first])
+                {
+                    distance[edge.first] = newCost;
+                    fringe.push({newCost, edge.first});
+                }
+            }
+        }
+        return distance;
+    }
+
+    /**
+     * @brief Pick landmarks by farthest-point selection and compute their distance tables.
+     * @param graph The graph to search.
+     * @param count Number of landmarks wanted.
+     * @param landmarks Output landmark vertex ids.
+     * @param distances Output distances, landmark-major.
+     */
+    static void computeLandmarks(const Graph &graph, int count,
+                                 std::vector<int32_t> &landmarks, std::vector<float> &distances)
+    {
+        // Start from the first vertex that has any edges
+        int next = -1;
+        for (int vertex = 0; vertex < graph.size() && next < 0; vertex++)
+        {
+            if (!graph.getNeighbors(vertex).empty())
+            {
+                next = vertex;
+            }
+        }
+
+        std::vector<float> closest(graph.size(), std::numeric_limits<float>::infinity());
+        while (next >= 0 && static_cast<int>(landmarks.size()) < count)
+        {
+            std::vector<float> fromLandmark = distancesFrom(graph, next);
+            landmarks.push_back(next);
+            distances.insert(distances.end(), fromLandmark.begin(), fromLandmark.end());
+
+            // Next landmark is the reachable vertex farthest from all chosen landmarks
+            next = -1;
+            float farthest = 0.0f;
+            for (int vertex = 0; vertex < graph.size(); vertex++)
+            {
+                closest[vertex] = std::min(closest[vertex], fromLandmark[vertex]);
+                if (closest[vertex] > farthest && closest[vertex] < std::numeric_limits<float>::infinity())
+                {
+                    farthest = closest[vertex];
+                    next = vertex;
+                }
+            }
+        }
+    }
+};
+
+#endif // NAV_ASSET_H
@@ -0,0 +1,90 @@
+/**
+ * @file PathSmoothing.h
+ * @brief Defines path smoothing (string pulling) for grid paths.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef PATH_SMOOTHING_H
+#define PATH_SMOOTHING_H
+
+#include "Environment.h"
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * @namespace PathSmoothing
+ * @brief Contains functions that remove redundant waypoints from grid paths.
+ */
+namespace PathSmoothing
+{
+
+    /**
+     * @brief Greedy line of sight smoothing anchored at an arbitrary start point.
+     * @param start Point the agent is currently at (not included in the result).
+     * @param waypoints Waypoints produced by the pathfinder.
+     * @param environment Environment used for line of sight checks.
+     * @param clearance Distance to keep from obstacles when skipping waypoints.
+     * @return Minimal list of waypoints, always ending at the last input waypoint.
+     *
+     * From the current anchor, the farthest waypoint that is still directly reachable
+     * is kept and becomes the next anchor. Each waypoint is tested at most once as a
+     * success and once per kept waypoint as a failure, so the cost is linear in the
+     * path length. If an anchor cannot see its next waypoint at all, that waypoint is
+     * kept unchanged, so the result never cuts through obstacles the grid path avoided.
+     */
+    inline std::vector<sf::Vector2f> smoothFrom(const sf::Vector2f &start,
+                                                const std::vector<sf::Vector2f> &waypoints,
+                                                const Environment &environment,
+                                                float clearance = 0.0f)
+    {
+        std::vector<sf::Vector2f> smoothed;
+        sf::Vector2f anchor = start;
+        size_t next = 0;
+
+        while (next < waypoints.size())
+        {
+            // Extend as far along the path as the anchor can see
+            size_t farthest = next;
+            while (farthest + 1 < waypoints.size() &&
+                   environment.hasClearPath(anchor, waypoints[farthest + 1], clearance))
+            {
+                farthest++;
+            }
+
+            smoothed.push_back(waypoints[farthest]);
+            anchor = waypoints[farthest];
+            next = farthest + 1;
+        }
+
+        return smoothed;
+    }
+
+    /**
+     * @brief Greedy line of sight smoothing that keeps the first waypoint.
+     * @param waypoints Waypoints produced by the pathfinder.
+     * @param environment Environment used for line of sight checks.
+     * @param clearance Distance to keep from obstacles when skipping waypoints.
+     * @return Minimal list of waypoints with the same start and end as the input.
+     */
+    inline std::vector<sf::Vector2f> smooth(const std::vector<sf::Vector2f> &waypoints,
+                                            const Environment &environment,
+                                            float clearance = 0.0f)
+    {
+        if (waypoints.size() <= 2)
+        {
+            return waypoints;
+        }
+
+        std::vector<sf::Vector2f> rest(waypoints.begin() + 1, waypoints.end());
+        std::vector<sf::Vector2f> smoothed = smoothFrom(waypoints.front(), rest, environment, clearance);
+        smoothed.insert(smoothed.begin(), waypoints.front());
+        return smoothed;
+    }
+};
+
+#endif // PATH_SMOOTHING_H
@@ -0,0 +1,220 @@
+/**
+ * @file SpatialHash.h
+ * @brief Defines a uniform grid broadphase for axis-aligned rectangles.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ * - Book: "Real-Time Collision Detection" by Christer Ericson
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @class SpatialHash
+ * @brief Buckets rectangles into fixed size cells so queries only look at nearby rectangles.
+ *
+ * Each rectangle is stored in every cell it overlaps. Rectangles or queries that reach
+ * past the indexed area are clamped to the border cells, so the border rows and columns
+ * extend to infinity and nothing is ever missed.
+ * Queries are read-only and may see the same rectangle more than once when it spans
+ * several cells; visitors must tolerate that.
+ */
+class SpatialHash
+{
+public:
+    /**
+     * @brief Constructor for a spatial hash covering a fixed area.
+     * @param width Width of the indexed area.
+     * @param height Height of the indexed area.
+     * @param cellSize Size of each grid cell.
+     */
+    SpatialHash(float width, float height, float cellSize = 64.0f)
+        : cellSize(cellSize),
+          columns(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+          rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+          cells(columns * rows) {}
+
+    /**
+     * @brief Add a rectangle to every cell it overlaps.
+     * @param index Index of the rectangle in the caller's list.
+     * @param rect Rectangle bounds.
+     */
+    void insert(int index, const sf::FloatRect &rect)
+    {
+        int minColumn = columnOf(rect.left);
+        int maxColumn = columnOf(rect.left + rect.width);
+        int minRow = rowOf(rect.top);
+        int maxRow = rowOf(rect.top + rect.height);
+
+        for (int row = minRow; row <= maxRow; row++)
+        {
+            for (int column = minColumn; column <= maxColumn; column++)
+            {
+                cells[row * columns + column].push_back(index);
+            }
+        }
+    }
+
+    /**
+     * @brief Visit the rectangles stored in the cell containing a point.
+     * @param point Query point.
+     * @param visitor Called with each rectangle index; return true to stop early.
+     * @return True if the visitor stopped the query.
+     */
+    template <typename Visitor>
+    bool visitPoint(const sf::Vector2f &point, Visitor visitor) const
+    {
+        for (int index : cells[rowOf(point.y) * columns + columnOf(point.x)])
+        {
+            if (visitor(index))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Visit the rectangles in every cell within a radius of a point.
+     * @param center Center of the query circle.
+     * @param radius Radius of the query circle.
+     * @param visitor Called with each rectangle index; return true to stop early.
+     * @return True if the visitor stopped the query.
+     */
+    template <typename Visitor>
+    bool visitRadius(const sf::Vector2f &center, float radius, Visitor visitor) const
+    {
+        return visitArea(center.x - radius, center.y - radius, center.x + radius, center.y + radius, visitor);
+    }
+
+    /**
+     * @brief Visit the rectangles in every cell overlapping a query rectangle.
+     * @param rect Query rectangle.
+     * @param visitor Called with each rectangle index; return true to stop early.
+     * @return True if the visitor stopped the query.
+     */
+    template <typename Visitor>
+    bool visitRect(const sf::FloatRect &rect, Visitor visitor) const
+    {
+        return visitArea(rect.left, rect.top, rect.left + rect.width, rect.top + rect.height, visitor);
+    }
+
+    /**
+     * @brief Visit the rectangles in every cell a (thickened) segment passes through.
+     * @param from Start point of the segment.
+     * @param to End point of the segment.
+     * @param padding Half thickness of the segment.
+     * @param visitor Called with each rectangle index; return true to stop early.
+     * @return True if the visitor stopped the query.
+     */
+    template <typename Visitor>
+    bool visitSegment(const sf::Vector2f &from, const sf::Vector2f &to, float padding, Visitor visitor) const
+    {
+        float dy = to.y - from.y;
+        int minRow = rowOf(std::min(from.y, to.y) - padding);
+        int maxRow = rowOf(std::max(from.y, to.y) + padding);
+
+        for (int row = minRow; row <= maxRow; row++)
+        {
+            // Clip the segment to the row band (grown by the padding) to find its x extent; the
+            // border rows also hold everything clamped into them, so their bands are unbounded
+            const float infinity = std::numeric_limits<float>::infinity();
+            float bandTop = row == 0 ? -infinity : row * cellSize - padding;
+            float bandBottom = row == rows - 1 ? infinity : (row + 1) * cellSize + padding;
+            float tStart = 0.0f;
+            float tEnd = 1.0f;
+            if (std::abs(dy) > 1e-6f)
+            {
+                float t1 = (bandTop - from.y) / dy;
+                float t2 = (bandBottom - from.y) / dy;
+                tStart = std::max(tStart, std::min(t1, t2));
+                tEnd = std::min(tEnd, std::max(t1, t2));
+            }
+            if (tStart > tEnd)
+            {
+                // Every row in range meets the segment, so this only happens by rounding at a band edge
+                std::swap(tStart, tEnd);
+            }
+
+            float x1 = from.x + (to.x - from.x) * tStart;
+            float x2 = from.x + (to.x - from.x) * tEnd;
+            int minColumn = columnOf(std::min(x1, x2) - padding);
+            int maxColumn = columnOf(std::max(x1, x2) + padding);
+            for (int column = minColumn; column <= maxColumn; column++)
+            {
+                for (int index : cells[row * columns + column])
+                {
+                    if (visitor(index))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Collect the rectangles within a radius of a point.
+     * @param center Center of the query circle.
+     * @param radius Radius of the query circle.
+     * @return Sorted list of candidate rectangle indices without duplicates.
+     */
+    std::vector<int> queryRadius(const sf::Vector2f &center, float radius) const
+    {
+        std::vector<int> result;
+        visitRadius(center, radius, [&result](int index)
+                    {
+                        result.push_back(index);
+                        return false; });
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+private:
+    float cellSize;                      // Size of each grid cell
+    int columns, rows;                   // Grid dimensions in cells
+    std::vector<std::vector<int>> cells; // Rectangle indices per cell, row-major
+
+    int columnOf(float x) const
+    {
+        return std::clamp(static_cast<int>(std::floor(x / cellSize)), 0, columns - 1);
+    }
+
+    int rowOf(float y) const
+    {
+        return std::clamp(static_cast<int>(std::floor(y / cellSize)), 0, rows - 1);
+    }
+
+    template <typename Visitor>
+    bool visitArea(float left, float top, float right, float bottom, Visitor &visitor) const
+    {
+        for (int row = rowOf(top); row <= rowOf(bottom); row++)
+        {
+            for (int column = columnOf(left); column <= columnOf(right); column++)
+            {
+                for (int index : cells[row * columns + column])
+                {
+                    if (visitor(index))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif // SPATIAL_HASH_H
@@ -0,0 +1,225 @@
+/**
+ * @file SpriteBatch.h
+ * @brief Defines the SpriteBatch class, which collects sprites, dots and lines into a few vertex arrays.
+ *
+ * Resources Used:
+ * - SFML Official Tutorials: https://www.sfml-dev.org/learn.php
+ * - SFML Tutorial, Designing your own entities with vertex arrays: https://www.sfml-dev.org/tutorials/2.6/graphics-vertex-array.php
+ *
+ * Author: Miles Hollifield
+ * Date: 3/20/2025
+ */
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <array>
+
+/**
+ * @class SpriteBatch
+ * @brief Batches a frame's sprites, breadcrumbs and path lines so they take a handful of draw calls.
+ *
+ * Sprites are written as textured quads into one vertex array per texture. Dots (breadcrumbs,
+ * waypoints, graph vertices) become small triangle fans in one untextured array, and line
+ * segments go into one line array. draw() issues one call for the lines, one for the dots and
+ * one per texture, in that order, so sprites stay on top.
+ *
+ * Filling the batch does not need a window, so headless runs can fill it and skip draw().
+ */
+class SpriteBatch
+{
+public:
+    static constexpr int DOT_SEGMENTS = 8; // Triangles per dot; plenty for small markers
+
+    /**
+     * @brief Remove everything added since the last clear; keeps the allocated memory.
+     */
+    void clear()
+    {
+        for (auto &layer : layers)
+        {
+            layer.second.clear();
+        }
+        dots.clear();
+        lines.clear();
+    }
+
+    /**
+     * @brief Add a sprite as one textured quad, using its transform, texture rect and color.
+     * @param sprite Sprite to add; sprites without a texture are skipped.
+     */
+    void addSprite(const sf::Sprite &sprite)
+    {
+        const sf::Texture *texture = sprite.getTexture();
+        if (!texture)
+        {
+            return;
+        }
+
+        const sf::Transform &transform = sprite.getTransform();
+        sf::IntRect rect = sprite.getTextureRect();
+        float width = static_cast<float>(std::abs(rect.width));
+        float height = static_cast<float>(std::abs(rect.height));
+        float left = static_cast<float>(rect.left);
+        float top = static_cast<float>(rect.top);
+        float right = left + rect.width;
+        float bottom = top + rect.height;
+
+        sf::VertexArray &quads = layerFor(texture);
+        quads.append(sf::Vertex(transform.transformPoint(0, 0), sprite.getColor(), sf::Vector2f(left, top)));
+        quads.append(sf::Vertex(transform.transformPoint(width, 0), sprite.getColor(), sf::Vector2f(right, top)));
+        quads.append(sf::Vertex(transform.transformPoint(width, height), sprite.getColor(), sf::Vector2f(right, bottom)));
+        quads.append(sf::Vertex(transform.transformPoint(0, height), sprite.getColor(), sf::Vector2f(left, bottom)));
+    }
+
+    /**
+     * @brief Add a filled circle as a dot.
+     * @param shape Circle to add; uses its transform, radius and fill color.
+     */
+    void addCircle(const sf::CircleShape &shape)
+    {
+        float radius = shape.getRadius();
+        sf::Vector2f center = shape.getTransform().transformPoint(radius, radius); // Local center is (radius, radius)
+        sf::Vector2f scale = shape.getScale();
+        addDot(center, radius * std::sqrt(std::abs(scale.x * scale.y)), shape.getFillColor());
+    }
+
+    /**
+     * @brief Add a filled dot.
+     * @param center Center of the dot.
+     * @param radius Radius of the dot.
+     * @param color Fill color.
+     */
+    void addDot(sf::Vector2f center, float radius, sf::Color color)
+    {
+        const auto &outline = dotOutline();
+        sf::Vector2f previous = center + outline[0] * radius;
+        for (int segment = 1; segment <= DOT_SEGMENTS; segment++)
+        {
+            sf::Vector2f next = center + outline[segment] * radius;
+            dots.append(sf::Vertex(center, color));
+            dots.append(sf::Vertex(previous, color));
+            dots.append(sf::Vertex(next, color));
+            previous = next;
+        }
+    }
+
+    /**
+     * @brief Add a line segment.
+     * @param from Start point.
+     * @param to End point.
+     * @param color Line color.
+     */
+    void addLine(sf::Vector2f from, sf::Vector2f to, sf::Color color)
+    {
+        lines.append(sf::Vertex(from, color));
+        lines.append(sf::Vertex(to, color));
+    }
+
+    /**
+     * @brief Add a polyline as consecutive segments.
+     * @param points Points of the polyline.
+     * @param color Line color.
+     */
+    void addLineStrip(const std::vector<sf::Vector2f> &points, sf::Color color)
+    {
+        for (size_t i = 1; i < points.size(); i++)
+        {
+            addLine(points[i - 1], points[i], color);
+        }
+    }
+
+    /**
+     * @brief Draw the whole batch: lines, then dots, then one call per texture.
+     * @param target Window or texture to draw to.
+     */
+    void draw(sf::RenderTarget &target) const
+    {
+        if (lines.getVertexCount() > 0)
+        {
+            target.draw(lines);
+        }
+        if (dots.getVertexCount() > 0)
+        {
+            target.draw(dots);
+        }
+        for (const auto &layer : layers)
+        {
+            if (layer.second.getVertexCount() > 0)
+            {
+                target.draw(layer.second, layer.first);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of draw calls draw() would make.
+     */
+    size_t getDrawCallCount() const
+    {
+        size_t count = (lines.getVertexCount() > 0) + (dots.getVertexCount() > 0);
+        for (const auto &layer : layers)
+        {
+            count += layer.second.getVertexCount() > 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Get the total number of vertices in the batch.
+     */
+    size_t getVertexCount() const
+    {
+        size_t count = lines.getVertexCount() + dots.getVertexCount();
+        for (const auto &layer : layers)
+        {
+            count += layer.second.getVertexCount();
+        }
+        return count;
+    }
+
+private:
+    std::vector<std::pair<const sf::Texture *, sf::VertexArray>> layers; // One quad array per texture, in first-use order
+    sf::VertexArray dots{sf::Triangles};                                  // All dots
+    sf::VertexArray lines{sf::Lines};                                     // All line segments
+
+    /**
+     * @brief Get the unit circle points of a dot, computed once.
+     */
+    static const std::array<sf::Vector2f, DOT_SEGMENTS + 1> &dotOutline()
+    {
+        static const std::array<sf::Vector2f, DOT_SEGMENTS + 1> outline = []
+        {
+            std::array<sf::Vector2f, DOT_SEGMENTS + 1> points;
+            for (int segment = 0; segment <= DOT_SEGMENTS; segment++)
+            {
+                float angle = segment * 2.0f * 3.14159265f / DOT_SEGMENTS;
+                points[segment] = sf::Vector2f(std::cos(angle), std::sin(angle));
+            }
+            return points;
+        }();
+        return outline;
+    }
+
+    /**
+     * @brief Get the quad array for a texture, adding one if this is the first sprite using it.
+     */
+    sf::VertexArray &layerFor(const sf::Texture *texture)
+    {
+        for (auto &layer : layers)
+        {
+            if (layer.first == texture)
+            {
+                return layer.second;
+            }
+        }
+        layers.emplace_back(texture, sf::VertexArray(sf::Quads));
+        return layers.back().second;
+    }
+};
+
+#endif // SPRITE_BATCH_H
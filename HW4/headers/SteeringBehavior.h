@@ -15,6 +15,7 @@
 
 #include "Kinematic.h"
 #include "SteeringData.h"
+#include <cstddef>
 
 /**
  * @class SteeringBehavior
@@ -31,6 +32,22 @@ public:
      * @return A SteeringData object containing linear and angular acceleration.
      */
     virtual SteeringData calculateAcceleration(const Kinematic& character, const Kinematic& target) = 0;
+
+    /**
+     * @brief Calculates the acceleration of many characters at once, one virtual call per batch.
+     * @param characters Array of count entities applying the behavior.
+     * @param targets Array of count targets; targets[i] belongs to characters[i].
+     * @param results Array of count results to write.
+     * @param count Number of characters.
+     * @note The default calls calculateAcceleration for each character. Behaviors with a
+     * vectorized version (Arrive, Align) override this.
+     */
+    virtual void calculateAccelerations(const Kinematic* characters, const Kinematic* targets,
+                                        SteeringData* results, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = calculateAcceleration(characters[i], targets[i]);
+        }
+    }
 };
 
 #endif // STEERINGBEHAVIOR_H
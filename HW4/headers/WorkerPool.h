@@ -0,0 +1,180 @@
+/**
+ * @file WorkerPool.h
+ * @brief Defines the WorkerPool class, a fixed set of threads for splitting per-agent loops.
+ *
+ * Resources Used:
+ * - cppreference, Thread support library: https://en.cppreference.com/w/cpp/thread
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief Runs a loop body over index ranges on persistent worker threads.
+ *
+ * parallelFor splits [0, count) into one contiguous range per thread and blocks until all
+ * ranges are done. The split only depends on count and the thread count, and the body must
+ * only write to the indices it was given, so results do not depend on thread timing.
+ *
+ * The pool runs one loop at a time. A parallelFor that starts while another is running, from
+ * another thread or from inside a body, runs its whole range on the calling thread instead, so
+ * nested and concurrent loops can share one pool.
+ */
+class WorkerPool
+{
+public:
+    /**
+     * @brief Constructor to start the worker threads.
+     * @param threadCount Total threads including the calling thread; 0 uses the hardware thread count.
+     */
+    explicit WorkerPool(unsigned threadCount = 0)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned thread = 1; thread < threadCount; thread++)
+        {
+            workers.emplace_back(&WorkerPool::run, this, thread);
+        }
+    }
+
+    /**
+     * @brief Destructor to stop and join the worker threads.
+     */
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * @brief Runs body over [0, count), one contiguous range per thread, and waits for all of them.
+     * @param count Number of indices.
+     * @param body Called as body(begin, end) for each non-empty range.
+     * @note The calling thread runs the first range itself, or all of them if the pool is busy.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)> &body)
+    {
+        bool idle = false;
+        if (workers.empty() || count < 2 || !busy.compare_exchange_strong(idle, true))
+        {
+            if (count > 0)
+            {
+                body(0, count);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->body = &body;
+            this->count = count;
+            pending = static_cast<unsigned>(workers.size());
+            generation++;
+        }
+        jobReady.notify_all();
+
+        // The caller takes the first range
+        size_t begin, end;
+        rangeOf(0, begin, end);
+        if (begin < end)
+        {
+            body(begin, end);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [this]
+                     { return pending == 0; });
+        this->body = nullptr;
+        busy = false;
+    }
+
+    /**
+     * @brief Gets the number of threads, including the calling thread.
+     */
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+private:
+    std::vector<std::thread> workers;                          // Worker threads (the caller is thread 0)
+    std::atomic<bool> busy{false};                             // Set while a parallelFor is using the workers
+    std::mutex mutex;                                          // Guards the job fields below
+    std::condition_variable jobReady;                          // Signals workers that a new job started
+    std::condition_variable jobDone;                           // Signals the caller that a worker finished
+    const std::function<void(size_t, size_t)> *body = nullptr; // Current loop body
+    size_t count = 0;                                          // Current index count
+    unsigned generation = 0;                                   // Incremented for every job so workers run each one once
+    unsigned pending = 0;                                      // Workers still running the current job
+    bool stopping = false;                                     // Set by the destructor
+
+    /**
+     * @brief Gets the range of one thread for the current job.
+     */
+    void rangeOf(unsigned thread, size_t &begin, size_t &end) const
+    {
+        size_t threads = workers.size() + 1;
+        begin = count * thread / threads;
+        end = count * (thread + 1) / threads;
+    }
+
+    /**
+     * @brief Worker loop: waits for a job, runs its range, reports back.
+     * @param thread Index of this worker (1 and up).
+     */
+    void run(unsigned thread)
+    {
+        unsigned seen = 0;
+        while (true)
+        {
+            size_t begin, end;
+            const std::function<void(size_t, size_t)> *job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobReady.wait(lock, [&]
+                              { return stopping || generation != seen; });
+                if (stopping)
+                {
+                    return;
+                }
+                seen = generation;
+                job = body;
+                rangeOf(thread, begin, end);
+            }
+
+            if (begin < end)
+            {
+                (*job)(begin, end);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            jobDone.notify_one();
+        }
+    }
+};
+
+#endif // WORKERPOOL_H
@@ -14,11 +14,14 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <random>
 #include <memory>
+#include <unordered_map>
+#include <cstdlib>
 
 // Include headers from HW2 and HW3
 #include "headers/Environment.h"
@@ -29,6 +32,8 @@
 #include "headers/PathFollower.h"
 #include "headers/Dijkstra.h"
 #include "headers/AStar.h"
+#include "headers/PathSmoothing.h"
+#include "headers/NavAsset.h"
 
 // Include headers for HW4
 #include "headers/DecisionTree.h"
@@ -36,13 +41,27 @@
 #include "headers/Monster.h"
 #include "headers/DTLearning.h"
 #include "headers/LearnedDecisionTree.h"
+#include "headers/FixedTimestep.h"
+#include "headers/HeadlessRunner.h"
+#include "headers/DecisionFeatures.h"
+#include "headers/WorkerPool.h"
+
+// Condition profile written by --optimize and read by the windowed demo
+const char *const DECISION_PROFILE_FILE = "decision_profile.txt";
 
 // Forward declarations
 Environment createIndoorEnvironment(int width, int height);
-std::shared_ptr<BehaviorTree> createMonsterBehaviorTree(Monster &monster);
-std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &state, Environment &environment);
+bool canSeePlayer(const Monster &monster, Blackboard &blackboard, BlackboardKey<float> lastSeenTimer,
+                  BlackboardKey<bool> playerLastSeen);
+bool isObstacleAhead(const Monster &monster);
+std::shared_ptr<BehaviorTree> createMonsterBehaviorTree();
+std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &state, Environment &environment,
+                                                          std::unordered_map<ActionId, sf::Vector2f> *targetPositions = nullptr);
 std::shared_ptr<DecisionTree> learnDecisionTreeFromBehaviorTree(const std::string &dataFile, Monster &monster);
 void recordBehaviorTreeData(Monster &monster, const std::string &outputFile, int frames);
+int runHeadlessChase(Environment &environment, Graph &graph, int monsterCount, long long ticks, float clearance);
+int runHeadlessDecisions(Environment &environment, int agentCount, long long ticks);
+int optimizeDecisionOrder(Environment &environment, long long ticks);
 
 /**
  * @brief Creates an indoor environment with multiple rooms and obstacles.
@@ -106,17 +125,65 @@ Environment createIndoorEnvironment(int width, int height)
  * initializes a window, loads textures, creates an environment, and sets up agents with decision trees and behavior trees."
  * The code provided by ChatGPT was modified to fit the context of the project.
  */
-int main()
+int main(int argc, char *argv[])
 {
-    // Create window
+    // Command line: --headless TICKS [MONSTERS] runs the chase without a window,
+    // --record FRAMES [FILE] records behavior tree data without a window,
+    // --decisions TICKS [AGENTS] runs batched decision tree evaluation for a crowd without a window,
+    // --optimize TICKS profiles the player's decision tree without a window and reorders its conditions
+    long long headlessTicks = 0;
+    int headlessMonsters = 1;
+    long long decisionTicks = 0;
+    int decisionAgents = 10000;
+    long long optimizeTicks = 0;
+    int recordFrames = 0;
+    std::string recordFile = "behavior_data.csv";
+    for (int arg = 1; arg < argc; arg++)
+    {
+        std::string value = argv[arg];
+        if (value == "--headless" && arg + 1 < argc)
+        {
+            headlessTicks = std::max(1LL, std::atoll(argv[++arg]));
+            if (arg + 1 < argc && std::atoi(argv[arg + 1]) > 0)
+            {
+                headlessMonsters = std::atoi(argv[++arg]);
+            }
+        }
+        else if (value == "--decisions" && arg + 1 < argc)
+        {
+            decisionTicks = std::max(1LL, std::atoll(argv[++arg]));
+            if (arg + 1 < argc && std::atoi(argv[arg + 1]) > 0)
+            {
+                decisionAgents = std::atoi(argv[++arg]);
+            }
+        }
+        else if (value == "--optimize" && arg + 1 < argc)
+        {
+            optimizeTicks = std::max(1LL, std::atoll(argv[++arg]));
+        }
+        else if (value == "--record" && arg + 1 < argc)
+        {
+            recordFrames = std::max(1, std::atoi(argv[++arg]));
+            if (arg + 1 < argc && argv[arg + 1][0] != '-')
+            {
+                recordFile = argv[++arg];
+            }
+        }
+    }
+    bool headless = headlessTicks > 0 || recordFrames > 0 || decisionTicks > 0 || optimizeTicks > 0;
+
+    // Create window (not when headless)
     int windowWidth = 640;
     int windowHeight = 480;
-    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight),
-                            "CSC 584/484 - HW4: Decision Trees and Behavior Trees");
+    sf::RenderWindow window;
+    if (!headless)
+    {
+        window.create(sf::VideoMode(windowWidth, windowHeight), "CSC 584/484 - HW4: Decision Trees and Behavior Trees");
+    }
 
-    // Load texture for the agents
+    // Load texture for the agents (uploading it needs a display, so not when headless)
     sf::Texture agentTexture;
-    if (!agentTexture.loadFromFile("boid.png"))
+    if (!headless && !agentTexture.loadFromFile("boid.png"))
     {
         std::cerr << "Failed to load boid.png! Creating fallback texture." << std::endl;
         // Create a fallback texture
@@ -129,8 +196,25 @@ int main()
     // Create environment using the indoor environment from HW3
     Environment environment = createIndoorEnvironment(windowWidth, windowHeight);
 
+    // Headless crowd of decision tree agents (needs no graph)
+    if (decisionTicks > 0)
+    {
+        return runHeadlessDecisions(environment, decisionAgents, decisionTicks);
+    }
+    if (optimizeTicks > 0)
+    {
+        return optimizeDecisionOrder(environment, optimizeTicks);
+    }
+
     // Create graph representation of the environment
-    Graph environmentGraph = environment.createGraph(20); // 20px grid cells
+    NavAsset navAsset;
+    Graph environmentGraph = navAsset.loadOrBuild("nav_grid_20.dat", environment, 20); // 20px grid cells
+
+    // Headless chase: the player wanders on A* paths while behavior tree monsters hunt it
+    if (headlessTicks > 0)
+    {
+        return runHeadlessChase(environment, environmentGraph, headlessMonsters, headlessTicks, 10.0f);
+    }
 
     // Create player
     sf::Vector2f playerStartPos(100, 100);
@@ -149,8 +233,14 @@ int main()
     decisionTreeMonster.setControlType(Monster::ControlType::DECISION_TREE);
 
     // Create behavior tree
-    std::shared_ptr<BehaviorTree> behaviorTree = createMonsterBehaviorTree(behaviorTreeMonster);
-    behaviorTreeMonster.setBehaviorTree(behaviorTree);
+    behaviorTreeMonster.setBehaviorTree(createMonsterBehaviorTree());
+
+    // Headless recording: write behavior tree training data and exit
+    if (recordFrames > 0)
+    {
+        recordBehaviorTreeData(behaviorTreeMonster, recordFile, recordFrames);
+        return 0;
+    }
 
     // Create font for text display
     sf::Font font;
@@ -205,7 +295,16 @@ int main()
 
     // Set up decision tree for the player
     EnvironmentState playerState(player.getKinematic(), environment);
-    std::shared_ptr<DecisionTree> playerDecisionTree = createCharacterDecisionTree(playerState, environment);
+    std::unordered_map<ActionId, sf::Vector2f> playerTargets; // Pathfind actions and the positions they head to
+    std::shared_ptr<DecisionTree> playerDecisionTree = createCharacterDecisionTree(playerState, environment, &playerTargets);
+
+    // Use the condition order measured by the last --optimize run, if there was one
+    if (playerDecisionTree->loadConditionProfile(DECISION_PROFILE_FILE))
+    {
+        std::cout << "Condition order from " << DECISION_PROFILE_FILE << ":" << std::endl;
+        playerDecisionTree->optimizeConditionOrder(&std::cout);
+    }
+    playerDecisionTree->setProfiling(true); // Condition statistics are printed on exit
 
     // Variables for controlling simulation
     bool showBehaviorTreeMonster = true;
@@ -224,6 +323,7 @@ int main()
     // Variables for player decision tree
     float playerDecisionTimer = 0.0f;
     const float DECISION_INTERVAL = 2.0f; // Make decisions every 2 seconds
+    const float PATH_CLEARANCE = 10.0f;   // Distance smoothed paths keep from walls
     std::vector<sf::Vector2f> potentialTargets = {
         {100, 100}, // Top-left room
         {500, 100}, // Top-right room
@@ -232,8 +332,12 @@ int main()
         {250, 250}  // Center
     };
 
-    // Clock for timing
+    // Batch for the player, the monsters and their breadcrumbs and paths
+    SpriteBatch agentBatch;
+
+    // Clock for timing; the game runs in fixed simulation steps
     sf::Clock gameClock;
+    FixedTimestep timestep;
     sf::Clock catchTimerBT;
     sf::Clock catchTimerDT;
 
@@ -261,9 +365,6 @@ int main()
                     behaviorTreeMonster.reset();
                     decisionTreeMonster.reset();
 
-                    // Reset behavior tree
-                    behaviorTree->reset();
-
                     // Reset performance metrics
                     behaviorTreeCatches = 0;
                     decisionTreeCatches = 0;
@@ -367,43 +468,92 @@ int main()
             }
         }
 
-        // Calculate delta time
-        float deltaTime = gameClock.restart().asSeconds();
+        // Run the simulation steps due this frame
+        int steps = timestep.advance(gameClock.restart().asSeconds());
+        for (int step = 0; step < steps; step++)
+        {
+            float deltaTime = timestep.getStep();
 
-        // Update player state
-        playerState.update();
+            // Update player state
+            playerState.update(deltaTime);
 
-        // Update player decision timer
-        playerDecisionTimer += deltaTime;
+            // Update player decision timer
+            playerDecisionTimer += deltaTime;
 
-        // Make player decisions based on the decision tree
-        if (playerDecisionTimer >= DECISION_INTERVAL || player.pathCompleted())
-        {
-            playerDecisionTimer = 0.0f;
+            // Make player decisions based on the decision tree
+            if (playerDecisionTimer >= DECISION_INTERVAL || player.pathCompleted())
+            {
+                playerDecisionTimer = 0.0f;
 
-            // Make a decision based on the decision tree
-            std::string decision = playerDecisionTree->makeDecision();
+                // Make a decision based on the decision tree
+                ActionId decision = playerDecisionTree->makeDecision();
 
-            // Process the decision
-            if (decision.find("PathfindTo") != std::string::npos)
-            {
-                // Extract target from decision
-                size_t startPos = decision.find("_");
-                if (startPos != std::string::npos)
+                // Process the decision
+                auto target = playerTargets.find(decision);
+                if (target != playerTargets.end())
                 {
-                    std::string targetStr = decision.substr(startPos + 1);
-                    size_t separatorPos = targetStr.find("_");
-                    if (separatorPos != std::string::npos)
+                    sf::Vector2f targetPos = target->second;
+
+                    // Find path to target position
+                    int startVertex = environment.pointToVertex(player.getPosition());
+                    int goalVertex = environment.pointToVertex(targetPos);
+
+                    // Use A* to find a path
+                    AStar astar([](int current, int goal, const Graph &g)
+                                {
+                        sf::Vector2f currentPos = g.getVertexPosition(current);
+                        sf::Vector2f goalPos = g.getVertexPosition(goal);
+                        float dx = goalPos.x - currentPos.x;
+                        float dy = goalPos.y - currentPos.y;
+                        return std::sqrt(dx * dx + dy * dy); });
+
+                    std::vector<int> path = astar.findPath(environmentGraph, startVertex, goalVertex);
+
+                    // Convert path to waypoints
+                    std::vector<sf::Vector2f> waypoints;
+                    for (int vertex : path)
                     {
-                        float x = std::stof(targetStr.substr(0, separatorPos));
-                        float y = std::stof(targetStr.substr(separatorPos + 1));
-                        sf::Vector2f targetPos(x, y);
+                        waypoints.push_back(environmentGraph.getVertexPosition(vertex));
+                    }
+
+                    // Set the smoothed path for the player to follow
+                    player.setPath(PathSmoothing::smoothFrom(player.getPosition(), waypoints, environment, PATH_CLEARANCE));
 
-                        // Find path to target position
+                    if (fontLoaded)
+                    {
+                        playerStatusText.setString("Player: Moving to position (" +
+                                                   std::to_string(int(targetPos.x)) + "," +
+                                                   std::to_string(int(targetPos.y)) + ")");
+                    }
+                }
+                else if (decision == ActionRegistry::WANDER)
+                {
+                    // Generate a random position within environment bounds
+                    std::random_device rd;
+                    std::mt19937 gen(rd());
+                    std::uniform_int_distribution<> distribX(50, windowWidth - 50);
+                    std::uniform_int_distribution<> distribY(50, windowHeight - 50);
+
+                    sf::Vector2f randomTarget;
+                    bool validTarget = false;
+
+                    // Try to find a valid random position
+                    for (int attempt = 0; attempt < 10 && !validTarget; attempt++)
+                    {
+                        randomTarget.x = distribX(gen);
+                        randomTarget.y = distribY(gen);
+                        if (!environment.isObstacle(randomTarget))
+                        {
+                            validTarget = true;
+                        }
+                    }
+
+                    if (validTarget)
+                    {
+                        // Find path to random position
                         int startVertex = environment.pointToVertex(player.getPosition());
-                        int goalVertex = environment.pointToVertex(targetPos);
+                        int goalVertex = environment.pointToVertex(randomTarget);
 
-                        // Use A* to find a path
                         AStar astar([](int current, int goal, const Graph &g)
                                     {
                             sf::Vector2f currentPos = g.getVertexPosition(current);
@@ -421,115 +571,107 @@ int main()
                             waypoints.push_back(environmentGraph.getVertexPosition(vertex));
                         }
 
-                        // Set the path for the player to follow
-                        player.setPath(waypoints);
+                        // Set the smoothed path for the player to follow
+                        player.setPath(PathSmoothing::smoothFrom(player.getPosition(), waypoints, environment, PATH_CLEARANCE));
 
                         if (fontLoaded)
                         {
-                            playerStatusText.setString("Player: Moving to position (" +
-                                                       std::to_string(int(x)) + "," +
-                                                       std::to_string(int(y)) + ")");
+                            playerStatusText.setString("Player: Wandering to random location (" +
+                                                       std::to_string(int(randomTarget.x)) + "," +
+                                                       std::to_string(int(randomTarget.y)) + ")");
                         }
                     }
                 }
-            }
-            else if (decision == "Wander")
-            {
-                // Generate a random position within environment bounds
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> distribX(50, windowWidth - 50);
-                std::uniform_int_distribution<> distribY(50, windowHeight - 50);
-
-                sf::Vector2f randomTarget;
-                bool validTarget = false;
-
-                // Try to find a valid random position
-                for (int attempt = 0; attempt < 10 && !validTarget; attempt++)
+                else if (decision == ActionRegistry::FLEE)
                 {
-                    randomTarget.x = distribX(gen);
-                    randomTarget.y = distribY(gen);
-                    if (!environment.isObstacle(randomTarget))
+                    // Determine flee direction (away from nearest obstacle)
+                    float nearestObstacleDistance = 1000.0f;
+                    sf::Vector2f fleeDirection(0, 0);
+
+                    // Check in 8 directions for obstacles
+                    for (int angle = 0; angle < 360; angle += 45)
                     {
-                        validTarget = true;
+                        float radian = angle * 3.14159f / 180.0f;
+                        float dx = std::cos(radian);
+                        float dy = std::sin(radian);
+
+                        // Check for obstacles
+                        for (float dist = 10.0f; dist <= 50.0f; dist += 10.0f)
+                        {
+                            sf::Vector2f checkPoint = player.getPosition() + sf::Vector2f(dx * dist, dy * dist);
+                            if (environment.isObstacle(checkPoint))
+                            {
+                                if (dist < nearestObstacleDistance)
+                                {
+                                    nearestObstacleDistance = dist;
+                                    fleeDirection = sf::Vector2f(-dx, -dy); // Opposite direction
+                                }
+                                break;
+                            }
+                        }
                     }
-                }
 
-                if (validTarget)
-                {
-                    // Find path to random position
-                    int startVertex = environment.pointToVertex(player.getPosition());
-                    int goalVertex = environment.pointToVertex(randomTarget);
+                    if (nearestObstacleDistance < 1000.0f)
+                    {
+                        // Scale the flee direction to get a reasonable distance
+                        sf::Vector2f fleeTarget = player.getPosition() + fleeDirection * 100.0f;
 
-                    AStar astar([](int current, int goal, const Graph &g)
-                                {
-                        sf::Vector2f currentPos = g.getVertexPosition(current);
-                        sf::Vector2f goalPos = g.getVertexPosition(goal);
-                        float dx = goalPos.x - currentPos.x;
-                        float dy = goalPos.y - currentPos.y;
-                        return std::sqrt(dx * dx + dy * dy); });
+                        // Ensure the flee target is within environment bounds
+                        fleeTarget.x = std::max(50.0f, std::min(windowWidth - 50.0f, fleeTarget.x));
+                        fleeTarget.y = std::max(50.0f, std::min(windowHeight - 50.0f, fleeTarget.y));
 
-                    std::vector<int> path = astar.findPath(environmentGraph, startVertex, goalVertex);
+                        // Find path to flee target
+                        int startVertex = environment.pointToVertex(player.getPosition());
+                        int goalVertex = environment.pointToVertex(fleeTarget);
 
-                    // Convert path to waypoints
-                    std::vector<sf::Vector2f> waypoints;
-                    for (int vertex : path)
-                    {
-                        waypoints.push_back(environmentGraph.getVertexPosition(vertex));
-                    }
+                        AStar astar([](int current, int goal, const Graph &g)
+                                    {
+                            sf::Vector2f currentPos = g.getVertexPosition(current);
+                            sf::Vector2f goalPos = g.getVertexPosition(goal);
+                            float dx = goalPos.x - currentPos.x;
+                            float dy = goalPos.y - currentPos.y;
+                            return std::sqrt(dx * dx + dy * dy); });
 
-                    // Set the path for the player to follow
-                    player.setPath(waypoints);
+                        std::vector<int> path = astar.findPath(environmentGraph, startVertex, goalVertex);
 
-                    if (fontLoaded)
-                    {
-                        playerStatusText.setString("Player: Wandering to random location (" +
-                                                   std::to_string(int(randomTarget.x)) + "," +
-                                                   std::to_string(int(randomTarget.y)) + ")");
-                    }
-                }
-            }
-            else if (decision == "Flee")
-            {
-                // Determine flee direction (away from nearest obstacle)
-                float nearestObstacleDistance = 1000.0f;
-                sf::Vector2f fleeDirection(0, 0);
+                        // Convert path to waypoints
+                        std::vector<sf::Vector2f> waypoints;
+                        for (int vertex : path)
+                        {
+                            waypoints.push_back(environmentGraph.getVertexPosition(vertex));
+                        }
 
-                // Check in 8 directions for obstacles
-                for (int angle = 0; angle < 360; angle += 45)
-                {
-                    float radian = angle * 3.14159f / 180.0f;
-                    float dx = std::cos(radian);
-                    float dy = std::sin(radian);
+                        // Set the smoothed path for the player to follow
+                        player.setPath(PathSmoothing::smoothFrom(player.getPosition(), waypoints, environment, PATH_CLEARANCE));
 
-                    // Check for obstacles
-                    for (float dist = 10.0f; dist <= 50.0f; dist += 10.0f)
-                    {
-                        sf::Vector2f checkPoint = player.getPosition() + sf::Vector2f(dx * dist, dy * dist);
-                        if (environment.isObstacle(checkPoint))
+                        if (fontLoaded)
                         {
-                            if (dist < nearestObstacleDistance)
-                            {
-                                nearestObstacleDistance = dist;
-                                fleeDirection = sf::Vector2f(-dx, -dy); // Opposite direction
-                            }
-                            break;
+                            playerStatusText.setString("Player: Fleeing from obstacle at " +
+                                                       std::to_string(int(nearestObstacleDistance)) +
+                                                       " pixels away");
                         }
                     }
                 }
-
-                if (nearestObstacleDistance < 1000.0f)
+                else if (decision == ActionRegistry::DANCE)
                 {
-                    // Scale the flee direction to get a reasonable distance
-                    sf::Vector2f fleeTarget = player.getPosition() + fleeDirection * 100.0f;
+                    player.setPath({}); // Clear current path
 
-                    // Ensure the flee target is within environment bounds
-                    fleeTarget.x = std::max(50.0f, std::min(windowWidth - 50.0f, fleeTarget.x));
-                    fleeTarget.y = std::max(50.0f, std::min(windowHeight - 50.0f, fleeTarget.y));
+                    if (fontLoaded)
+                    {
+                        playerStatusText.setString("Player: Dancing");
+                    }
+                }
+                else
+                {
+                    // Default to selecting a random target from the predefined list
+                    std::random_device rd;
+                    std::mt19937 gen(rd());
+                    std::uniform_int_distribution<> distrib(0, potentialTargets.size() - 1);
+                    sf::Vector2f target = potentialTargets[distrib(gen)];
 
-                    // Find path to flee target
+                    // Find path to target
                     int startVertex = environment.pointToVertex(player.getPosition());
-                    int goalVertex = environment.pointToVertex(fleeTarget);
+                    int goalVertex = environment.pointToVertex(target);
 
                     AStar astar([](int current, int goal, const Graph &g)
                                 {
@@ -548,148 +690,106 @@ int main()
                         waypoints.push_back(environmentGraph.getVertexPosition(vertex));
                     }
 
-                    // Set the path for the player to follow
-                    player.setPath(waypoints);
+                    // Set the smoothed path for the player to follow
+                    player.setPath(PathSmoothing::smoothFrom(player.getPosition(), waypoints, environment, PATH_CLEARANCE));
 
                     if (fontLoaded)
                     {
-                        playerStatusText.setString("Player: Fleeing from obstacle at " +
-                                                   std::to_string(int(nearestObstacleDistance)) +
-                                                   " pixels away");
+                        playerStatusText.setString("Player: Moving to random target (" +
+                                                   std::to_string(int(target.x)) + "," +
+                                                   std::to_string(int(target.y)) + ")");
                     }
                 }
             }
-            else if (decision == "Dance")
-            {
-                player.setPath({}); // Clear current path
-
-                if (fontLoaded)
-                {
-                    playerStatusText.setString("Player: Dancing");
-                }
-            }
-            else
-            {
-                // Default to selecting a random target from the predefined list
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> distrib(0, potentialTargets.size() - 1);
-                sf::Vector2f target = potentialTargets[distrib(gen)];
 
-                // Find path to target
-                int startVertex = environment.pointToVertex(player.getPosition());
-                int goalVertex = environment.pointToVertex(target);
+            // Update player
+            player.update(deltaTime);
 
-                AStar astar([](int current, int goal, const Graph &g)
-                            {
-                    sf::Vector2f currentPos = g.getVertexPosition(current);
-                    sf::Vector2f goalPos = g.getVertexPosition(goal);
-                    float dx = goalPos.x - currentPos.x;
-                    float dy = goalPos.y - currentPos.y;
-                    return std::sqrt(dx * dx + dy * dy); });
+            // Update monsters
+            bool behaviorTreeCaught = false;
+            bool decisionTreeCaught = false;
 
-                std::vector<int> path = astar.findPath(environmentGraph, startVertex, goalVertex);
+            if (showBehaviorTreeMonster)
+            {
+                behaviorTreeCaught = behaviorTreeMonster.update(deltaTime);
 
-                // Convert path to waypoints
-                std::vector<sf::Vector2f> waypoints;
-                for (int vertex : path)
+                if (behaviorTreeCaught)
                 {
-                    waypoints.push_back(environmentGraph.getVertexPosition(vertex));
-                }
-
-                // Set the path for the player to follow
-                player.setPath(waypoints);
+                    behaviorTreeCatches++;
+                    behaviorTreeTime += catchTimerBT.restart().asSeconds();
+                    player.setPosition(playerStartPos);
+                    behaviorTreeMonster.reset();
 
-                if (fontLoaded)
-                {
-                    playerStatusText.setString("Player: Moving to random target (" +
-                                               std::to_string(int(target.x)) + "," +
-                                               std::to_string(int(target.y)) + ")");
+                    if (fontLoaded)
+                    {
+                        playerStatusText.setString("Player caught by behavior tree monster!");
+                    }
                 }
             }
-        }
-
-        // Update player
-        player.update(deltaTime);
-
-        // Update monsters
-        bool behaviorTreeCaught = false;
-        bool decisionTreeCaught = false;
 
-        if (showBehaviorTreeMonster)
-        {
-            behaviorTreeCaught = behaviorTreeMonster.update(deltaTime);
-
-            if (behaviorTreeCaught)
+            if (showDecisionTreeMonster)
             {
-                behaviorTreeCatches++;
-                behaviorTreeTime += catchTimerBT.restart().asSeconds();
-                player.setPosition(playerStartPos);
-                behaviorTreeMonster.reset();
+                decisionTreeCaught = decisionTreeMonster.update(deltaTime);
 
-                if (fontLoaded)
+                if (decisionTreeCaught)
                 {
-                    playerStatusText.setString("Player caught by behavior tree monster!");
-                }
-            }
-        }
-
-        if (showDecisionTreeMonster)
-        {
-            decisionTreeCaught = decisionTreeMonster.update(deltaTime);
-
-            if (decisionTreeCaught)
-            {
-                decisionTreeCatches++;
-                decisionTreeTime += catchTimerDT.restart().asSeconds();
-                player.setPosition(playerStartPos);
-                decisionTreeMonster.reset();
+                    decisionTreeCatches++;
+                    decisionTreeTime += catchTimerDT.restart().asSeconds();
+                    player.setPosition(playerStartPos);
+                    decisionTreeMonster.reset();
 
-                if (fontLoaded)
-                {
-                    playerStatusText.setString("Player caught by decision tree monster!");
+                    if (fontLoaded)
+                    {
+                        playerStatusText.setString("Player caught by decision tree monster!");
+                    }
                 }
             }
-        }
-
-        // Record data if recording is active
-        if (isRecording)
-        {
-            behaviorTreeMonster.recordStateAction(recordingFile);
-            recordingFrames++;
 
-            // Limit recording to avoid huge files
-            if (recordingFrames > 10000)
+            // Record data if recording is active
+            if (isRecording)
             {
-                isRecording = false;
-                recordingFile.close();
+                behaviorTreeMonster.recordStateAction(recordingFile);
+                recordingFrames++;
 
-                if (fontLoaded)
+                // Limit recording to avoid huge files
+                if (recordingFrames > 10000)
                 {
-                    recordStatusText.setString("Recording complete (10000 frames)");
+                    isRecording = false;
+                    recordingFile.close();
+
+                    if (fontLoaded)
+                    {
+                        recordStatusText.setString("Recording complete (10000 frames)");
+                    }
                 }
             }
         }
 
+        // Place sprites between the last two simulation steps
+        player.interpolate(timestep.getAlpha());
+        behaviorTreeMonster.interpolate(timestep.getAlpha());
+        decisionTreeMonster.interpolate(timestep.getAlpha());
+
         // Render
         window.clear(sf::Color::White);
 
         // Draw environment
         environment.draw(window);
 
-        // Draw player
-        player.draw(window);
+        // Draw player and monsters through one batch
+        agentBatch.clear();
+        player.draw(agentBatch);
 
-        // Draw monsters
         if (showBehaviorTreeMonster)
         {
-            behaviorTreeMonster.draw(window);
+            behaviorTreeMonster.draw(agentBatch);
         }
 
         if (showDecisionTreeMonster)
         {
-            decisionTreeMonster.draw(window);
+            decisionTreeMonster.draw(agentBatch);
         }
+        agentBatch.draw(window);
 
         // Draw performance statistics
         sf::Text performanceText;
@@ -745,246 +845,306 @@ int main()
         recordingFile.close();
     }
 
+    // Report how often each of the player's conditions ran, was true, and what it cost
+    std::cout << "Player decision tree conditions:" << std::endl;
+    playerDecisionTree->printProfile(std::cout);
+
     return 0;
 }
 
 /**
- * @brief Create a behavior tree for the monster
- * @param monster Reference to the monster
- * @return Shared pointer to the created behavior tree
+ * @brief Check whether a monster can see the player: very close, or within range, view cone and line of sight
+ * @param monster Monster that looks
+ * @param blackboard Monster's blackboard, for the last-seen bookkeeping
+ * @param lastSeenTimer Key of the time since the player was first seen
+ * @param playerLastSeen Key of whether the player was seen last time
+ * @return True if the player is visible
+ */
+bool canSeePlayer(const Monster &monster, Blackboard &blackboard, BlackboardKey<float> lastSeenTimer,
+                  BlackboardKey<bool> playerLastSeen)
+{
+    // Get direction to player
+    sf::Vector2f monsterPos = monster.getPosition();
+    sf::Vector2f playerPos = monster.getPlayerKinematic().position;
+    sf::Vector2f toPlayer = playerPos - monsterPos;
+
+    // Calculate distance
+    float distance = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y);
+
+    // Update last seen timer
+    blackboard.set(lastSeenTimer, blackboard.get(lastSeenTimer) + monster.getDeltaTime());
+
+    // Can always "see" if extremely close
+    if (distance < 30.0f)
+    {
+        if (!blackboard.get(playerLastSeen))
+        {
+            blackboard.set(playerLastSeen, true);
+            blackboard.set(lastSeenTimer, 0.0f);
+        }
+        return true;
+    }
+
+    // If too far away, can't see
+    if (distance > 250.0f)
+    {
+        blackboard.set(playerLastSeen, false);
+        return false;
+    }
+
+    // Check if player is within view cone (140 degrees)
+    float monsterAngle = monster.getKinematic().orientation * 3.14159f / 180.0f;
+    sf::Vector2f monsterDir(std::cos(monsterAngle), std::sin(monsterAngle));
+
+    // Normalize to player direction
+    toPlayer = toPlayer / distance;
+
+    // Dot product gives cosine of angle between vectors
+    float dot = monsterDir.x * toPlayer.x + monsterDir.y * toPlayer.y;
+
+    // Check if within 70° (cos(70°) ≈ 0.342)
+    bool withinViewCone = (dot > 0.342f);
+
+    // If not in view cone, can't see
+    if (!withinViewCone)
+    {
+        blackboard.set(playerLastSeen, false);
+        return false;
+    }
+
+    // Check line of sight
+    bool lineOfSight = monster.hasLineOfSightTo(playerPos);
+
+    if (!lineOfSight)
+    {
+        blackboard.set(playerLastSeen, false);
+        return false;
+    }
+
+    // If we get here, player is visible
+    if (!blackboard.get(playerLastSeen))
+    {
+        blackboard.set(playerLastSeen, true);
+        blackboard.set(lastSeenTimer, 0.0f);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check for obstacles just ahead of a moving monster, with rays along and around its velocity
+ * @param monster Monster to check
+ * @return True if a ray hit an obstacle; false if none did or the monster is not moving
+ */
+bool isObstacleAhead(const Monster &monster)
+{
+    // Check for nearby obstacles using raycasting
+    sf::Vector2f position = monster.getPosition();
+    const Environment &env = monster.getEnvironment();
+
+    // Check primarily in the direction of movement
+    sf::Vector2f velocity = monster.getKinematic().velocity;
+    float speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+
+    // If not moving, no need to flee
+    if (speed < 5.0f)
+    {
+        return false;
+    }
+
+    // Normalize velocity to get direction
+    sf::Vector2f moveDir = velocity / speed;
+
+    // Check for obstacles directly ahead at close distances
+    for (float dist = 5.0f; dist <= 20.0f; dist += 5.0f)
+    {
+        sf::Vector2f checkPoint = position + moveDir * dist;
+        if (env.isObstacle(checkPoint))
+        {
+            return true;
+        }
+    }
+
+    // Check in a 45-degree cone around movement direction
+    for (int angleOffset = -45; angleOffset <= 45; angleOffset += 15)
+    {
+        if (angleOffset == 0)
+            continue; // Already checked straight ahead
+
+        float radians = std::atan2(moveDir.y, moveDir.x) + (angleOffset * 3.14159f / 180.0f);
+        sf::Vector2f rayDir(std::cos(radians), std::sin(radians));
+
+        for (float dist = 5.0f; dist <= 15.0f; dist += 5.0f)
+        {
+            sf::Vector2f checkPoint = position + rayDir * dist;
+            if (env.isObstacle(checkPoint))
+            {
+                return true;
+            }
+        }
+    }
+
+    // No obstacles detected
+    return false;
+}
+
+/**
+ * @brief Create the monster behavior tree
+ * @return Shared pointer to the created behavior tree; one tree can drive any number of monsters,
+ * each through its own BehaviorInstance (Monster::setBehaviorTree), which hands the monster to the nodes
  * OpenAI's ChatGPT was used to assist in implementing this function.
  * The following prompt was used:
  * "Create a behavior tree for a monster that includes actions like pathfinding to the player,
  * wandering, fleeing, and dancing. Use C++ and SFML for the implementation."
  * The code provided by ChatGPT was modified to fit the context of the project.
  */
-std::shared_ptr<BehaviorTree> createMonsterBehaviorTree(Monster &monster)
+std::shared_ptr<BehaviorTree> createMonsterBehaviorTree()
 {
     auto behaviorTree = std::make_shared<BehaviorTree>();
 
+    // Keys for the memory the nodes keep between ticks; each monster gets its own values
+    Blackboard &blackboard = behaviorTree->getBlackboard();
+    const BlackboardKey<bool> danceStarted = blackboard.add<bool>("DanceStarted", false);
+    const BlackboardKey<float> danceTimer = blackboard.add<float>("DanceTimer", 0.0f);
+    const BlackboardKey<float> lastSeenTimer = blackboard.add<float>("LastSeenTimer", 0.0f);
+    const BlackboardKey<bool> playerLastSeen = blackboard.add<bool>("PlayerLastSeen", false);
+    const BlackboardKey<int> obstacleDetections = blackboard.add<int>("ObstacleDetections", 0);
+    const BlackboardKey<float> timeSinceDance = blackboard.add<float>("TimeSinceDance", 0.0f);
+    const BlackboardKey<float> danceCooldown = blackboard.add<float>("DanceCooldown", 10.0f);
+    const BlackboardKey<bool> playerVisible = blackboard.add<bool>("PlayerVisible", false);
+    const BlackboardKey<bool> nearObstacle = blackboard.add<bool>("NearObstacle", false);
+    const BlackboardKey<bool> danceReady = blackboard.add<bool>("DanceReady", false);
+
     // Create actions
     auto pathfindToPlayerAction = std::make_shared<BehaviorActionNode>(
-        [&monster]()
+        [](BehaviorInstance &instance)
         {
-            monster.executeAction("PathfindToPlayer", monster.getDeltaTime());
+            Monster &monster = instance.getAgent<Monster>();
+            instance.issue([&monster]
+                           { monster.executeAction(ActionRegistry::PATHFIND_TO_PLAYER, monster.getDeltaTime()); });
             return BehaviorStatus::SUCCESS;
         },
         "PathfindToPlayer");
 
     // Create a FollowPath action node
     auto followPathAction = std::make_shared<BehaviorActionNode>(
-        [&monster]()
+        [](BehaviorInstance &instance)
         {
-            monster.executeAction("FollowPath", monster.getDeltaTime());
+            Monster &monster = instance.getAgent<Monster>();
+            instance.issue([&monster]
+                           { monster.executeAction(ActionRegistry::FOLLOW_PATH, monster.getDeltaTime()); });
             return BehaviorStatus::SUCCESS;
         },
         "FollowPath");
 
     auto wanderAction = std::make_shared<BehaviorActionNode>(
-        [&monster]()
+        [](BehaviorInstance &instance)
         {
-            monster.executeAction("Wander", monster.getDeltaTime());
+            Monster &monster = instance.getAgent<Monster>();
+            instance.issue([&monster]
+                           { monster.executeAction(ActionRegistry::WANDER, monster.getDeltaTime()); });
             return BehaviorStatus::SUCCESS;
         },
         "Wander");
 
-    auto sharedDanceState = std::make_shared<BehaviorState>();
-
     auto cardinalDanceAction = std::make_shared<BehaviorActionNode>(
-        [&monster, state = sharedDanceState]() mutable
+        [danceStarted, danceTimer, danceReady](BehaviorInstance &instance)
         {
-            // If we're not initialized, start the dance
-            if (!state->initialized)
+            Monster &monster = instance.getAgent<Monster>();
+            Blackboard &blackboard = instance.getBlackboard();
+
+            // If we haven't started, start the dance
+            if (!blackboard.get(danceStarted))
             {
-                state->initialized = true;
-                state->timer = 0.0f;
-                monster.executeAction("Dance", monster.getDeltaTime());
+                blackboard.set(danceStarted, true);
+                blackboard.set(danceTimer, 0.0f);
+                instance.issue([&monster]
+                               { monster.executeAction(ActionRegistry::DANCE, monster.getDeltaTime()); });
                 return BehaviorStatus::RUNNING;
             }
 
             // Update the dance timer with the correct delta time
-            state->timer += monster.getDeltaTime();
+            float timer = blackboard.get(danceTimer) + monster.getDeltaTime();
+            blackboard.set(danceTimer, timer);
 
             // Continue dance while in progress
-            if (state->timer < 2.0f)
+            if (timer < 2.0f)
             {
-                monster.executeAction("Dance", monster.getDeltaTime());
+                instance.issue([&monster]
+                               { monster.executeAction(ActionRegistry::DANCE, monster.getDeltaTime()); });
                 return BehaviorStatus::RUNNING;
             }
 
             // Dance is complete
-            state->initialized = false;
-            state->timer = 0.0f;
+            blackboard.set(danceStarted, false);
+            blackboard.set(danceTimer, 0.0f);
+            blackboard.set(danceReady, false);
             return BehaviorStatus::SUCCESS;
         },
         "CardinalDance");
 
     auto fleeAction = std::make_shared<BehaviorActionNode>(
-        [&monster]()
+        [](BehaviorInstance &instance)
         {
-            monster.executeAction("Flee", monster.getDeltaTime());
+            Monster &monster = instance.getAgent<Monster>();
+            instance.issue([&monster]
+                           { monster.executeAction(ActionRegistry::FLEE, monster.getDeltaTime()); });
             return BehaviorStatus::SUCCESS;
         },
         "Flee");
 
-    // Create conditions
-    auto canSeePlayerCondition = std::make_shared<ConditionNode>(
-        [&monster, lastSeenTimer = std::make_shared<float>(0.0f),
-         playerLastSeen = std::make_shared<bool>(false)]() -> bool
+    // Sense every tick and write what was sensed to the blackboard, so the conditions only read it
+    behaviorTree->setPerception(
+        [lastSeenTimer, playerLastSeen, playerVisible, obstacleDetections, nearObstacle,
+         timeSinceDance, danceCooldown, danceReady](BehaviorInstance &instance)
         {
-            // Get direction to player
-            sf::Vector2f monsterPos = monster.getPosition();
-            sf::Vector2f playerPos = monster.getPlayerKinematic().position;
-            sf::Vector2f toPlayer = playerPos - monsterPos;
+            Monster &monster = instance.getAgent<Monster>();
+            Blackboard &blackboard = instance.getBlackboard();
+            blackboard.set(playerVisible, canSeePlayer(monster, blackboard, lastSeenTimer, playerLastSeen));
 
-            // Calculate distance
-            float distance = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y);
+            // Only flee if we've detected obstacles multiple times in a row
+            int detections = isObstacleAhead(monster) ? blackboard.get(obstacleDetections) + 1 : 0;
+            blackboard.set(obstacleDetections, detections);
+            blackboard.set(nearObstacle, detections >= 2);
 
-            // Update last seen timer
-            *lastSeenTimer += monster.getDeltaTime();
-
-            // Can always "see" if extremely close
-            if (distance < 30.0f)
+            // Add elapsed time to the cooldown timer until a dance is due
+            if (!blackboard.get(danceReady))
             {
-                if (!*playerLastSeen)
+                float elapsed = blackboard.get(timeSinceDance) + monster.getDeltaTime();
+                blackboard.set(timeSinceDance, elapsed);
+
+                // Only allow dancing after cooldown period (10 seconds), then a random chance to dance (5%)
+                if (elapsed >= blackboard.get(danceCooldown) && instance.getRandom()() % 100 < 5)
                 {
-                    *playerLastSeen = true;
-                    *lastSeenTimer = 0.0f;
+                    std::cout << "DANCE CONDITION: Cooldown complete, triggering dance" << std::endl;
+                    // Reset cooldown timer if we decide to dance
+                    blackboard.set(timeSinceDance, 0.0f);
+                    blackboard.set(danceReady, true);
                 }
-                return true;
             }
+        });
 
-            // If too far away, can't see
-            if (distance > 250.0f)
-            {
-                *playerLastSeen = false;
-                return false;
-            }
-
-            // Check if player is within view cone (140 degrees)
-            float monsterAngle = monster.getKinematic().orientation * 3.14159f / 180.0f;
-            sf::Vector2f monsterDir(std::cos(monsterAngle), std::sin(monsterAngle));
-
-            // Normalize to player direction
-            toPlayer = toPlayer / distance;
-
-            // Dot product gives cosine of angle between vectors
-            float dot = monsterDir.x * toPlayer.x + monsterDir.y * toPlayer.y;
-
-            // Check if within 70° (cos(70°) ≈ 0.342)
-            bool withinViewCone = (dot > 0.342f);
-
-            // If not in view cone, can't see
-            if (!withinViewCone)
-            {
-                *playerLastSeen = false;
-                return false;
-            }
-
-            // Check line of sight
-            bool lineOfSight = monster.hasLineOfSightTo(playerPos);
-
-            if (!lineOfSight)
-            {
-                *playerLastSeen = false;
-                return false;
-            }
-
-            // If we get here, player is visible
-            if (!*playerLastSeen)
-            {
-                *playerLastSeen = true;
-                *lastSeenTimer = 0.0f;
-            }
-
-            return true;
+    // Create conditions; each observes its key, so a running dance is re-checked when the key changes
+    auto canSeePlayerCondition = std::make_shared<ConditionNode>(
+        [playerVisible](BehaviorInstance &instance) -> bool
+        {
+            return instance.getBlackboard().get(playerVisible);
         },
-        "CanSeePlayer");
+        "CanSeePlayer", std::vector<int>{playerVisible.id});
 
     auto isNearObstacleCondition = std::make_shared<ConditionNode>(
-        [&monster, detectionCount = std::make_shared<int>(0)]() -> bool
+        [nearObstacle](BehaviorInstance &instance) -> bool
         {
-            // Check for nearby obstacles using raycasting
-            sf::Vector2f position = monster.getPosition();
-            const Environment &env = monster.getEnvironment();
-
-            // Check primarily in the direction of movement
-            sf::Vector2f velocity = monster.getKinematic().velocity;
-            float speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
-
-            // If not moving, no need to flee
-            if (speed < 5.0f)
-            {
-                *detectionCount = 0;
-                return false;
-            }
-
-            // Normalize velocity to get direction
-            sf::Vector2f moveDir = velocity / speed;
-
-            // Check for obstacles directly ahead at close distances
-            for (float dist = 5.0f; dist <= 20.0f; dist += 5.0f)
-            {
-                sf::Vector2f checkPoint = position + moveDir * dist;
-                if (env.isObstacle(checkPoint))
-                {
-                    (*detectionCount)++;
-                    // Only flee if we've detected obstacles multiple times in a row
-                    return *detectionCount >= 2;
-                }
-            }
-
-            // Check in a 45-degree cone around movement direction
-            for (int angleOffset = -45; angleOffset <= 45; angleOffset += 15)
-            {
-                if (angleOffset == 0)
-                    continue; // Already checked straight ahead
-
-                float radians = std::atan2(moveDir.y, moveDir.x) + (angleOffset * 3.14159f / 180.0f);
-                sf::Vector2f rayDir(std::cos(radians), std::sin(radians));
-
-                for (float dist = 5.0f; dist <= 15.0f; dist += 5.0f)
-                {
-                    sf::Vector2f checkPoint = position + rayDir * dist;
-                    if (env.isObstacle(checkPoint))
-                    {
-                        (*detectionCount)++;
-                        return *detectionCount >= 2;
-                    }
-                }
-            }
-
-            // No obstacles detected
-            *detectionCount = 0;
-            return false;
+            return instance.getBlackboard().get(nearObstacle);
         },
-        "IsNearObstacle");
+        "IsNearObstacle", std::vector<int>{nearObstacle.id});
 
     auto shouldDanceCondition = std::make_shared<ConditionNode>(
-        [&monster, lastDanceTime = std::make_shared<float>(0.0f),
-         cooldownTime = std::make_shared<float>(10.0f)]() mutable -> bool
+        [danceReady](BehaviorInstance &instance) -> bool
         {
-            // Add elapsed time to the cooldown timer
-            *lastDanceTime += monster.getDeltaTime();
-
-            // Only allow dancing after cooldown period (10 seconds)
-            if (*lastDanceTime >= *cooldownTime)
-            {
-                // Random chance to dance (5%)
-                bool shouldDance = (rand() % 100) < 5;
-
-                if (shouldDance)
-                {
-                    std::cout << "DANCE CONDITION: Cooldown complete, triggering dance" << std::endl;
-                    // Reset cooldown timer if we decide to dance
-                    *lastDanceTime = 0.0f;
-                    return true;
-                }
-            }
-
-            return false;
+            return instance.getBlackboard().get(danceReady);
         },
-        "ShouldDance");
+        "ShouldDance", std::vector<int>{danceReady.id});
 
     // Create chase sequence
     auto chaseSequence = std::make_shared<SequenceNode>("Chase Sequence");
@@ -1030,7 +1190,7 @@ std::shared_ptr<EnvironmentState> Monster::createEnvironmentState()
     }
 
     // Update the state to reflect current conditions
-    state->update();
+    state->update(0.0f);
 
     return state;
 }
@@ -1038,18 +1198,24 @@ std::shared_ptr<EnvironmentState> Monster::createEnvironmentState()
 /**
  * @brief Create a decision tree for the player character
  * This function implements a more complex decision tree for the player's autonomous movement
+ * @param targetPositions If given, filled with the position each pathfind action heads to
  */
-std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &state, Environment &environment)
+std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &state, Environment &environment,
+                                                          std::unordered_map<ActionId, sf::Vector2f> *targetPositions)
 {
     auto decisionTree = std::make_shared<DecisionTree>(state);
 
-    // Create potential target positions adjusted for environment size
-    std::vector<sf::Vector2f> potentialTargets = {
-        {100, 100}, // Top-left room
-        {500, 100}, // Top-right room
-        {100, 350}, // Bottom-left room
-        {500, 350}, // Bottom-right room
-        {250, 250}  // Center
+    // Pathfind actions are named after their target; the position is recorded by id so
+    // the caller never has to parse it back out of the name
+    auto makeTargetAction = [targetPositions](const sf::Vector2f &target)
+    {
+        auto action = std::make_shared<ActionNode>("PathfindTo_" + std::to_string(int(target.x)) + "_" +
+                                                   std::to_string(int(target.y)));
+        if (targetPositions)
+        {
+            (*targetPositions)[action->makeDecision()] = target;
+        }
+        return action;
     };
 
     // Define conditions for decision making
@@ -1099,12 +1265,24 @@ std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &stat
         return (rand() % 100) < 2;
     };
 
+    // The same conditions as feature tests, so the compiled tree can also decide for a whole crowd at once
+    using Comparison = FeatureTest::Comparison;
+    const FeatureTest nearObstacleTest(EnvironmentState::FEATURE_OBSTACLE_DISTANCE, Comparison::LESS, 40.0f);
+    const FeatureTest movingFastTest(EnvironmentState::FEATURE_SPEED, Comparison::GREATER, 120.0f);
+    const FeatureTest idleTooLongTest(EnvironmentState::FEATURE_IDLE_TIME, Comparison::GREATER_EQUAL, 3.0f);
+    const FeatureTest changeTargetTest(EnvironmentState::FEATURE_CHANGE_TARGET, Comparison::EQUAL, 1.0f);
+    const FeatureTest danceTest(EnvironmentState::FEATURE_RANDOM_ROLL, Comparison::LESS, 2.0f);
+    auto roomTest = [](int room)
+    {
+        return FeatureTest(EnvironmentState::FEATURE_ROOM, Comparison::EQUAL, static_cast<float>(room));
+    };
+
     // Create action nodes for different targets
-    auto pathfindToTopLeft = std::make_shared<ActionNode>("PathfindTo_100_100");
-    auto pathfindToTopRight = std::make_shared<ActionNode>("PathfindTo_500_100");
-    auto pathfindToBottomLeft = std::make_shared<ActionNode>("PathfindTo_100_350");
-    auto pathfindToBottomRight = std::make_shared<ActionNode>("PathfindTo_500_350");
-    auto pathfindToCenter = std::make_shared<ActionNode>("PathfindTo_250_250");
+    auto pathfindToTopLeft = makeTargetAction({100, 100});
+    auto pathfindToTopRight = makeTargetAction({500, 100});
+    auto pathfindToBottomLeft = makeTargetAction({100, 350});
+    auto pathfindToBottomRight = makeTargetAction({500, 350});
+    auto pathfindToCenter = makeTargetAction({250, 250});
     auto wanderAction = std::make_shared<ActionNode>("Wander");
     auto fleeAction = std::make_shared<ActionNode>("Flee");
     auto danceAction = std::make_shared<ActionNode>("Dance");
@@ -1137,47 +1315,57 @@ std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &stat
             shouldChangeTarget,
             randomTargetNode1,
             pathfindToTopLeft,
-            "Should change target in top-left room?"),
+            "Should change target in top-left room?",
+            changeTargetTest),
         std::make_shared<DecisionBranch>(
             isInTopRightRoom,
             std::make_shared<DecisionBranch>(
                 shouldChangeTarget,
                 randomTargetNode2,
                 pathfindToTopRight,
-                "Should change target in top-right room?"),
+                "Should change target in top-right room?",
+                changeTargetTest),
             std::make_shared<DecisionBranch>(
                 isInBottomLeftRoom,
                 std::make_shared<DecisionBranch>(
                     shouldChangeTarget,
                     randomTargetNode3,
                     pathfindToBottomLeft,
-                    "Should change target in bottom-left room?"),
+                    "Should change target in bottom-left room?",
+                    changeTargetTest),
                 std::make_shared<DecisionBranch>(
                     isInBottomRightRoom,
                     std::make_shared<DecisionBranch>(
                         shouldChangeTarget,
                         randomTargetNode4,
                         pathfindToBottomRight,
-                        "Should change target in bottom-right room?"),
+                        "Should change target in bottom-right room?",
+                        changeTargetTest),
                     pathfindToCenter, // Default if not in any specific room
-                    "In bottom-right room?"),
-                "In bottom-left room?"),
-            "In top-right room?"),
-        "In top-left room?");
+                    "In bottom-right room?",
+                    roomTest(3)),
+                "In bottom-left room?",
+                roomTest(2)),
+            "In top-right room?",
+            roomTest(1)),
+        "In top-left room?",
+        roomTest(0));
 
     // Special behavior branch
     auto specialBehaviorNode = std::make_shared<DecisionBranch>(
         shouldDance,
         danceAction,
         targetSelectionNode,
-        "Should dance?");
+        "Should dance?",
+        danceTest);
 
     // Movement safety branch
     auto safetyNode = std::make_shared<DecisionBranch>(
         isNearObstacle,
         fleeAction,
         specialBehaviorNode,
-        "Near obstacle?");
+        "Near obstacle?",
+        nearObstacleTest);
 
     // Main decision branch
     auto rootNode = std::make_shared<DecisionBranch>(
@@ -1187,11 +1375,14 @@ std::shared_ptr<DecisionTree> createCharacterDecisionTree(EnvironmentState &stat
             isIdleTooLong,
             wanderAction,
             targetSelectionNode,
-            "Idle too long?"),
-        "Moving fast?");
+            "Idle too long?",
+            idleTooLongTest),
+        "Moving fast?",
+        movingFastTest);
 
-    // Set the root node
+    // Set the root node and flatten the tree for evaluation
     decisionTree->setRootNode(rootNode);
+    decisionTree->compile();
 
     // Log tree creation
     std::cout << "Created decision tree for character" << std::endl;
@@ -1252,6 +1443,7 @@ std::shared_ptr<DecisionTree> learnDecisionTreeFromBehaviorTree(const std::strin
 
 /**
  * @brief Record data from the behavior tree monster for training
+ * @note Runs headless through HeadlessRunner, so it needs no window and runs as fast as the CPU allows.
  */
 void recordBehaviorTreeData(Monster &monster, const std::string &outputFile, int frames)
 {
@@ -1267,37 +1459,267 @@ void recordBehaviorTreeData(Monster &monster, const std::string &outputFile, int
          << "CanSeePlayer,IsNearObstacle,PathCount,"
          << "TimeInCurrentAction,Action" << std::endl;
 
-    // Create window for simulation
-    sf::RenderWindow window(sf::VideoMode(640, 480), "Recording Data");
+    // Record for specified number of frames, one fixed step each, with no window
+    HeadlessRunner runner;
+    HeadlessStats stats = runner.run(frames, [&](float deltaTime)
+                                     {
+        monster.update(deltaTime);
+        monster.recordStateAction(file); });
+
+    HeadlessRunner::report(std::cout, "recording", 1, stats);
+    file.close();
+}
 
-    // Clock for delta time
-    sf::Clock clock;
+/**
+ * @brief Run the chase without a window and report ticks per second and catches.
+ * @param environment Environment the agents move in.
+ * @param graph Navigation graph for pathfinding.
+ * @param monsterCount Number of behavior tree monsters.
+ * @param ticks Number of simulation steps.
+ * @param clearance Distance smoothed paths keep from walls.
+ * @return Exit status.
+ * @note The player walks A* paths to random open vertices; each monster runs its own instance of one
+ * shared behavior tree. The trees tick on the worker pool and only queue their moves, which are then
+ * made in monster order, so the result does not depend on the thread count.
+ * A catch puts the player back at its start and resets the monster, as in the windowed demo.
+ */
+int runHeadlessChase(Environment &environment, Graph &graph, int monsterCount, long long ticks, float clearance)
+{
+    std::mt19937 rng(584); // Fixed seed so runs are repeatable
+    std::uniform_int_distribution<int> vertexDistribution(0, graph.size() - 1);
 
-    // Record for specified number of frames
-    for (int i = 0; i < frames && window.isOpen(); i++)
+    // Textures are never loaded; the agents only keep a reference to them
+    sf::Texture agentTexture;
+    sf::Vector2f playerStartPos(100, 100);
+    PathFollower player(playerStartPos, agentTexture);
+
+    // Every monster runs the same tree; its instance points back at it, so monsters are kept behind pointers
+    std::shared_ptr<BehaviorTree> behaviorTree = createMonsterBehaviorTree();
+    std::vector<std::unique_ptr<Monster>> monsters;
+    for (int i = 0; i < monsterCount; i++)
     {
-        // Process events
-        sf::Event event;
-        while (window.pollEvent(event))
+        sf::Vector2f monsterStartPos(400 - (i % 5) * 60, 400 - (i / 5 % 5) * 60);
+        monsters.push_back(std::make_unique<Monster>(monsterStartPos, agentTexture, environment, graph, sf::Color::Red));
+        monsters.back()->setPlayerKinematic(player.getKinematic());
+        monsters.back()->setControlType(Monster::ControlType::BEHAVIOR_TREE);
+        monsters.back()->setBehaviorTree(behaviorTree);
+    }
+
+    AStar astar([](int current, int goal, const Graph &g)
+                {
+        sf::Vector2f currentPos = g.getVertexPosition(current);
+        sf::Vector2f goalPos = g.getVertexPosition(goal);
+        float dx = goalPos.x - currentPos.x;
+        float dy = goalPos.y - currentPos.y;
+        return std::sqrt(dx * dx + dy * dy); });
+
+    long long catches = 0;
+    WorkerPool workers;
+    HeadlessRunner runner;
+    HeadlessStats stats = runner.run(ticks, [&](float deltaTime)
+                                     {
+        // New random destination once the player's path is done
+        if (player.pathCompleted())
         {
-            if (event.type == sf::Event::Closed)
+            int goalVertex = vertexDistribution(rng);
+            if (!environment.isObstacle(graph.getVertexPosition(goalVertex)))
             {
-                window.close();
+                std::vector<int> path = astar.findPath(graph, environment.pointToVertex(player.getPosition()), goalVertex);
+                std::vector<sf::Vector2f> waypoints;
+                for (int vertex : path)
+                {
+                    waypoints.push_back(graph.getVertexPosition(vertex));
+                }
+                player.setPath(PathSmoothing::smoothFrom(player.getPosition(), waypoints, environment, clearance));
             }
         }
 
-        // Update monster
-        float deltaTime = clock.restart().asSeconds();
-        monster.update(deltaTime);
+        player.update(deltaTime);
 
-        // Record state and action
-        monster.recordStateAction(file);
+        // Every monster decides in parallel, then the moves they queued are made one monster at a time
+        workers.parallelFor(monsters.size(), [&](size_t begin, size_t end)
+                            {
+            for (size_t i = begin; i < end; i++)
+            {
+                monsters[i]->think(deltaTime);
+            } });
 
-        // Render (optional, can be disabled for faster recording)
-        window.clear(sf::Color::White);
-        monster.draw(window);
-        window.display();
+        for (std::unique_ptr<Monster> &monster : monsters)
+        {
+            if (monster->act(deltaTime))
+            {
+                catches++;
+                player.setPosition(playerStartPos);
+                monster->reset();
+            }
+        } });
+
+    HeadlessRunner::report(std::cout, "chase", monsters.size() + 1, stats);
+    std::cout << catches << " catches" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Run the player's decision tree for a crowd of agents without a window, in batches.
+ * @param environment Environment the agents move in.
+ * @param agentCount Number of agents.
+ * @param ticks Number of simulation steps.
+ * @return Exit status.
+ * @note The agents drift in straight lines and bounce off walls so their features change. Every tick
+ * their states are updated and written into feature columns in parallel, and the compiled tree decides
+ * for all of them at once on the worker pool. Prints ticks per second, the time spent deciding and
+ * how often each action was chosen.
+ */
+int runHeadlessDecisions(Environment &environment, int agentCount, long long ticks)
+{
+    std::mt19937 rng(584); // Fixed seed so runs are repeatable
+    std::uniform_real_distribution<float> xDistribution(40.0f, 600.0f);
+    std::uniform_real_distribution<float> yDistribution(40.0f, 440.0f);
+    std::uniform_real_distribution<float> speedDistribution(-150.0f, 150.0f);
+
+    // Agents start at random open positions with random velocities
+    std::vector<Kinematic> characters;
+    characters.reserve(agentCount); // States keep references to these
+    for (int i = 0; i < agentCount; i++)
+    {
+        sf::Vector2f position(xDistribution(rng), yDistribution(rng));
+        while (environment.isObstacle(position))
+        {
+            position = sf::Vector2f(xDistribution(rng), yDistribution(rng));
+        }
+        characters.emplace_back(position, sf::Vector2f(speedDistribution(rng), speedDistribution(rng)));
     }
 
-    file.close();
-}
\ No newline at end of file
+    std::vector<EnvironmentState> states;
+    states.reserve(agentCount);
+    for (const Kinematic &character : characters)
+    {
+        states.emplace_back(character, environment);
+    }
+
+    // One tree for the whole crowd; its conditions are only used through their feature tests
+    std::shared_ptr<DecisionTree> decisionTree = createCharacterDecisionTree(states.front(), environment);
+
+    WorkerPool workers;
+    DecisionFeatures features(EnvironmentState::FEATURE_COUNT, agentCount);
+    std::vector<ActionId> actions(agentCount);
+    std::vector<long long> actionCounts;
+    double decisionSeconds = 0;
+    unsigned tick = 0;
+
+    HeadlessRunner runner;
+    HeadlessStats stats = runner.run(ticks, [&](float deltaTime)
+                                     {
+        // Move every agent, update its state and write its features in parallel; each thread only
+        // touches its own agents
+        workers.parallelFor(characters.size(), [&](size_t begin, size_t end)
+                            {
+            for (size_t i = begin; i < end; i++)
+            {
+                Kinematic &character = characters[i];
+                sf::Vector2f next = character.position + character.velocity * deltaTime;
+                if (environment.isObstacle(next))
+                {
+                    character.velocity = -character.velocity;
+                }
+                else
+                {
+                    character.position = next;
+                }
+                states[i].update(deltaTime);
+                states[i].writeFeatures(features, static_cast<int>(i));
+            } });
+
+        auto start = std::chrono::steady_clock::now();
+        decisionTree->makeDecisions(features, actions.data(), tick++, &workers);
+        decisionSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (ActionId action : actions)
+        {
+            if (action >= static_cast<ActionId>(actionCounts.size()))
+            {
+                actionCounts.resize(action + 1, 0);
+            }
+            actionCounts[action]++;
+        } });
+
+    HeadlessRunner::report(std::cout, "decisions", agentCount, stats);
+    std::cout << "Deciding took " << decisionSeconds * 1000.0 / ticks << " ms per tick on "
+              << workers.getThreadCount() << " threads" << std::endl;
+    for (size_t action = 0; action < actionCounts.size(); action++)
+    {
+        if (actionCounts[action] > 0)
+        {
+            std::cout << "  " << ActionRegistry::getName(static_cast<ActionId>(action)) << ": " << actionCounts[action] << std::endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Profile the player's decision tree on a simulated run and reorder its conditions.
+ * @param environment Environment the character moves in.
+ * @param ticks Number of decisions to profile.
+ * @return Exit status.
+ * @note One character drifts and bounces off walls like the --decisions crowd, moving to a random
+ * open spot every ten seconds so it sees every room, and decides every tick with the compiled tree. The measured cost and true rate of each condition then drive
+ * DecisionTree::optimizeConditionOrder, which prints the groups it reordered and their expected
+ * cost per decision before and after. The profile is saved to DECISION_PROFILE_FILE, and the
+ * windowed demo reorders the player's tree from it at startup.
+ */
+int optimizeDecisionOrder(Environment &environment, long long ticks)
+{
+    std::mt19937 rng(584); // Fixed seed so runs are repeatable
+    std::uniform_real_distribution<float> xDistribution(40.0f, 600.0f);
+    std::uniform_real_distribution<float> yDistribution(40.0f, 440.0f);
+    std::uniform_real_distribution<float> speedDistribution(-150.0f, 150.0f);
+
+    Kinematic character;
+    EnvironmentState state(character, environment);
+    std::shared_ptr<DecisionTree> decisionTree = createCharacterDecisionTree(state, environment);
+    decisionTree->setProfiling(true);
+
+    long long tick = 0;
+    HeadlessRunner runner;
+    HeadlessStats stats = runner.run(ticks, [&](float deltaTime)
+                                     {
+        if (tick++ % 600 == 0)
+        {
+            do
+            {
+                character.position = sf::Vector2f(xDistribution(rng), yDistribution(rng));
+            } while (environment.isObstacle(character.position));
+            character.velocity = sf::Vector2f(speedDistribution(rng), speedDistribution(rng));
+        }
+
+        sf::Vector2f next = character.position + character.velocity * deltaTime;
+        if (environment.isObstacle(next))
+        {
+            character.velocity = -character.velocity;
+        }
+        else
+        {
+            character.position = next;
+        }
+        state.update(deltaTime);
+        decisionTree->makeDecision(); });
+
+    HeadlessRunner::report(std::cout, "profile", 1, stats);
+    std::cout << "Decision tree conditions:" << std::endl;
+    decisionTree->printProfile(std::cout);
+    std::cout << "Condition order:" << std::endl;
+    std::ostringstream reorderLog;
+    decisionTree->optimizeConditionOrder(&reorderLog);
+    if (reorderLog.str().empty())
+    {
+        std::cout << "  No group moved; no other order is clearly cheaper than the written one" << std::endl;
+    }
+    std::cout << reorderLog.str();
+
+    if (!decisionTree->saveConditionProfile(DECISION_PROFILE_FILE))
+    {
+        return 1;
+    }
+    std::cout << "Saved condition profile to " << DECISION_PROFILE_FILE << std::endl;
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file ActionRegistry.cpp
+ * @brief Implementation of the ActionRegistry.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#include "headers/ActionRegistry.h"
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Names indexed by id and ids keyed by name
+     */
+    struct ActionTable
+    {
+        std::vector<std::string> names;
+        std::unordered_map<std::string, ActionId> ids;
+
+        ActionTable()
+        {
+            // Same order as the built-in ids
+            for (const char *name : {"Idle", "PathfindToPlayer", "Wander", "FollowPath", "Dance", "Flee"})
+            {
+                ids[name] = static_cast<ActionId>(names.size());
+                names.push_back(name);
+            }
+        }
+    };
+
+    ActionTable &table()
+    {
+        static ActionTable actions; // Built on first use, so it is ready before any tree is made
+        return actions;
+    }
+}
+
+ActionId ActionRegistry::intern(const std::string &name)
+{
+    ActionTable &actions = table();
+    auto it = actions.ids.find(name);
+    if (it != actions.ids.end())
+    {
+        return it->second;
+    }
+
+    ActionId id = static_cast<ActionId>(actions.names.size());
+    actions.names.push_back(name);
+    actions.ids[name] = id;
+    return id;
+}
+
+ActionId ActionRegistry::find(const std::string &name)
+{
+    const ActionTable &actions = table();
+    auto it = actions.ids.find(name);
+    return it == actions.ids.end() ? NONE : it->second;
+}
+
+const std::string &ActionRegistry::getName(ActionId id)
+{
+    static const std::string noName;
+    const ActionTable &actions = table();
+    return (id >= 0 && id < static_cast<ActionId>(actions.names.size())) ? actions.names[id] : noName;
+}
+
+int ActionRegistry::size()
+{
+    return static_cast<int>(table().names.size());
+}
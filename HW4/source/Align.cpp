@@ -1,5 +1,8 @@
 #include "../headers/Align.h"
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "../headers/Float4.h"
 
 // Constructor
 Align::Align(float maxAngularAcceleration, float maxRotation, float targetRadius, float slowRadius, float timeToTarget)
@@ -51,3 +54,50 @@ SteeringData Align::calculateAcceleration(const Kinematic& character, const Kine
     result.linear = {0, 0};
     return result;
 }
+
+// Batch version: gathers 4 characters into lanes and runs the steps above without branches
+void Align::calculateAccelerations(const Kinematic* characters, const Kinematic* targets,
+                                   SteeringData* results, size_t count) {
+#ifdef FLOAT4_SIMD
+    for (size_t first = 0; first < count; first += 4) {
+        size_t lanes = std::min<size_t>(4, count - first);
+
+        // Wrap the orientation difference while gathering; unused lanes stay at zero (no steering)
+        float rotationLanes[4] = {}, currentLanes[4] = {};
+        for (size_t i = 0; i < lanes; i++) {
+            float rotation = targets[first + i].orientation - characters[first + i].orientation;
+            while (rotation > 180) rotation -= 360;
+            while (rotation < -180) rotation += 360;
+            rotationLanes[i] = rotation;
+            currentLanes[i] = characters[first + i].rotation;
+        }
+        Float4 rotation = Float4::load(rotationLanes);
+        Float4 currentRotation = Float4::load(currentLanes);
+        Float4 rotationSize = abs(rotation);
+
+        // Rotate at max speed outside the slow radius, scaled inside it, in the direction of the target
+        Float4 fastest = Float4::splat(maxRotation);
+        Float4 targetRotation = select(rotationSize > Float4::splat(slowRadius), fastest,
+                                       fastest * (rotationSize / Float4::splat(slowRadius)));
+        targetRotation = targetRotation * (rotation / max(rotationSize, Float4::splat(FLT_MIN)));
+
+        // Angular acceleration, clamped
+        Float4 angular = (targetRotation - currentRotation) / Float4::splat(timeToTarget);
+        Float4 angularAcceleration = abs(angular);
+        angular = select(angularAcceleration > Float4::splat(maxAngularAcceleration),
+                         (angular / angularAcceleration) * Float4::splat(maxAngularAcceleration), angular);
+
+        // No steering inside the target radius
+        angular = select(rotationSize < Float4::splat(targetRadius), Float4::splat(0), angular);
+
+        float out[4];
+        angular.store(out);
+        for (size_t i = 0; i < lanes; i++) {
+            results[first + i] = SteeringData(sf::Vector2f(0, 0), out[i]);
+        }
+    }
+#else
+    // Without a vector backend the lanes are plain loops, so the per-agent version is faster
+    SteeringBehavior::calculateAccelerations(characters, targets, results, count);
+#endif
+}
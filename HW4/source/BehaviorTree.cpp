@@ -10,103 +10,199 @@
  */
 
 #include "headers/BehaviorTree.h"
+#include "headers/WorkerPool.h"
+#include <cassert>
 #include <iostream>
+#include <unordered_set>
 
 // SequenceNode implementation
-BehaviorStatus SequenceNode::tick()
+BehaviorStatus SequenceNode::tick(BehaviorInstance &instance) const
 {
+    CompositeState &state = instance.getState<CompositeState>(*this);
+
     // If not running, start from the beginning
-    if (!isRunning)
+    if (!state.isRunning)
     {
-        currentChild = 0;
+        state.currentChild = 0;
     }
 
     // Continue from where we left off
-    while (currentChild < children.size())
+    while (state.currentChild < children.size())
     {
-        BehaviorStatus status = children[currentChild]->tick();
+        BehaviorStatus status = children[state.currentChild]->tick(instance);
 
         if (status == BehaviorStatus::RUNNING)
         {
-            isRunning = true;
+            state.isRunning = true;
             return BehaviorStatus::RUNNING;
         }
         else if (status == BehaviorStatus::FAILURE)
         {
             // Child failed, entire sequence fails
-            isRunning = false;
+            state.isRunning = false;
             return BehaviorStatus::FAILURE;
         }
 
         // Child succeeded, move to next child
-        currentChild++;
+        state.currentChild++;
     }
 
     // All children succeeded
-    isRunning = false;
+    state.isRunning = false;
     return BehaviorStatus::SUCCESS;
 }
 
-void SequenceNode::reset()
+void SequenceNode::reset(BehaviorInstance &instance) const
 {
-    currentChild = 0;
-    isRunning = false;
+    instance.getState<CompositeState>(*this) = CompositeState();
     for (auto &child : children)
     {
-        child->reset();
+        child->reset(instance);
+    }
+}
+
+void SequenceNode::getChildren(std::vector<const BehaviorNode *> &result) const
+{
+    for (const auto &child : children)
+    {
+        result.push_back(child.get());
     }
 }
 
+const BehaviorNode *SequenceNode::getRunningChild(const BehaviorInstance &instance) const
+{
+    const CompositeState &state = instance.getState<CompositeState>(*this);
+    return state.isRunning ? children[state.currentChild].get() : nullptr;
+}
+
+BehaviorStatus SequenceNode::resume(BehaviorInstance &instance, BehaviorStatus childStatus) const
+{
+    CompositeState &state = instance.getState<CompositeState>(*this);
+    if (childStatus == BehaviorStatus::FAILURE)
+    {
+        state.isRunning = false;
+        return BehaviorStatus::FAILURE;
+    }
+
+    // Still running, so tick continues with the next child
+    state.currentChild++;
+    return tick(instance);
+}
+
+void SequenceNode::getGuards(const BehaviorInstance &instance, std::vector<BehaviorGuard> &guards) const
+{
+    const CompositeState &state = instance.getState<CompositeState>(*this);
+    for (size_t i = 0; i < state.currentChild; i++)
+    {
+        if (const ConditionNode *condition = children[i]->getLeadingCondition())
+        {
+            guards.push_back({condition, true});
+        }
+    }
+}
+
+bool SequenceNode::failedAtLeadingCondition(const BehaviorInstance &instance) const
+{
+    // A failed sequence stops at the child that failed
+    return !children.empty() && instance.getState<CompositeState>(*this).currentChild == 0 &&
+           children.front()->failedAtLeadingCondition(instance);
+}
+
 // SelectorNode implementation
-BehaviorStatus SelectorNode::tick()
+BehaviorStatus SelectorNode::tick(BehaviorInstance &instance) const
 {
+    CompositeState &state = instance.getState<CompositeState>(*this);
+
     // If not running, start from the beginning
-    if (!isRunning)
+    if (!state.isRunning)
     {
-        currentChild = 0;
+        state.currentChild = 0;
     }
 
     // Continue from where we left off
-    while (currentChild < children.size())
+    while (state.currentChild < children.size())
     {
-        BehaviorStatus status = children[currentChild]->tick();
+        BehaviorStatus status = children[state.currentChild]->tick(instance);
 
         if (status == BehaviorStatus::RUNNING)
         {
-            isRunning = true;
+            state.isRunning = true;
             return BehaviorStatus::RUNNING;
         }
         else if (status == BehaviorStatus::SUCCESS)
         {
             // Child succeeded, entire selector succeeds
-            isRunning = false;
+            state.isRunning = false;
             return BehaviorStatus::SUCCESS;
         }
 
         // Child failed, try the next one
-        currentChild++;
+        state.currentChild++;
     }
 
     // All children failed
-    isRunning = false;
+    state.isRunning = false;
     return BehaviorStatus::FAILURE;
 }
 
-void SelectorNode::reset()
+void SelectorNode::reset(BehaviorInstance &instance) const
 {
-    currentChild = 0;
-    isRunning = false;
+    instance.getState<CompositeState>(*this) = CompositeState();
     for (auto &child : children)
     {
-        child->reset();
+        child->reset(instance);
+    }
+}
+
+void SelectorNode::getChildren(std::vector<const BehaviorNode *> &result) const
+{
+    for (const auto &child : children)
+    {
+        result.push_back(child.get());
+    }
+}
+
+const BehaviorNode *SelectorNode::getRunningChild(const BehaviorInstance &instance) const
+{
+    const CompositeState &state = instance.getState<CompositeState>(*this);
+    return state.isRunning ? children[state.currentChild].get() : nullptr;
+}
+
+BehaviorStatus SelectorNode::resume(BehaviorInstance &instance, BehaviorStatus childStatus) const
+{
+    CompositeState &state = instance.getState<CompositeState>(*this);
+    if (childStatus == BehaviorStatus::SUCCESS)
+    {
+        state.isRunning = false;
+        return BehaviorStatus::SUCCESS;
+    }
+
+    // Still running, so tick continues with the next child
+    state.currentChild++;
+    return tick(instance);
+}
+
+void SelectorNode::getGuards(const BehaviorInstance &instance, std::vector<BehaviorGuard> &guards) const
+{
+    const CompositeState &state = instance.getState<CompositeState>(*this);
+    for (size_t i = 0; i < state.currentChild; i++)
+    {
+        const ConditionNode *condition = children[i]->getLeadingCondition();
+        if (condition && children[i]->failedAtLeadingCondition(instance))
+        {
+            guards.push_back({condition, false});
+        }
     }
 }
 
 // InverterNode implementation
-BehaviorStatus InverterNode::tick()
+BehaviorStatus InverterNode::tick(BehaviorInstance &instance) const
 {
-    BehaviorStatus status = child->tick();
+    return resume(instance, child->tick(instance));
+}
 
+BehaviorStatus InverterNode::resume(BehaviorInstance &instance, BehaviorStatus status) const
+{
     if (status == BehaviorStatus::SUCCESS)
     {
         return BehaviorStatus::FAILURE;
@@ -121,17 +217,20 @@ BehaviorStatus InverterNode::tick()
 }
 
 // RepeatNode implementation
-BehaviorStatus RepeatNode::tick()
+BehaviorStatus RepeatNode::tick(BehaviorInstance &instance) const
 {
     // If we've reached the maximum repeat count, succeed
-    if (maxRepeatCount > 0 && repeatCount >= maxRepeatCount)
+    if (maxRepeatCount > 0 && instance.getState<int32_t>(*this) >= maxRepeatCount)
     {
         return BehaviorStatus::SUCCESS;
     }
 
     // Tick the child
-    BehaviorStatus status = child->tick();
+    return resume(instance, child->tick(instance));
+}
 
+BehaviorStatus RepeatNode::resume(BehaviorInstance &instance, BehaviorStatus status) const
+{
     // If the child is still running, we're still running
     if (status == BehaviorStatus::RUNNING)
     {
@@ -141,8 +240,9 @@ BehaviorStatus RepeatNode::tick()
     // If the child succeeded or failed, increment the count and reset the child
     if (status == BehaviorStatus::SUCCESS || status == BehaviorStatus::FAILURE)
     {
+        int32_t &repeatCount = instance.getState<int32_t>(*this);
         repeatCount++;
-        child->reset();
+        child->reset(instance);
 
         // If we've reached the maximum repeat count, succeed
         if (maxRepeatCount > 0 && repeatCount >= maxRepeatCount)
@@ -158,52 +258,89 @@ BehaviorStatus RepeatNode::tick()
     return BehaviorStatus::FAILURE;
 }
 
-void RepeatNode::reset()
+void RepeatNode::reset(BehaviorInstance &instance) const
 {
-    repeatCount = 0;
-    child->reset();
+    instance.getState<int32_t>(*this) = 0;
+    child->reset(instance);
 }
 
 // RandomSelectorNode implementation
-BehaviorStatus RandomSelectorNode::tick()
+BehaviorStatus RandomSelectorNode::tick(BehaviorInstance &instance) const
 {
+    RandomSelectorState &state = instance.getState<RandomSelectorState>(*this);
+
     // If we haven't selected a child yet, or we're not running anymore, select a new one
-    if (selectedChild == -1 || lastStatus != BehaviorStatus::RUNNING)
+    if (state.selectedChild == -1 || state.lastStatus != BehaviorStatus::RUNNING)
     {
         // Select a random child
-        selectedChild = rand() % children.size();
+        state.selectedChild = instance.getRandom()() % children.size();
     }
 
     // Execute the selected child
-    lastStatus = children[selectedChild]->tick();
-    return lastStatus;
+    state.lastStatus = children[state.selectedChild]->tick(instance);
+    return state.lastStatus;
 }
 
-void RandomSelectorNode::reset()
+void RandomSelectorNode::reset(BehaviorInstance &instance) const
 {
-    selectedChild = -1;
-    lastStatus = BehaviorStatus::FAILURE;
+    instance.getState<RandomSelectorState>(*this) = RandomSelectorState();
     for (auto &child : children)
     {
-        child->reset();
+        child->reset(instance);
+    }
+}
+
+void RandomSelectorNode::getChildren(std::vector<const BehaviorNode *> &result) const
+{
+    for (const auto &child : children)
+    {
+        result.push_back(child.get());
     }
 }
 
+const BehaviorNode *RandomSelectorNode::getRunningChild(const BehaviorInstance &instance) const
+{
+    const RandomSelectorState &state = instance.getState<RandomSelectorState>(*this);
+    return state.lastStatus == BehaviorStatus::RUNNING ? children[state.selectedChild].get() : nullptr;
+}
+
+BehaviorStatus RandomSelectorNode::resume(BehaviorInstance &instance, BehaviorStatus childStatus) const
+{
+    RandomSelectorState &state = instance.getState<RandomSelectorState>(*this);
+    state.lastStatus = childStatus;
+    return state.lastStatus;
+}
+
 // ParallelNode implementation
-BehaviorStatus ParallelNode::tick()
+BehaviorStatus ParallelNode::tick(BehaviorInstance &instance) const
 {
+    BehaviorStatus *childStatuses = &instance.getState<BehaviorStatus>(*this);
     int successCount = 0;
     int failureCount = 0;
 
-    // Execute all children
-    for (size_t i = 0; i < children.size(); i++)
+    // Execute all children, split across the pool if there is one; each writes only its own status
+    if (workers)
     {
-        // Only tick if the child isn't already in a terminal state
-        if (childStatuses[i] == BehaviorStatus::RUNNING)
+        // Flag the instance so a child that writes the blackboard, issues a command or draws a random number is caught
+        bool outermost = !instance.isTickingConcurrently();
+        if (outermost)
         {
-            childStatuses[i] = children[i]->tick();
+            instance.setTickingConcurrently(true);
         }
+        workers->parallelFor(children.size(), [this, &instance](size_t begin, size_t end)
+                             { tickChildren(instance, begin, end); });
+        if (outermost)
+        {
+            instance.setTickingConcurrently(false);
+        }
+    }
+    else
+    {
+        tickChildren(instance, 0, children.size());
+    }
 
+    for (size_t i = 0; i < children.size(); i++)
+    {
         // Count successes and failures
         if (childStatuses[i] == BehaviorStatus::SUCCESS)
         {
@@ -219,22 +356,14 @@ BehaviorStatus ParallelNode::tick()
     if (successPolicy > 0 && successCount >= successPolicy)
     {
         // Reset all children for next time
-        for (size_t i = 0; i < children.size(); i++)
-        {
-            children[i]->reset();
-            childStatuses[i] = BehaviorStatus::RUNNING;
-        }
+        reset(instance);
         return BehaviorStatus::SUCCESS;
     }
 
     if (failurePolicy > 0 && failureCount >= failurePolicy)
     {
         // Reset all children for next time
-        for (size_t i = 0; i < children.size(); i++)
-        {
-            children[i]->reset();
-            childStatuses[i] = BehaviorStatus::RUNNING;
-        }
+        reset(instance);
         return BehaviorStatus::FAILURE;
     }
 
@@ -242,30 +371,222 @@ BehaviorStatus ParallelNode::tick()
     return BehaviorStatus::RUNNING;
 }
 
-void ParallelNode::reset()
+void ParallelNode::tickChildren(BehaviorInstance &instance, size_t begin, size_t end) const
 {
+    BehaviorStatus *childStatuses = &instance.getState<BehaviorStatus>(*this);
+    for (size_t i = begin; i < end; i++)
+    {
+        // Only tick if the child isn't already in a terminal state
+        if (childStatuses[i] == BehaviorStatus::RUNNING)
+        {
+            childStatuses[i] = children[i]->tick(instance);
+        }
+    }
+}
+
+void ParallelNode::reset(BehaviorInstance &instance) const
+{
+    BehaviorStatus *childStatuses = &instance.getState<BehaviorStatus>(*this);
     for (size_t i = 0; i < children.size(); i++)
     {
-        children[i]->reset();
+        children[i]->reset(instance);
         childStatuses[i] = BehaviorStatus::RUNNING;
     }
 }
 
+void ParallelNode::getChildren(std::vector<const BehaviorNode *> &result) const
+{
+    for (const auto &child : children)
+    {
+        result.push_back(child.get());
+    }
+}
+
 // BehaviorTree implementation
-BehaviorStatus BehaviorTree::tick()
+bool BehaviorTree::setRootNode(std::shared_ptr<BehaviorNode> root)
+{
+    // Find every node once; a node reached twice keeps one slot as it kept one set of members before
+    std::vector<const BehaviorNode *> nodes;
+    std::vector<const BehaviorNode *> pending;
+    std::unordered_set<const BehaviorNode *> found;
+    if (root)
+    {
+        pending.push_back(root.get());
+    }
+    while (!pending.empty())
+    {
+        const BehaviorNode *node = pending.back();
+        pending.pop_back();
+        if (!found.insert(node).second)
+        {
+            continue;
+        }
+        if (node->owner && node->owner != this)
+        {
+            std::cerr << "Behavior tree node " << node->getName() << " already belongs to another tree" << std::endl;
+            return false;
+        }
+        nodes.push_back(node);
+        node->getChildren(pending);
+    }
+
+    // Give every node a slot in the per-agent state, in 4-byte steps so each slot is aligned
+    rootNode = root;
+    stateSize = 0;
+    for (const BehaviorNode *node : nodes)
+    {
+        node->owner = this;
+        node->stateOffset = stateSize;
+        stateSize += (node->getStateSize() + 3) / 4 * 4;
+    }
+    return true;
+}
+
+// BehaviorInstance implementation
+BehaviorInstance::BehaviorInstance(std::shared_ptr<const BehaviorTree> tree, void *agent)
+    : tree(tree),
+      agent(agent),
+      state(tree->getStateSize() / 4),
+      blackboard(tree->getBlackboard())
+{
+    blackboard.addListener([this](int key)
+                           { notifyChanged(key); });
+    if (tree->getRootNode())
+    {
+        tree->getRootNode()->reset(*this);
+    }
+}
+
+BehaviorStatus BehaviorInstance::tick()
 {
-    if (!rootNode)
+    const BehaviorNode *root = tree->getRootNode();
+    if (!root)
     {
         return BehaviorStatus::FAILURE;
     }
 
-    return rootNode->tick();
+    // Sense first, so the guards see this tick's keys
+    if (tree->getPerception())
+    {
+        tree->getPerception()(*this);
+    }
+
+    // Nothing running: start from the root
+    if (activePath.empty())
+    {
+        changedKeys.clear();
+        activePath.push_back(root);
+        return settle(0, root->tick(*this));
+    }
+
+    // Re-check the guards that observe a changed key, outermost first
+    if (!changedKeys.empty())
+    {
+        for (const BehaviorGuard &guard : guards)
+        {
+            if (guard.condition->observesAny(changedKeys) &&
+                (guard.condition->tick(*this) == BehaviorStatus::SUCCESS) != guard.expected)
+            {
+                // The branch would not be chosen any more, so choose again from the guard's owner
+                changedKeys.clear();
+                const BehaviorNode *owner = activePath[guard.depth];
+                size_t depth = guard.depth;
+                owner->reset(*this);
+                return settle(depth, owner->tick(*this));
+            }
+        }
+        changedKeys.clear();
+    }
+
+    // Resume at the running leaf
+    size_t leaf = activePath.size() - 1;
+    return settle(leaf, activePath[leaf]->tick(*this));
+}
+
+BehaviorStatus BehaviorInstance::settle(size_t depth, BehaviorStatus status)
+{
+    activePath.resize(depth + 1);
+
+    // A finished node hands its status to its parent, which may finish too or start another child
+    while (status != BehaviorStatus::RUNNING)
+    {
+        if (depth == 0)
+        {
+            activePath.clear();
+            guards.clear();
+            return status;
+        }
+        activePath.pop_back();
+        depth--;
+        status = activePath[depth]->resume(*this, status);
+    }
+
+    // Follow the running children down to the leaf the next tick resumes at
+    while (const BehaviorNode *child = activePath.back()->getRunningChild(*this))
+    {
+        activePath.push_back(child);
+    }
+
+    guards.clear();
+    for (size_t i = 0; i < activePath.size(); i++)
+    {
+        size_t first = guards.size();
+        activePath[i]->getGuards(*this, guards);
+        for (size_t guard = first; guard < guards.size(); guard++)
+        {
+            guards[guard].depth = i;
+        }
+    }
+    return BehaviorStatus::RUNNING;
+}
+
+void BehaviorInstance::reset()
+{
+    if (tree->getRootNode())
+    {
+        tree->getRootNode()->reset(*this);
+    }
+    activePath.clear();
+    guards.clear();
+    changedKeys.clear();
+    commands.clear();
+}
+
+void BehaviorInstance::notifyChanged(int key)
+{
+    assert(!tickingConcurrently && "children of a pooled ParallelNode must not write the blackboard");
+    if (std::find(changedKeys.begin(), changedKeys.end(), key) == changedKeys.end())
+    {
+        changedKeys.push_back(key);
+    }
+}
+
+std::minstd_rand &BehaviorInstance::getRandom()
+{
+    assert(!tickingConcurrently && "children of a pooled ParallelNode must not draw random numbers");
+    return random;
+}
+
+void BehaviorInstance::issue(std::function<void()> command)
+{
+    assert(!tickingConcurrently && "children of a pooled ParallelNode must not issue commands");
+    if (deferCommands)
+    {
+        commands.push_back(std::move(command));
+    }
+    else
+    {
+        command();
+    }
 }
 
-void BehaviorTree::reset()
+void BehaviorInstance::runCommands()
 {
-    if (rootNode)
+    // Commands may issue more commands; those run in this pass too
+    for (size_t i = 0; i < commands.size(); i++)
     {
-        rootNode->reset();
+        std::function<void()> command = std::move(commands[i]);
+        command();
     }
-}
\ No newline at end of file
+    commands.clear();
+}
@@ -0,0 +1,794 @@
+/**
+ * @file CompiledDecisionTree.cpp
+ * @brief Implementation of the CompiledDecisionTree class.
+ *
+ * Resources Used:
+ * - Book: "Artificial Intelligence for Games" by Ian Millington
+ *
+ * Author: Miles Hollifield
+ * Date: 4/7/2025
+ */
+
+#include "headers/CompiledDecisionTree.h"
+#include "headers/WorkerPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    // A new order has to save this fraction of a run's expected cost, and at least this many seconds
+    // per decision (about one clock read, below which timings are noise), before reordered uses it
+    const double MIN_REORDER_GAIN = 0.2;
+    const double MIN_REORDER_SAVING = 50e-9;
+
+    /**
+     * @brief Measure the average time of an empty steady_clock interval.
+     *
+     * Cheap conditions take about as long as reading the clock twice, so without this the profile
+     * would mostly measure the timer.
+     */
+    double measureTimerOverhead()
+    {
+        const int samples = 10000;
+        double total = 0;
+        for (int i = 0; i < samples; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return total / samples;
+    }
+
+    /**
+     * @brief Name a feature test, as in "feature 4 == 1"
+     */
+    std::string describeTest(const FeatureTest &test)
+    {
+        static const char *const symbols[] = {"<", "<=", ">", ">=", "=="};
+        std::ostringstream name;
+        name << "feature " << test.feature << " " << symbols[static_cast<int>(test.comparison)] << " " << test.threshold;
+        return name.str();
+    }
+
+    /**
+     * @brief Agents waiting at a node: a range of the agent index buffer
+     */
+    struct AgentGroup
+    {
+        int node;
+        int first;
+        int count;
+    };
+
+    /**
+     * @brief Test a feature for a group of agents; one loop per comparison keeps the loop body branch-free
+     * @param column Feature column
+     * @param agents Agent indices of the group
+     * @param count Number of agents
+     * @param test Comparison and threshold
+     * @param pass Receives 1 for agents that pass, 0 otherwise
+     */
+    void testGroup(const float *column, const int *agents, int count, const FeatureTest &test, uint8_t *pass)
+    {
+        const float threshold = test.threshold;
+        switch (test.comparison)
+        {
+        case FeatureTest::Comparison::LESS:
+            for (int i = 0; i < count; i++)
+                pass[i] = column[agents[i]] < threshold;
+            break;
+        case FeatureTest::Comparison::LESS_EQUAL:
+            for (int i = 0; i < count; i++)
+                pass[i] = column[agents[i]] <= threshold;
+            break;
+        case FeatureTest::Comparison::GREATER:
+            for (int i = 0; i < count; i++)
+                pass[i] = column[agents[i]] > threshold;
+            break;
+        case FeatureTest::Comparison::GREATER_EQUAL:
+            for (int i = 0; i < count; i++)
+                pass[i] = column[agents[i]] >= threshold;
+            break;
+        case FeatureTest::Comparison::EQUAL:
+            for (int i = 0; i < count; i++)
+                pass[i] = column[agents[i]] == threshold;
+            break;
+        }
+    }
+
+    /**
+     * @brief Move the agents that passed to the front of the group, keeping their order
+     * @param agents Agent indices of the group
+     * @param count Number of agents
+     * @param pass Result of testGroup
+     * @param scratch Buffer with room for count indices
+     * @return Number of agents that passed
+     */
+    int partitionGroup(int *agents, int count, const uint8_t *pass, int *scratch)
+    {
+        int passed = 0;
+        int failed = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (pass[i])
+            {
+                agents[passed++] = agents[i];
+            }
+            else
+            {
+                scratch[failed++] = agents[i];
+            }
+        }
+        std::copy(scratch, scratch + failed, agents + passed);
+        return passed;
+    }
+
+    /**
+     * @brief Random value in [0, 1) that depends only on its inputs (no shared generator between threads)
+     */
+    float hashedDraw(unsigned seed, int agent, int node)
+    {
+        uint32_t x = seed ^ (static_cast<uint32_t>(agent) * 0x9E3779B9u) ^ (static_cast<uint32_t>(node) * 0x85EBCA6Bu);
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        return (x >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @brief Values a FeatureTest accepts, as an interval with open or closed ends
+     */
+    struct AcceptedRange
+    {
+        float low = -std::numeric_limits<float>::infinity();
+        float high = std::numeric_limits<float>::infinity();
+        bool lowOpen = true;
+        bool highOpen = true;
+    };
+
+    AcceptedRange acceptedRange(const FeatureTest &test)
+    {
+        AcceptedRange range;
+        switch (test.comparison)
+        {
+        case FeatureTest::Comparison::LESS:
+            range.high = test.threshold;
+            break;
+        case FeatureTest::Comparison::LESS_EQUAL:
+            range.high = test.threshold;
+            range.highOpen = false;
+            break;
+        case FeatureTest::Comparison::GREATER:
+            range.low = test.threshold;
+            break;
+        case FeatureTest::Comparison::GREATER_EQUAL:
+            range.low = test.threshold;
+            range.lowOpen = false;
+            break;
+        case FeatureTest::Comparison::EQUAL:
+            range.low = range.high = test.threshold;
+            range.lowOpen = range.highOpen = false;
+            break;
+        }
+        return range;
+    }
+
+    /**
+     * @brief Check whether the first range ends before the second one starts
+     */
+    bool endsBefore(const AcceptedRange &first, const AcceptedRange &second)
+    {
+        return first.high < second.low || (first.high == second.low && (first.highOpen || second.lowOpen));
+    }
+}
+
+void CompiledDecisionTree::clear()
+{
+    nodes.clear();
+    links.clear();
+    conditions.clear();
+    batchTests.clear();
+    profiles.clear();
+    cachedTicks.clear();
+    cachedResults.clear();
+    actionNodes.clear();
+    compiledNodes.clear();
+}
+
+ActionId CompiledDecisionTree::evaluate() const
+{
+    return walk(0, false);
+}
+
+ActionId CompiledDecisionTree::evaluate(unsigned long tick) const
+{
+    return walk(tick, true);
+}
+
+bool CompiledDecisionTree::testCondition(int condition, unsigned long tick, bool useCache) const
+{
+    if (useCache && cachedTicks[condition] == tick)
+    {
+        if (profiling)
+        {
+            profiles[condition].cacheHits++;
+            profiles[condition].trueCount += cachedResults[condition];
+        }
+        return cachedResults[condition];
+    }
+
+    bool result;
+    if (profiling)
+    {
+        auto start = std::chrono::steady_clock::now();
+        result = conditions[condition]();
+        ConditionProfile &profile = profiles[condition];
+        profile.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - timerOverhead;
+        profile.evaluations++;
+        profile.trueCount += result ? 1 : 0;
+    }
+    else
+    {
+        result = conditions[condition]();
+    }
+
+    if (useCache)
+    {
+        cachedTicks[condition] = tick;
+        cachedResults[condition] = result;
+    }
+    return result;
+}
+
+void CompiledDecisionTree::setProfiling(bool enabled)
+{
+    profiling = enabled;
+    if (enabled)
+    {
+        timerOverhead = measureTimerOverhead();
+        for (ConditionProfile &profile : profiles)
+        {
+            std::string name = profile.name;
+            profile = ConditionProfile();
+            profile.name = name;
+        }
+    }
+}
+
+void CompiledDecisionTree::printProfile(std::ostream &out) const
+{
+    for (size_t i = 0; i < profiles.size(); i++)
+    {
+        const ConditionProfile &profile = profiles[i];
+        out << "  [" << i << "] " << profile.name << ": " << profile.evaluations << " calls, "
+            << profile.cacheHits << " cached, " << std::fixed << std::setprecision(1) << profile.trueRate() * 100.0
+            << "% true, " << std::setprecision(3) << profile.averageCost() * 1e6 << " us each" << std::endl;
+        out.unsetf(std::ios::fixed);
+    }
+}
+
+bool CompiledDecisionTree::saveProfile(const std::string &filename) const
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        std::cerr << "Could not write condition profile " << filename << std::endl;
+        return false;
+    }
+
+    // Counts first, so the name can be the rest of the line
+    file << profiles.size() << std::endl;
+    file << std::setprecision(17);
+    for (const ConditionProfile &profile : profiles)
+    {
+        file << profile.evaluations << " " << profile.cacheHits << " " << profile.trueCount << " "
+             << profile.seconds << " " << profile.name << std::endl;
+    }
+    return static_cast<bool>(file);
+}
+
+bool CompiledDecisionTree::loadProfile(const std::string &filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        return false; // No saved profile
+    }
+
+    size_t count = 0;
+    if (!(file >> count) || count != profiles.size())
+    {
+        std::cerr << "Condition profile " << filename << " does not match this tree" << std::endl;
+        return false;
+    }
+
+    std::vector<ConditionProfile> loaded(count);
+    for (ConditionProfile &profile : loaded)
+    {
+        file >> profile.evaluations >> profile.cacheHits >> profile.trueCount >> profile.seconds;
+        file.ignore(1); // Space before the name
+        std::getline(file, profile.name);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!file || loaded[i].name != profiles[i].name)
+        {
+            std::cerr << "Condition profile " << filename << " does not match this tree" << std::endl;
+            return false;
+        }
+    }
+
+    profiles = loaded;
+    return true;
+}
+
+ActionId CompiledDecisionTree::walk(unsigned long tick, bool useCache) const
+{
+    if (nodes.empty())
+    {
+        return ActionRegistry::NONE;
+    }
+
+    int index = 0;
+    while (true)
+    {
+        const CompiledDecisionNode &node = nodes[index];
+        switch (node.type)
+        {
+        case CompiledDecisionNode::Type::ACTION:
+            return node.action;
+
+        case CompiledDecisionNode::Type::BRANCH:
+            index = testCondition(node.condition, tick, useCache) ? node.trueChild : node.falseChild;
+            break;
+
+        case CompiledDecisionNode::Type::RANDOM:
+        {
+            // Same draw as RandomDecisionNode, so compiled and linked trees choose alike
+            float randomValue = static_cast<float>(rand()) / RAND_MAX * node.totalWeight;
+            index = links[node.firstLink + node.linkCount - 1].child; // Fallback to the last child
+            for (int i = node.firstLink; i < node.firstLink + node.linkCount; i++)
+            {
+                if (randomValue <= links[i].weight)
+                {
+                    index = links[i].child;
+                    break;
+                }
+            }
+            break;
+        }
+
+        case CompiledDecisionNode::Type::PRIORITY:
+            index = node.falseChild;
+            for (int i = node.firstLink; i < node.firstLink + node.linkCount; i++)
+            {
+                if (testCondition(links[i].condition, tick, useCache))
+                {
+                    index = links[i].child;
+                    break;
+                }
+            }
+            break;
+        }
+    }
+}
+
+CompiledDecisionTree CompiledDecisionTree::reordered(std::ostream *log) const
+{
+    CompiledDecisionTree result = *this;
+
+    // Count the parents of each node, so a chain is only rewritten where nothing else points into it
+    std::vector<int> parents(nodes.size(), 0);
+    for (const CompiledDecisionNode &node : nodes)
+    {
+        if (node.type == CompiledDecisionNode::Type::BRANCH)
+        {
+            parents[node.trueChild]++;
+            parents[node.falseChild]++;
+        }
+        else if (node.type != CompiledDecisionNode::Type::ACTION)
+        {
+            for (int i = node.firstLink; i < node.firstLink + node.linkCount; i++)
+            {
+                parents[links[i].child]++;
+            }
+            if (node.type == CompiledDecisionNode::Type::PRIORITY)
+            {
+                parents[node.falseChild]++;
+            }
+        }
+    }
+
+    // A branch continues a chain if it is the false child of another branch and has no other parent
+    std::vector<bool> continuesChain(nodes.size(), false);
+    for (const CompiledDecisionNode &node : nodes)
+    {
+        if (node.type == CompiledDecisionNode::Type::BRANCH &&
+            nodes[node.falseChild].type == CompiledDecisionNode::Type::BRANCH && parents[node.falseChild] == 1)
+        {
+            continuesChain[node.falseChild] = true;
+        }
+    }
+
+    for (size_t index = 0; index < nodes.size(); index++)
+    {
+        const CompiledDecisionNode &node = nodes[index];
+        if (node.type == CompiledDecisionNode::Type::PRIORITY)
+        {
+            std::vector<CompiledDecisionLink> guarded(links.begin() + node.firstLink,
+                                                      links.begin() + node.firstLink + node.linkCount);
+            if (reorderGuarded(guarded, log))
+            {
+                std::copy(guarded.begin(), guarded.end(), result.links.begin() + node.firstLink);
+            }
+        }
+        else if (node.type == CompiledDecisionNode::Type::BRANCH && !continuesChain[index])
+        {
+            // Collect the chain from its head; each branch keeps its place and takes a new condition and true child
+            std::vector<int> chain = {static_cast<int>(index)};
+            while (continuesChain[nodes[chain.back()].falseChild])
+            {
+                chain.push_back(nodes[chain.back()].falseChild);
+            }
+            if (chain.size() < 2)
+            {
+                continue;
+            }
+
+            std::vector<CompiledDecisionLink> guarded;
+            for (int branch : chain)
+            {
+                guarded.push_back({nodes[branch].trueChild, nodes[branch].condition, 0});
+            }
+            if (reorderGuarded(guarded, log))
+            {
+                for (size_t i = 0; i < chain.size(); i++)
+                {
+                    result.nodes[chain[i]].condition = guarded[i].condition;
+                    result.nodes[chain[i]].trueChild = guarded[i].child;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool CompiledDecisionTree::exclusive(int first, int second) const
+{
+    const FeatureTest &firstTest = batchTests[first];
+    const FeatureTest &secondTest = batchTests[second];
+    if (!firstTest.isSet() || !secondTest.isSet() || firstTest.feature != secondTest.feature)
+    {
+        return false;
+    }
+
+    AcceptedRange firstRange = acceptedRange(firstTest);
+    AcceptedRange secondRange = acceptedRange(secondTest);
+    return endsBefore(firstRange, secondRange) || endsBefore(secondRange, firstRange);
+}
+
+bool CompiledDecisionTree::reorderGuarded(std::vector<CompiledDecisionLink> &guarded, std::ostream *log) const
+{
+    bool changed = false;
+    size_t start = 0;
+    while (start < guarded.size())
+    {
+        // Grow the run while the next condition excludes every condition already in it
+        size_t end = start + 1;
+        while (end < guarded.size() &&
+               std::all_of(guarded.begin() + start, guarded.begin() + end, [&](const CompiledDecisionLink &link)
+                           { return exclusive(link.condition, guarded[end].condition); }))
+        {
+            end++;
+        }
+
+        // Every decision that reaches the run calls (or reuses) its first condition
+        long long reached = profiles[guarded[start].condition].reached();
+        if (end - start < 2 || reached == 0)
+        {
+            start = end;
+            continue;
+        }
+
+        // Chance a decision entering the run stops at a guard; the conditions are exclusive, so these add up
+        auto hitRate = [&](const CompiledDecisionLink &link)
+        {
+            return static_cast<double>(profiles[link.condition].trueCount) / reached;
+        };
+        auto costPerHit = [&](const CompiledDecisionLink &link)
+        {
+            double rate = hitRate(link);
+            return rate > 0 ? profiles[link.condition].averageCost() / rate : std::numeric_limits<double>::infinity();
+        };
+        auto expectedCost = [&]()
+        {
+            double cost = 0;
+            double stillGoing = 1;
+            for (size_t i = start; i < end; i++)
+            {
+                cost += stillGoing * profiles[guarded[i].condition].averageCost();
+                stillGoing = std::max(0.0, stillGoing - hitRate(guarded[i]));
+            }
+            return cost;
+        };
+
+        std::vector<CompiledDecisionLink> before(guarded.begin() + start, guarded.begin() + end);
+        double costBefore = expectedCost();
+        std::stable_sort(guarded.begin() + start, guarded.begin() + end,
+                         [&](const CompiledDecisionLink &a, const CompiledDecisionLink &b)
+                         { return costPerHit(a) < costPerHit(b); });
+
+        // Keep the written order unless the new one is clearly cheaper; small differences in measured
+        // cost and true rate are noise, and acting on them shuffles equally cheap conditions every run
+        double costAfter = expectedCost();
+        if (costBefore - costAfter < std::max(costBefore * MIN_REORDER_GAIN, MIN_REORDER_SAVING))
+        {
+            std::copy(before.begin(), before.end(), guarded.begin() + start);
+        }
+
+        bool moved = false;
+        for (size_t i = start; i < end; i++)
+        {
+            moved = moved || guarded[i].condition != before[i - start].condition;
+        }
+        if (moved && log)
+        {
+            *log << "  Reordered";
+            for (size_t i = start; i < end; i++)
+            {
+                *log << (i == start ? " " : ", ") << profiles[guarded[i].condition].name;
+            }
+            *log << ": " << std::fixed << std::setprecision(3) << costBefore * 1e6 << " -> " << costAfter * 1e6
+                 << " us expected" << std::endl;
+            log->unsetf(std::ios::fixed);
+        }
+        changed = changed || moved;
+        start = end;
+    }
+    return changed;
+}
+
+bool CompiledDecisionTree::canEvaluateBatch() const
+{
+    for (const FeatureTest &test : batchTests)
+    {
+        if (!test.isSet())
+        {
+            return false;
+        }
+    }
+    return !nodes.empty();
+}
+
+void CompiledDecisionTree::evaluateBatch(const DecisionFeatures &features, ActionId *actions, unsigned seed,
+                                         WorkerPool *workers) const
+{
+    int agentCount = features.getAgentCount();
+    if (!workers)
+    {
+        evaluateRange(features, 0, agentCount, actions, seed);
+        return;
+    }
+
+    // Each thread takes a contiguous range of agents; draws do not depend on the split
+    workers->parallelFor(agentCount, [&](size_t begin, size_t end)
+                         { evaluateRange(features, static_cast<int>(begin), static_cast<int>(end), actions, seed); });
+}
+
+void CompiledDecisionTree::evaluateRange(const DecisionFeatures &features, int begin, int end, ActionId *actions,
+                                         unsigned seed) const
+{
+    int count = end - begin;
+    if (count <= 0)
+    {
+        return;
+    }
+    if (nodes.empty())
+    {
+        std::fill(actions + begin, actions + end, ActionRegistry::NONE);
+        return;
+    }
+
+    // Groups are disjoint ranges of one agent buffer, so splitting a group never moves another
+    std::vector<int> agents(count);
+    std::vector<int> scratch(count);
+    std::vector<uint8_t> pass(count);
+    for (int i = 0; i < count; i++)
+    {
+        agents[i] = begin + i;
+    }
+
+    std::vector<AgentGroup> groups = {{0, 0, count}};
+    while (!groups.empty())
+    {
+        AgentGroup group = groups.back();
+        groups.pop_back();
+        int *groupAgents = agents.data() + group.first;
+        const CompiledDecisionNode &node = nodes[group.node];
+
+        switch (node.type)
+        {
+        case CompiledDecisionNode::Type::ACTION:
+            for (int i = 0; i < group.count; i++)
+            {
+                actions[groupAgents[i]] = node.action;
+            }
+            break;
+
+        case CompiledDecisionNode::Type::BRANCH:
+        {
+            const FeatureTest &test = batchTests[node.condition];
+            testGroup(features.column(test.feature), groupAgents, group.count, test, pass.data());
+            int passed = partitionGroup(groupAgents, group.count, pass.data(), scratch.data());
+            if (passed > 0)
+            {
+                groups.push_back({node.trueChild, group.first, passed});
+            }
+            if (passed < group.count)
+            {
+                groups.push_back({node.falseChild, group.first + passed, group.count - passed});
+            }
+            break;
+        }
+
+        case CompiledDecisionNode::Type::RANDOM:
+        {
+            // Peel off the agents whose draw falls under each cumulative weight in turn; the last child takes the rest
+            int first = group.first;
+            int remaining = group.count;
+            int lastLink = node.firstLink + node.linkCount - 1;
+            for (int link = node.firstLink; link < lastLink && remaining > 0; link++)
+            {
+                int *remainingAgents = agents.data() + first;
+                for (int i = 0; i < remaining; i++)
+                {
+                    pass[i] = hashedDraw(seed, remainingAgents[i], group.node) * node.totalWeight <= links[link].weight;
+                }
+                int passed = partitionGroup(remainingAgents, remaining, pass.data(), scratch.data());
+                if (passed > 0)
+                {
+                    groups.push_back({links[link].child, first, passed});
+                }
+                first += passed;
+                remaining -= passed;
+            }
+            if (remaining > 0)
+            {
+                groups.push_back({links[lastLink].child, first, remaining});
+            }
+            break;
+        }
+
+        case CompiledDecisionNode::Type::PRIORITY:
+        {
+            int first = group.first;
+            int remaining = group.count;
+            for (int link = node.firstLink; link < node.firstLink + node.linkCount && remaining > 0; link++)
+            {
+                const FeatureTest &test = batchTests[links[link].condition];
+                int *remainingAgents = agents.data() + first;
+                testGroup(features.column(test.feature), remainingAgents, remaining, test, pass.data());
+                int passed = partitionGroup(remainingAgents, remaining, pass.data(), scratch.data());
+                if (passed > 0)
+                {
+                    groups.push_back({links[link].child, first, passed});
+                }
+                first += passed;
+                remaining -= passed;
+            }
+            if (remaining > 0)
+            {
+                groups.push_back({node.falseChild, first, remaining});
+            }
+            break;
+        }
+        }
+    }
+}
+
+int CompiledDecisionTree::findNode(const DecisionNode *source) const
+{
+    auto it = compiledNodes.find(source);
+    return it == compiledNodes.end() ? -1 : it->second;
+}
+
+int CompiledDecisionTree::addCondition(const std::function<bool()> &condition, const std::string &name,
+                                       const FeatureTest &batchTest)
+{
+    // The same feature test is the same predicate, so it shares the id (and the cached result)
+    if (batchTest.isSet())
+    {
+        for (size_t i = 0; i < batchTests.size(); i++)
+        {
+            const FeatureTest &test = batchTests[i];
+            if (test.feature == batchTest.feature && test.comparison == batchTest.comparison &&
+                test.threshold == batchTest.threshold)
+            {
+                // Branches sharing the id may be named after where they are, so name it after the test
+                if (profiles[i].name != name)
+                {
+                    profiles[i].name = describeTest(batchTest);
+                }
+                return static_cast<int>(i);
+            }
+        }
+    }
+
+    conditions.push_back(condition);
+    batchTests.push_back(batchTest);
+    ConditionProfile profile;
+    profile.name = name;
+    profiles.push_back(profile);
+    cachedTicks.push_back(std::numeric_limits<unsigned long>::max()); // Nothing cached yet
+    cachedResults.push_back(0);
+    return static_cast<int>(conditions.size()) - 1;
+}
+
+int CompiledDecisionTree::addAction(ActionId action)
+{
+    auto it = actionNodes.find(action);
+    if (it != actionNodes.end())
+    {
+        return it->second;
+    }
+
+    CompiledDecisionNode node;
+    node.type = CompiledDecisionNode::Type::ACTION;
+    node.action = action;
+    nodes.push_back(node);
+
+    int index = static_cast<int>(nodes.size()) - 1;
+    actionNodes[action] = index;
+    return index;
+}
+
+int CompiledDecisionTree::addBranch(int conditionId)
+{
+    CompiledDecisionNode node;
+    node.type = CompiledDecisionNode::Type::BRANCH;
+    node.condition = conditionId;
+    nodes.push_back(node);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+void CompiledDecisionTree::setBranchChildren(int node, int trueChild, int falseChild)
+{
+    nodes[node].trueChild = trueChild;
+    nodes[node].falseChild = falseChild;
+}
+
+int CompiledDecisionTree::addRandom(int childCount, float totalWeight)
+{
+    CompiledDecisionNode node;
+    node.type = CompiledDecisionNode::Type::RANDOM;
+    node.firstLink = static_cast<int>(links.size());
+    node.linkCount = childCount;
+    node.totalWeight = totalWeight;
+    nodes.push_back(node);
+    links.resize(links.size() + childCount);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+int CompiledDecisionTree::addPriority(int childCount)
+{
+    CompiledDecisionNode node;
+    node.type = CompiledDecisionNode::Type::PRIORITY;
+    node.firstLink = static_cast<int>(links.size());
+    node.linkCount = childCount;
+    nodes.push_back(node);
+    links.resize(links.size() + childCount);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+void CompiledDecisionTree::setLink(int node, int slot, const CompiledDecisionLink &link)
+{
+    links[nodes[node].firstLink + slot] = link;
+}
@@ -17,6 +17,51 @@
 #include <sstream>
 #include <iomanip>
 
+// DecisionNode compilation
+int DecisionBranch::compileNode(CompiledDecisionTree &compiled) const
+{
+    // Parent first, then its children, so decisions walk forward through the array
+    int index = compiled.addBranch(compiled.addCondition(condition, conditionName, batchTest));
+    int trueIndex = trueNode->compile(compiled);
+    int falseIndex = falseNode->compile(compiled);
+    compiled.setBranchChildren(index, trueIndex, falseIndex);
+    return index;
+}
+
+int RandomDecisionNode::compileNode(CompiledDecisionTree &compiled) const
+{
+    if (children.empty())
+    {
+        return compiled.addAction(ActionRegistry::IDLE); // Same default as makeDecision
+    }
+
+    int index = compiled.addRandom(static_cast<int>(children.size()), totalWeight);
+    float cumulativeWeight = 0.0f;
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        cumulativeWeight += weights[i];
+        CompiledDecisionLink link;
+        link.child = children[i]->compile(compiled);
+        link.weight = cumulativeWeight;
+        compiled.setLink(index, static_cast<int>(i), link);
+    }
+    return index;
+}
+
+int PriorityNode::compileNode(CompiledDecisionTree &compiled) const
+{
+    int index = compiled.addPriority(static_cast<int>(children.size()));
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        CompiledDecisionLink link;
+        link.condition = compiled.addCondition(conditions[i], conditionNames[i], batchTests[i]);
+        link.child = children[i]->compile(compiled);
+        compiled.setLink(index, static_cast<int>(i), link);
+    }
+    compiled.setFallback(index, compiled.addAction(ActionRegistry::IDLE)); // Same default as makeDecision
+    return index;
+}
+
 // EnvironmentState implementation
 EnvironmentState::EnvironmentState(const Kinematic &character, const Environment &env)
     : character(character),
@@ -26,18 +71,30 @@ EnvironmentState::EnvironmentState(const Kinematic &character, const Environment
       speed(0.0f),
       distanceToNearestObstacle(1000.0f),
       currentRoom(0),
+      stateTime(0.0f),
       reachedWaypoint(false),
       completedPath(false),
       pathBlocked(false),
-      isIdle(true)
+      idleTime(0.0f),
+      isIdle(true),
+      staleFeatures(STALE_ALL),
+      updateCount(0),
+      rollGenerator(rand())
 {
-    stateTimer.restart();
-    idleTimer.restart();
-    update();
+    update(0.0f);
 }
 
-void EnvironmentState::update()
+void EnvironmentState::update(float deltaTime)
 {
+    updateCount++;
+    stateTime += deltaTime;
+
+    // Position-dependent features are recomputed on their next use, and only if we moved
+    if (character.position != position)
+    {
+        staleFeatures = STALE_ALL;
+    }
+
     // Update values based on current conditions
     position = character.position;
     velocity = character.velocity;
@@ -49,7 +106,11 @@ void EnvironmentState::update()
         if (!isIdle)
         {
             isIdle = true;
-            idleTimer.restart();
+            idleTime = 0.0f;
+        }
+        else
+        {
+            idleTime += deltaTime;
         }
     }
     else
@@ -57,30 +118,56 @@ void EnvironmentState::update()
         isIdle = false;
     }
 
-    // Calculate other state values
-    findNearestObstacle();
-    currentRoom = determineCurrentRoom();
+}
+
+float EnvironmentState::getObstacleDistance() const
+{
+    if (staleFeatures & STALE_OBSTACLE)
+    {
+        findNearestObstacle();
+        staleFeatures &= ~STALE_OBSTACLE;
+    }
+    return distanceToNearestObstacle;
+}
+
+int EnvironmentState::getCurrentRoom() const
+{
+    if (staleFeatures & STALE_ROOM)
+    {
+        currentRoom = determineCurrentRoom();
+        staleFeatures &= ~STALE_ROOM;
+    }
+    return currentRoom;
+}
 
-    // Determine path status
-    if (currentTarget != sf::Vector2f(0, 0))
+bool EnvironmentState::getReachedWaypoint() const
+{
+    if (staleFeatures & STALE_PATH)
     {
-        float distanceToTarget = getDistanceToTarget(currentTarget);
-        reachedWaypoint = distanceToTarget < 20.0f;
-        completedPath = reachedWaypoint;
+        // Determine path status
+        if (currentTarget != sf::Vector2f(0, 0))
+        {
+            float distanceToTarget = getDistanceToTarget(currentTarget);
+            reachedWaypoint = distanceToTarget < 20.0f;
+            completedPath = reachedWaypoint;
+        }
+        staleFeatures &= ~STALE_PATH;
     }
+    return reachedWaypoint;
 }
 
 void EnvironmentState::setTarget(const sf::Vector2f &target)
 {
     currentTarget = target;
+    staleFeatures |= STALE_PATH;
 }
 
 void EnvironmentState::resetStateTimer()
 {
-    stateTimer.restart();
+    stateTime = 0.0f;
 }
 
-void EnvironmentState::findNearestObstacle()
+void EnvironmentState::findNearestObstacle() const
 {
     // Reset distance to a large value
     const float MAX_CHECK_DISTANCE = 200.0f;
@@ -111,7 +198,7 @@ void EnvironmentState::findNearestObstacle()
     }
 }
 
-int EnvironmentState::determineCurrentRoom()
+int EnvironmentState::determineCurrentRoom() const
 {
     // Determine which room we're in based on position
     int roomId = 0;
@@ -141,9 +228,19 @@ int EnvironmentState::determineCurrentRoom()
     return roomId;
 }
 
+void EnvironmentState::writeFeatures(DecisionFeatures &features, int agent) const
+{
+    features.set(FEATURE_SPEED, agent, speed);
+    features.set(FEATURE_OBSTACLE_DISTANCE, agent, getObstacleDistance());
+    features.set(FEATURE_ROOM, agent, static_cast<float>(getCurrentRoom()));
+    features.set(FEATURE_IDLE_TIME, agent, isIdle ? idleTime : 0.0f);
+    features.set(FEATURE_CHANGE_TARGET, agent, shouldChangeTarget() ? 1.0f : 0.0f);
+    features.set(FEATURE_RANDOM_ROLL, agent, static_cast<float>(rollGenerator() % 100));
+}
+
 bool EnvironmentState::isNearObstacle(float threshold) const
 {
-    return distanceToNearestObstacle < threshold;
+    return getObstacleDistance() < threshold;
 }
 
 bool EnvironmentState::isMovingFast(float threshold) const
@@ -153,7 +250,7 @@ bool EnvironmentState::isMovingFast(float threshold) const
 
 bool EnvironmentState::isInRoom(int roomId) const
 {
-    return currentRoom == roomId;
+    return getCurrentRoom() == roomId;
 }
 
 float EnvironmentState::getDistanceToTarget(const sf::Vector2f &target) const
@@ -165,16 +262,17 @@ float EnvironmentState::getDistanceToTarget(const sf::Vector2f &target) const
 
 bool EnvironmentState::hasBeenInCurrentState(float seconds) const
 {
-    return stateTimer.getElapsedTime().asSeconds() >= seconds;
+    return stateTime >= seconds;
 }
 
 bool EnvironmentState::hasReachedWaypoint() const
 {
-    return reachedWaypoint;
+    return getReachedWaypoint();
 }
 
 bool EnvironmentState::hasCompletedPath() const
 {
+    getReachedWaypoint(); // Computed together
     return completedPath;
 }
 
@@ -191,7 +289,7 @@ bool EnvironmentState::canSeeTarget(const sf::Vector2f &target) const
 bool EnvironmentState::isNearWall() const
 {
     // Check if close to a wall/boundary
-    return distanceToNearestObstacle < 30.0f;
+    return getObstacleDistance() < 30.0f;
 }
 
 bool EnvironmentState::isInCenterOfRoom() const
@@ -204,7 +302,7 @@ bool EnvironmentState::isInCenterOfRoom() const
         {480, 360}  // Bottom-right room
     };
 
-    sf::Vector2f roomCenter = roomCenters[currentRoom];
+    sf::Vector2f roomCenter = roomCenters[getCurrentRoom()];
     float distanceToCenter = getDistanceToTarget(roomCenter);
 
     return distanceToCenter < 50.0f;
@@ -248,7 +346,7 @@ bool EnvironmentState::isMovingTowards(const sf::Vector2f &target) const
 
 bool EnvironmentState::isIdleForTooLong(float threshold) const
 {
-    return isIdle && idleTimer.getElapsedTime().asSeconds() >= threshold;
+    return isIdle && idleTime >= threshold;
 }
 
 bool EnvironmentState::shouldChangeTarget() const
@@ -265,19 +363,47 @@ DecisionTree::DecisionTree(EnvironmentState &state)
 void DecisionTree::setRootNode(std::shared_ptr<DecisionNode> root)
 {
     rootNode = root;
+    compiledTree.clear(); // The old compiled tree no longer matches
 }
 
-std::string DecisionTree::makeDecision()
+void DecisionTree::compile()
+{
+    compiledTree.clear();
+    if (rootNode)
+    {
+        rootNode->compile(compiledTree);
+    }
+}
+
+ActionId DecisionTree::makeDecision()
 {
     if (!rootNode)
     {
         std::cerr << "Decision tree has no root node!" << std::endl;
-        return "Idle"; // Default action if no tree is defined
+        return ActionRegistry::IDLE; // Default action if no tree is defined
+    }
+
+    if (!compiledTree.empty())
+    {
+        // Conditions reached again before the next state update reuse their results
+        return compiledTree.evaluate(environmentState.getUpdateCount());
     }
 
     return rootNode->makeDecision();
 }
 
+bool DecisionTree::makeDecisions(const DecisionFeatures &features, ActionId *actions, unsigned seed, WorkerPool *workers) const
+{
+    if (!compiledTree.canEvaluateBatch())
+    {
+        std::cerr << "Decision tree is not compiled or has conditions without feature tests!" << std::endl;
+        return false;
+    }
+
+    compiledTree.evaluateBatch(features, actions, seed, workers);
+    return true;
+}
+
 std::shared_ptr<DecisionNode> DecisionTree::createTargetSubtree(const sf::Vector2f &target)
 {
     // Create a subtree for pursuing a specific target
@@ -325,7 +451,8 @@ std::shared_ptr<DecisionNode> DecisionTree::createTargetSubtree(const sf::Vector
         shouldSeekNewTarget,
         wanderAction,       // If should change target, wander
         visibilityDecision, // Otherwise continue with current target
-        "Should change target?");
+        "Should change target?",
+        FeatureTest(EnvironmentState::FEATURE_CHANGE_TARGET, FeatureTest::Comparison::EQUAL, 1.0f)); // Shared by every target's subtree
 
     return targetPersistenceDecision;
 }
@@ -397,14 +524,16 @@ void DecisionTree::buildComplexTree(const std::vector<sf::Vector2f> &targets)
         shouldDance,
         danceAction,
         targetSelectionNode,
-        "Should perform special behavior?");
+        "Should perform special behavior?",
+        FeatureTest(EnvironmentState::FEATURE_RANDOM_ROLL, FeatureTest::Comparison::LESS, 5.0f));
 
     // Movement safety decision: Flee from obstacles when moving fast
     auto safetyNode = std::make_shared<DecisionBranch>(
         isNearObstacle,
         fleeAction,          // If near obstacle, flee
         specialBehaviorNode, // Otherwise continue with normal behaviors
-        "Is near obstacle?");
+        "Is near obstacle?",
+        FeatureTest(EnvironmentState::FEATURE_OBSTACLE_DISTANCE, FeatureTest::Comparison::LESS, 40.0f));
 
     // Main activity decision: Safety vs. Idle
     auto activityNode = std::make_shared<DecisionBranch>(
@@ -414,11 +543,14 @@ void DecisionTree::buildComplexTree(const std::vector<sf::Vector2f> &targets)
             isIdleTooLong,
             wanderAction,        // If idle too long, wander
             targetSelectionNode, // Otherwise continue with normal behaviors
-            "Idle too long?"),
-        "Is moving fast?");
+            "Idle too long?",
+            FeatureTest(EnvironmentState::FEATURE_IDLE_TIME, FeatureTest::Comparison::GREATER_EQUAL, 3.0f)),
+        "Is moving fast?",
+        FeatureTest(EnvironmentState::FEATURE_SPEED, FeatureTest::Comparison::GREATER, 150.0f));
 
     // Set the root node
     setRootNode(activityNode);
+    compile();
 
     // Debug output
     // std::cout << "Decision Tree Structure:\n" << printTree() << std::endl;
@@ -14,6 +14,8 @@
 #include "headers/BehaviorTree.h"
 #include "headers/DecisionTree.h"
 #include "headers/Dijkstra.h"
+#include "headers/PathSmoothing.h"
+#include "headers/FixedTimestep.h"
 #include <cmath>
 #include <iostream>
 #include <fstream>
@@ -21,17 +23,22 @@
 // Constructor for Monster
 Monster::Monster(sf::Vector2f startPosition, sf::Texture &texture, Environment &environment, Graph &graph, sf::Color color)
     : monsterKinematic(startPosition),
+      previousPosition(startPosition),
+      previousOrientation(0),
       startPosition(startPosition),
       environment(environment),
       navigationGraph(graph),
       playerKinematic(nullptr),
       currentWaypointIndex(0),
       controlType(ControlType::BEHAVIOR_TREE),
+      decidedAction(ActionRegistry::NONE),
       currentDeltaTime(0.0f),
+      currentAction(ActionRegistry::NONE),
       timeInCurrentAction(0),
       catchDistance(30.0f),
       isDancing(false),
       danceTimer(0),
+      breadcrumbs(1, MAX_BREADCRUMBS),
       breadcrumbCounter(0),
       arriveBehavior(150.0f, 120.0f, 15.0f, 80.0f, 0.1f),
       alignBehavior(20.0f, 180.0f, 1.0f, 30.0f, 0.1f)
@@ -62,7 +69,7 @@ Monster::Monster(sf::Vector2f startPosition, sf::Texture &texture, Environment &
 void Monster::setControlType(ControlType type)
 {
     controlType = type;
-    currentAction = "Idle"; // Reset action
+    currentAction = ActionRegistry::IDLE; // Reset action
     reset();                // Reset position and state
 }
 
@@ -71,9 +78,12 @@ void Monster::setPlayerKinematic(const Kinematic &playerKinematic)
     this->playerKinematic = &playerKinematic;
 }
 
-void Monster::setBehaviorTree(std::shared_ptr<BehaviorTree> tree)
+void Monster::setBehaviorTree(std::shared_ptr<const BehaviorTree> tree)
 {
-    behaviorTree = tree;
+    behaviorTree = std::make_shared<BehaviorInstance>(tree, this);
+
+    // Actions only issue commands while the tree ticks; act runs them
+    behaviorTree->setDeferCommands(true);
 }
 
 void Monster::setDecisionTree(std::shared_ptr<DecisionTree> tree)
@@ -105,36 +115,65 @@ void Monster::reset()
     }
 
     // Clear breadcrumbs
-    breadcrumbs.clear();
+    breadcrumbs.clear(0);
     breadcrumbCounter = 0;
 
-    // Update sprite
+    // Update sprite; the reset is a teleport, so don't interpolate across it
+    previousPosition = monsterKinematic.position;
+    previousOrientation = monsterKinematic.orientation;
     updateSprite();
 }
 
 bool Monster::update(float deltaTime)
 {
+    think(deltaTime);
+    return act(deltaTime);
+}
+
+void Monster::think(float deltaTime)
+{
+    // Keep the old state for interpolation
+    previousPosition = monsterKinematic.position;
+    previousOrientation = monsterKinematic.orientation;
+
     // Update time in current action
     timeInCurrentAction += deltaTime;
 
     // Store the current deltaTime for use by behavior tree actions
     setDeltaTime(deltaTime);
 
-    // Check if monster has caught player
-    bool caughtPlayer = hasCaughtPlayer();
-
     // Determine action based on control type
     if (controlType == ControlType::BEHAVIOR_TREE)
     {
         if (behaviorTree)
         {
-            // Tick the behavior tree
-            BehaviorStatus status = behaviorTree->tick();
+            // Tick the behavior tree; its actions are queued until act
+            behaviorTree->tick();
+        }
+    }
+    else if (controlType == ControlType::DECISION_TREE)
+    {
+        if (decisionTree)
+        {
+            // Get decision from decision tree
+            decidedAction = decisionTree->makeDecision();
+        }
+    }
+}
+
+bool Monster::act(float deltaTime)
+{
+    if (controlType == ControlType::BEHAVIOR_TREE)
+    {
+        if (behaviorTree)
+        {
+            // Run the actions the behavior tree chose, in the order it chose them
+            behaviorTree->runCommands();
 
             // If no action was set by the behavior tree, default to idle
-            if (currentAction.empty())
+            if (currentAction == ActionRegistry::NONE)
             {
-                currentAction = "Idle";
+                currentAction = ActionRegistry::IDLE;
                 executeAction(currentAction, deltaTime); // Only execute if setting to idle
             }
         }
@@ -143,9 +182,7 @@ bool Monster::update(float deltaTime)
     {
         if (decisionTree)
         {
-            // Get decision from decision tree
-            std::string action = decisionTree->makeDecision();
-            executeAction(action, deltaTime);
+            executeAction(decidedAction, deltaTime);
         }
     }
 
@@ -159,11 +196,20 @@ bool Monster::update(float deltaTime)
     return hasCaughtPlayer();
 }
 
+void Monster::interpolate(float alpha)
+{
+    sprite.setPosition(FixedTimestep::lerp(previousPosition, monsterKinematic.position, alpha));
+    sprite.setRotation(FixedTimestep::lerpAngle(previousOrientation, monsterKinematic.orientation, alpha));
+}
+
 void Monster::draw(sf::RenderWindow &window)
 {
     // Draw breadcrumbs first
-    for (const auto &crumb : breadcrumbs)
+    for (size_t i = 0; i < breadcrumbs.size(0); i++)
     {
+        sf::CircleShape crumb(2.5f);
+        crumb.setFillColor(breadcrumbColor);
+        crumb.setPosition(breadcrumbs.get(0, i) - sf::Vector2f(2.5f, 2.5f));
         window.draw(crumb);
     }
 
@@ -183,6 +229,14 @@ void Monster::draw(sf::RenderWindow &window)
     window.draw(sprite);
 }
 
+void Monster::draw(SpriteBatch &batch) const
+{
+    breadcrumbs.draw(0, batch, 2.5f, breadcrumbColor);
+
+    batch.addLineStrip(currentPath, sf::Color(breadcrumbColor.r, breadcrumbColor.g, breadcrumbColor.b, 100));
+    batch.addSprite(sprite);
+}
+
 sf::Vector2f Monster::getPosition() const
 {
     return monsterKinematic.position;
@@ -276,10 +330,10 @@ void Monster::recordStateAction(std::ofstream &outputFile)
     outputFile << timeInCurrentAction << ",";
 
     // Current action
-    outputFile << currentAction << std::endl;
+    outputFile << getCurrentActionName() << std::endl;
 }
 
-void Monster::executeAction(const std::string &action, float deltaTime)
+void Monster::executeAction(ActionId action, float deltaTime)
 {
     // Check if this is a new action
     if (action != currentAction)
@@ -288,35 +342,31 @@ void Monster::executeAction(const std::string &action, float deltaTime)
         timeInCurrentAction = 0;
     }
 
-    // Execute the specified action
-    if (action == "PathfindToPlayer")
+    // Execute the specified action; the built-in ids are dense, so this compiles to a jump table
+    switch (action)
     {
+    case ActionRegistry::PATHFIND_TO_PLAYER:
         pathfindToPlayer();
         followPath(deltaTime);
-    }
-    else if (action == "Wander")
-    {
+        break;
+    case ActionRegistry::WANDER:
         wander(deltaTime);
-    }
-    else if (action == "FollowPath")
-    {
+        break;
+    case ActionRegistry::FOLLOW_PATH:
         followPath(deltaTime);
-    }
-    else if (action == "Dance")
-    {
+        break;
+    case ActionRegistry::DANCE:
         doDance(deltaTime);
-    }
-    else if (action == "Flee")
-    {
+        break;
+    case ActionRegistry::FLEE:
         flee(deltaTime);
-    }
-    else if (action == "Idle")
-    {
+        break;
+    case ActionRegistry::IDLE:
         // Do nothing
-    }
-    else
-    {
-        std::cerr << "Unknown action: " << action << std::endl;
+        break;
+    default:
+        std::cerr << "Unknown action: " << ActionRegistry::getName(action) << std::endl;
+        break;
     }
 }
 
@@ -347,15 +397,20 @@ void Monster::pathfindToPlayer()
         return;
     }
 
-    std::cout << "PATHFIND: Found path with " << path.size() << " waypoints" << std::endl;
-
     // Convert path to waypoints
-    currentPath.clear();
+    std::vector<sf::Vector2f> waypoints;
     for (int vertex : path)
     {
-        currentPath.push_back(navigationGraph.getVertexPosition(vertex));
+        waypoints.push_back(navigationGraph.getVertexPosition(vertex));
     }
 
+    // Drop grid waypoints the monster can reach in a straight line
+    const float PATH_CLEARANCE = 10.0f;
+    currentPath = PathSmoothing::smoothFrom(monsterKinematic.position, waypoints, environment, PATH_CLEARANCE);
+
+    std::cout << "PATHFIND: Found path with " << path.size() << " vertices, smoothed to "
+              << currentPath.size() << " waypoints" << std::endl;
+
     // Reset waypoint index
     currentWaypointIndex = 0;
 }
@@ -721,7 +776,14 @@ void Monster::flee(float deltaTime)
 
 bool Monster::checkCollision(sf::Vector2f proposedPosition) const
 {
-    return environment.isObstacle(proposedPosition);
+    if (environment.isObstacle(proposedPosition))
+    {
+        return true;
+    }
+
+    // Keep the monster's body clear of obstacles, but let one that already overlaps a wall move off it
+    return environment.isObstacleWithinRadius(proposedPosition, COLLISION_RADIUS) &&
+           !environment.isObstacleWithinRadius(monsterKinematic.position, COLLISION_RADIUS);
 }
 
 sf::Vector2f Monster::findValidMovement(sf::Vector2f currentPos, sf::Vector2f proposedPos) const
@@ -737,14 +799,14 @@ sf::Vector2f Monster::findValidMovement(sf::Vector2f currentPos, sf::Vector2f pr
 
     // Try moving in just X direction
     sf::Vector2f xOnlyPos(proposedPos.x, currentPos.y);
-    if (!environment.isObstacle(xOnlyPos))
+    if (!checkCollision(xOnlyPos))
     {
         return xOnlyPos;
     }
 
     // Try moving in just Y direction
     sf::Vector2f yOnlyPos(currentPos.x, proposedPos.y);
-    if (!environment.isObstacle(yOnlyPos))
+    if (!checkCollision(yOnlyPos))
     {
         return yOnlyPos;
     }
@@ -753,7 +815,7 @@ sf::Vector2f Monster::findValidMovement(sf::Vector2f currentPos, sf::Vector2f pr
     for (float fraction = 0.75f; fraction >= 0.1f; fraction -= 0.15f)
     {
         sf::Vector2f fractionPos = currentPos + movementVector * fraction;
-        if (!environment.isObstacle(fractionPos))
+        if (!checkCollision(fractionPos))
         {
             return fractionPos;
         }
@@ -775,15 +837,6 @@ void Monster::dropBreadcrumb()
     if (breadcrumbCounter >= BREADCRUMB_INTERVAL)
     {
         breadcrumbCounter = 0;
-        sf::CircleShape crumb(2.5f);
-        crumb.setFillColor(breadcrumbColor);
-        crumb.setPosition(monsterKinematic.position - sf::Vector2f(2.5f, 2.5f));
-        breadcrumbs.push_back(crumb);
-
-        // Limit the number of breadcrumbs
-        if (breadcrumbs.size() > MAX_BREADCRUMBS)
-        {
-            breadcrumbs.pop_front();
-        }
+        breadcrumbs.push(0, monsterKinematic.position); // Replaces the oldest crumb once the trail is full
     }
 }
\ No newline at end of file